@@ -1,12 +1,29 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
 
-uniform mat4 uMVP;
-uniform vec3 uColor;  // ← Keep uColor (matches original)
+// Camera data, uploaded once per frame (binding 0)
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProj;
+    vec4 uTime;   // x = seconds
+};
+
+// Per-object data from the render queue's object ring (binding 1)
+// Array size must match RenderQueue::OBJECTS_PER_BLOCK
+struct ObjectData {
+    mat4 model;
+    vec4 color;
+};
+layout(std140) uniform ObjectBlock {
+    ObjectData uObjects[128];
+};
+
 out vec3 vColor;
 
 void main()
 {
-    gl_Position = uMVP * vec4(aPos, 1.0);
-    vColor = uColor;
-}   
\ No newline at end of file
+    ObjectData obj = uObjects[gl_InstanceID];
+    gl_Position = uViewProj * obj.model * vec4(aPos, 1.0);
+    vColor = obj.color.rgb;
+}
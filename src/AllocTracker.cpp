@@ -0,0 +1,162 @@
+#include "AllocTracker.h"
+
+#ifdef SHOOTER_TRACK_ALLOCS
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // Every block carries a header with its size and tag so delete can credit the right tag
+    // (16 bytes keeps the user pointer aligned like malloc's)
+    struct alignas(16) BlockHeader {
+        size_t size;
+        AllocTag tag;
+    };
+
+    struct TagCounters {
+        std::atomic<uint64_t> allocs{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<int64_t> live{0};      // Bytes currently allocated
+    };
+
+    const int TAG_COUNT = (int)AllocTag::COUNT;
+    const int MAX_DEPTH = 16;
+    const int WARMUP_FRAMES = 300;         // Assert mode arms after this many frames (buffers grow to size first)
+    const char* TAG_NAMES[TAG_COUNT] = { "Other", "World", "Enemy", "Tracer", "HUD", "GUI", "Shooter" };
+
+    TagCounters counters[TAG_COUNT];
+
+    // Per-thread scope state; plain data so it is usable from inside operator new
+    thread_local AllocTag tagStack[MAX_DEPTH];
+    thread_local int tagDepth = 0;
+    thread_local int zeroAllocDepth = 0;
+
+    std::atomic<bool> assertZeroAlloc{false};
+    std::atomic<int> framesSeen{0};
+
+    // Report window (main thread only)
+    uint64_t lastAllocs[TAG_COUNT] = {};
+    uint64_t lastBytes[TAG_COUNT] = {};
+    uint64_t windowAllocs[TAG_COUNT] = {};
+    uint64_t windowBytes[TAG_COUNT] = {};
+    uint64_t peakFrameAllocs[TAG_COUNT] = {};
+    int windowFrames = 0;
+    auto lastReport = std::chrono::steady_clock::now();
+
+    AllocTag currentTag() {
+        if (tagDepth == 0) return AllocTag::OTHER;
+        return tagStack[tagDepth < MAX_DEPTH ? tagDepth - 1 : MAX_DEPTH - 1];
+    }
+
+    void* trackedAlloc(size_t size) {
+        AllocTag tag = currentTag();
+        if (zeroAllocDepth > 0 && assertZeroAlloc.load(std::memory_order_relaxed) &&
+            framesSeen.load(std::memory_order_relaxed) >= WARMUP_FRAMES) {
+            std::fprintf(stderr, "ERROR::ALLOC::IN_ZERO_ALLOC_REGION %zu bytes (tag %s)\n", size, TAG_NAMES[(int)tag]);
+            std::abort();
+        }
+
+        BlockHeader* h = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+        if (!h) return nullptr;
+        h->size = size;
+        h->tag = tag;
+
+        TagCounters& c = counters[(int)tag];
+        c.allocs.fetch_add(1, std::memory_order_relaxed);
+        c.bytes.fetch_add(size, std::memory_order_relaxed);
+        c.live.fetch_add((int64_t)size, std::memory_order_relaxed);
+        return h + 1;
+    }
+
+    void trackedFree(void* p) {
+        if (!p) return;
+        BlockHeader* h = static_cast<BlockHeader*>(p) - 1;
+        counters[(int)h->tag].live.fetch_sub((int64_t)h->size, std::memory_order_relaxed);
+        std::free(h);
+    }
+}
+
+// Close the current frame's counts
+void AllocTracker::endFrame() {
+    framesSeen.fetch_add(1, std::memory_order_relaxed);
+    for (int t = 0; t < TAG_COUNT; ++t) {
+        uint64_t allocs = counters[t].allocs.load(std::memory_order_relaxed);
+        uint64_t bytes = counters[t].bytes.load(std::memory_order_relaxed);
+        uint64_t frameAllocs = allocs - lastAllocs[t];
+        windowAllocs[t] += frameAllocs;
+        windowBytes[t] += bytes - lastBytes[t];
+        if (frameAllocs > peakFrameAllocs[t]) peakFrameAllocs[t] = frameAllocs;
+        lastAllocs[t] = allocs;
+        lastBytes[t] = bytes;
+    }
+    windowFrames++;
+
+    // Debug output every 2 seconds
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - lastReport).count() > 2.0f) {
+        report();
+        lastReport = now;
+    }
+}
+
+// Print per-tag averages since the last report (printf, so reporting does not allocate itself)
+void AllocTracker::report() {
+    if (windowFrames == 0) return;
+    std::printf("[DEBUG] Allocations per frame over %d frames:\n", windowFrames);
+    for (int t = 0; t < TAG_COUNT; ++t) {
+        std::printf("  %-8s %8.2f allocs %10.1f bytes  (peak %llu allocs)  live %lld bytes\n", TAG_NAMES[t],
+                    (double)windowAllocs[t] / windowFrames, (double)windowBytes[t] / windowFrames,
+                    (unsigned long long)peakFrameAllocs[t],
+                    (long long)counters[t].live.load(std::memory_order_relaxed));
+        windowAllocs[t] = 0;
+        windowBytes[t] = 0;
+        peakFrameAllocs[t] = 0;
+    }
+    windowFrames = 0;
+}
+
+// Abort on any allocation inside a ZeroAllocScope
+void AllocTracker::setAssertZeroAlloc(bool enabled) {
+    assertZeroAlloc = enabled;
+}
+
+void AllocTracker::pushTag(AllocTag tag) {
+    if (tagDepth < MAX_DEPTH) tagStack[tagDepth] = tag;
+    tagDepth++;
+}
+
+void AllocTracker::popTag() {
+    if (tagDepth > 0) tagDepth--;
+}
+
+void AllocTracker::enterZeroAlloc() { zeroAllocDepth++; }
+void AllocTracker::leaveZeroAlloc() { zeroAllocDepth--; }
+
+// Global replacements; every plain and nothrow form goes through the tracked pair
+// (aligned new / delete are left to the library, they never mix with these)
+void* operator new(size_t size) {
+    void* p = trackedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = trackedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { trackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+
+#endif
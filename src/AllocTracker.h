@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+
+// Subsystems allocations are charged to (the innermost AllocScope on the calling thread)
+enum class AllocTag : unsigned char {
+    OTHER,      // No scope active
+    WORLD,
+    ENEMY,
+    TRACER,
+    HUD,
+    GUI,
+    SHOOTER,
+    COUNT
+};
+
+// AllocTracker counts heap allocations per subsystem tag. It is opt-in: build with
+// -DSHOOTER_TRACK_ALLOCS to replace the global operator new / delete; without it every
+// call below compiles to nothing.
+// Counts, bytes and live memory per tag are summed per frame and printed every 2 seconds.
+// In assert mode, an allocation inside a ZeroAllocScope aborts the run.
+namespace AllocTracker {
+#ifdef SHOOTER_TRACK_ALLOCS
+    // Close the current frame's counts (call once per frame on the main thread)
+    void endFrame();
+
+    // Print per-tag averages since the last report
+    void report();
+
+    // Abort on any allocation inside a ZeroAllocScope
+    void setAssertZeroAlloc(bool enabled);
+
+    // Calling thread's scope stacks (used by the scope guards)
+    void pushTag(AllocTag tag);
+    void popTag();
+    void enterZeroAlloc();
+    void leaveZeroAlloc();
+
+    const bool ENABLED = true;
+#else
+    inline void endFrame() {}
+    inline void report() {}
+    inline void setAssertZeroAlloc(bool) {}
+    inline void pushTag(AllocTag) {}
+    inline void popTag() {}
+    inline void enterZeroAlloc() {}
+    inline void leaveZeroAlloc() {}
+
+    const bool ENABLED = false;
+#endif
+}
+
+// Charges allocations on this thread to a tag until the end of the scope (scopes nest)
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag tag) { AllocTracker::pushTag(tag); }
+    ~AllocScope() { AllocTracker::popTag(); }
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+};
+
+// Marks code that must not allocate once the game is warmed up (checked in assert mode)
+class ZeroAllocScope {
+public:
+    ZeroAllocScope() { AllocTracker::enterZeroAlloc(); }
+    ~ZeroAllocScope() { AllocTracker::leaveZeroAlloc(); }
+    ZeroAllocScope(const ZeroAllocScope&) = delete;
+    ZeroAllocScope& operator=(const ZeroAllocScope&) = delete;
+};
@@ -0,0 +1,161 @@
+#include "Bot.h"
+#include "../World.h"
+#include "../Net/PlayerMove.h"
+#include <algorithm>
+#include <cmath>
+
+Bot::Bot(unsigned int seed) : rng(seed * 2654435761u + 1) {
+    client.setVerbose(false);
+    prediction.setVerbose(false);
+}
+
+bool Bot::connect(const NetAddress& server, WorldLayout& layout) {
+    if (!client.connect(server, 3.0f, layout)) return false;
+    // Placed by the first snapshot
+    Camera start;
+    start.boundsLimit = layout.boundsLimit();
+    prediction.reset(start);
+    return true;
+}
+
+void Bot::disconnect() {
+    client.disconnect();
+}
+
+// xorshift: every bot has its own sequence, independent of rand()
+float Bot::random() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng & 0xFFFFFF) / 16777216.0f;
+}
+
+void Bot::pickWaypoint(const World& world) {
+    float limit = world.boundsLimit() - 1.0f;
+    waypoint = glm::vec3((random() * 2.0f - 1.0f) * limit, 2.0f, (random() * 2.0f - 1.0f) * limit);
+}
+
+// Ammo comes from the server, like applyServerState does for the game
+void Bot::syncWeapons(const NetPlayerState& s) {
+    weapons.switchWeapon(s.currentWeapon);
+    for (int w = 0; w < 3; ++w) {
+        weapons.weapons[w].currentAmmo = s.ammo[w];
+        weapons.weapons[w].reservedMags = s.mags[w];
+        weapons.weapons[w].partialAmmo = s.partial[w];
+    }
+}
+
+bool Bot::hasAmmo() {
+    for (const AmmoReserve& r : weapons.weapons) {
+        if (r.currentAmmo > 0 || r.reservedMags > 0 || r.partialAmmo > 0) return true;
+    }
+    return false;
+}
+
+Bot::Target Bot::findTarget(const World& world, const glm::vec3& eye, glm::vec3& aimPoint) const {
+    float best = SIGHT_RANGE * SIGHT_RANGE;
+    Target target = Target::NONE;
+    const std::vector<NetEnemy>& enemies = client.getEnemies();
+    for (const NetEnemy& e : enemies) {
+        if (!(e.flags & ENEMY_ALIVE) || (e.flags & ENEMY_DEAD)) continue;
+        glm::vec3 d = e.position - eye;
+        float dist = glm::dot(d, d);
+        if (dist < best) {
+            best = dist;
+            aimPoint = e.position;
+            target = Target::ENEMY;
+        }
+    }
+    if (target != Target::NONE) return target;
+
+    // Dry: shooting an item picks it up and refills the magazines (no ammo needed)
+    uint8_t items = client.getItemsMask();
+    best = 1e9f;
+    for (const Cube& c : world.cubes) {
+        if (!c.isItem || c.id < 1 || c.id > 8 || !(items & (1 << (c.id - 1)))) continue;
+        glm::vec3 d = c.pos - eye;
+        float dist = glm::dot(d, d);
+        if (dist < best) {
+            best = dist;
+            aimPoint = c.pos;
+            target = Target::ITEM;
+        }
+    }
+    return target;
+}
+
+// Walk between random waypoints; with a target in sight turn toward it at TURN_RATE,
+// strafe from side to side and fire when on target. Reload or switch weapons when empty.
+void Bot::step(const World& world) {
+    if (client.poll()) {
+        prediction.reconcile(client.getAckSeq(), client.getSelf(), world);
+        syncWeapons(client.getSelf());
+    }
+    if (!client.isConnected()) return;
+    ticks++;
+
+    const Camera& body = prediction.getCamera();
+    glm::vec3 eye = body.position;
+    if (waypoint == glm::vec3(0.0f) || glm::distance(glm::vec2(eye.x, eye.z), glm::vec2(waypoint.x, waypoint.z)) < 2.0f)
+        pickWaypoint(world);
+
+    glm::vec3 aimPoint = waypoint;
+    Target target = findTarget(world, eye, aimPoint);
+    if (target == Target::ITEM && hasAmmo()) target = Target::NONE;
+    if (target == Target::NONE) aimPoint = glm::vec3(waypoint.x, eye.y, waypoint.z);
+
+    // Turn toward the aim point, limited like a human flick
+    glm::vec3 to = aimPoint - eye;
+    float wantYaw = glm::degrees(std::atan2(to.z, to.x));
+    float wantPitch = glm::degrees(std::atan2(to.y, std::max(glm::length(glm::vec2(to.x, to.z)), 1e-3f)));
+    float dYaw = std::remainder(wantYaw - yaw, 360.0f);
+    float dPitch = wantPitch - pitch;
+    float maxTurn = TURN_RATE * Protocol::TICK_STEP;
+    yaw += std::min(std::max(dYaw, -maxTurn), maxTurn);
+    pitch += std::min(std::max(dPitch, -maxTurn), maxTurn);
+    pitch = std::min(std::max(pitch, -89.0f), 89.0f);
+    bool onTarget = std::abs(dYaw) <= maxTurn + AIM_TOLERANCE && std::abs(dPitch) <= maxTurn + AIM_TOLERANCE;
+
+    PlayerCommand cmd;
+    cmd.yaw = yaw;
+    cmd.pitch = pitch;
+    cmd.viewTick = client.getViewTick();
+    if (target == Target::NONE) {
+        cmd.buttons |= CMD_FORWARD;
+    } else {
+        if (--strafeTicks <= 0) {
+            strafeLeft = !strafeLeft;
+            strafeTicks = 30 + (int)(random() * 60.0f);
+        }
+        cmd.buttons |= strafeLeft ? CMD_LEFT : CMD_RIGHT;
+    }
+    if (random() < 0.005f) cmd.buttons |= CMD_JUMP;
+
+    // Weapons: reload an empty magazine, else move on to a weapon that still has ammo
+    AmmoReserve& reserve = weapons.getCurrentReserve();
+    if (reserve.currentAmmo <= 0) {
+        if (reserve.reservedMags > 0 || reserve.partialAmmo > 0) {
+            cmd.buttons |= CMD_RELOAD;
+        } else {
+            for (int w = 0; w < 3; ++w) {
+                const AmmoReserve& r = weapons.weapons[w];
+                if (r.currentAmmo > 0 || r.reservedMags > 0 || r.partialAmmo > 0) {
+                    cmd.weaponSlot = (int8_t)w;
+                    break;
+                }
+            }
+        }
+    }
+    PlayerMove::applyWeapons(weapons, cmd);
+
+    bool canShoot = target == Target::ITEM || weapons.getCurrentReserve().currentAmmo > 0;
+    if (target != Target::NONE && onTarget && canShoot && ticks - lastShot >= (uint32_t)FIRE_INTERVAL) {
+        cmd.buttons |= CMD_FIRE;
+        if (target == Target::ENEMY) weapons.getCurrentReserve().currentAmmo--;
+        lastShot = ticks;
+        shots++;
+    }
+
+    cmd.seq = client.sendCommand(cmd);
+    prediction.predict(cmd, world);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "../WeaponSystem.h"
+#include "../Net/NetClient.h"
+#include "../Net/ClientPrediction.h"
+
+class World;
+
+// Bot is one scripted player for server load tests: its own NetClient connection driven
+// by a fixed aim / move / fire routine instead of a keyboard and mouse.
+// Movement and weapons run locally through the game's own Camera and WeaponSystem code
+// (ClientPrediction, PlayerMove), so the server receives the same command stream, at the
+// same rate, as it would from a real client.
+class Bot {
+public:
+    static constexpr float TURN_RATE = 360.0f;      // Degrees per second
+    static constexpr float SIGHT_RANGE = 30.0f;     // Enemies farther away are ignored
+    static constexpr float AIM_TOLERANCE = 3.0f;    // Fire once this close to the target (degrees)
+    static const int FIRE_INTERVAL = 4;             // Ticks between shots (900 RPM)
+
+    explicit Bot(unsigned int seed);
+
+    // Blocking handshake; layout receives the server's world
+    bool connect(const NetAddress& server, WorldLayout& layout);
+    void disconnect();
+
+    // One command tick: take any new snapshot, aim, move, fire, send and predict
+    void step(const World& world);
+
+    const NetClient& getClient() const { return client; }
+    int getShots() const { return shots; }
+
+private:
+    enum class Target { NONE, ENEMY, ITEM };
+
+    NetClient client;
+    ClientPrediction prediction;
+    WeaponSystem weapons;
+    unsigned int rng;
+    float yaw = -90.0f;
+    float pitch = 0.0f;
+    glm::vec3 waypoint = glm::vec3(0.0f);
+    int strafeTicks = 0;
+    bool strafeLeft = false;
+    uint32_t ticks = 0;
+    uint32_t lastShot = 0;
+    int shots = 0;
+
+    float random();                 // [0, 1)
+    void pickWaypoint(const World& world);
+    void syncWeapons(const NetPlayerState& s);
+    bool hasAmmo();
+
+    // Nearest enemy in sight range, or the nearest item when every weapon is dry
+    Target findTarget(const World& world, const glm::vec3& eye, glm::vec3& aimPoint) const;
+};
@@ -0,0 +1,261 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Bot.h"
+#include "../World.h"
+#include "../Net/SpectatorClient.h"
+#include "../Server/GameServer.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const int SPECTATOR_BATCH = 100;   // Spectators joined per step
+
+static std::atomic<bool> running{true};
+
+static void onSignal(int) {
+    running = false;
+}
+
+// Traffic of all bots, for the difference over a report window
+struct Totals {
+    long long bytesIn = 0, bytesOut = 0;
+    long long snapshots = 0, snapshotsLost = 0;
+    long long shots = 0;
+};
+
+static Totals sum(const std::vector<std::unique_ptr<Bot>>& bots) {
+    Totals t;
+    for (const auto& b : bots) {
+        const NetClient::Stats& s = b->getClient().getStats();
+        t.bytesIn += s.bytesIn;
+        t.bytesOut += s.bytesOut;
+        t.snapshots += s.snapshots;
+        t.snapshotsLost += s.snapshotsLost;
+        t.shots += b->getShots();
+    }
+    return t;
+}
+
+// Broadcast traffic of all spectators
+static SpectatorClient::Stats sum(const std::vector<std::unique_ptr<SpectatorClient>>& spectators) {
+    SpectatorClient::Stats t;
+    for (const auto& s : spectators) {
+        const SpectatorClient::Stats& st = s->getStats();
+        t.packetsIn += st.packetsIn;
+        t.bytesIn += st.bytesIn;
+        t.frames += st.frames;
+        t.chunks += st.chunks;
+        t.chunksSkipped += st.chunksSkipped;
+    }
+    return t;
+}
+
+static float lossPercent(long long lost, long long received) {
+    return lost + received > 0 ? 100.0f * lost / (lost + received) : 0.0f;
+}
+
+// Load test: N bots in this process, one UDP connection each, stepped at the command rate.
+// Without --connect the server is hosted in-process on loopback, so its tick time is reported too.
+// --spectators adds clients watching through a relay (a separate process, see SpectatorRelay).
+int main(int argc, char** argv) {
+    int botCount = 32;
+    float ramp = 0.0f;           // Bots added per second (0 = as fast as they connect)
+    float seconds = 20.0f;       // Run time once every bot is in
+    std::string connectTo;
+    int spectatorCount = 0;
+    std::string relayTo = "127.0.0.1";
+    bool decode = false;         // Spectators decode the broadcast (slower; checks the delta chain)
+    ServerConfig config;
+    config.port = 0;             // Hosted server: any free port unless --port
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bots" && i + 1 < argc) botCount = std::stoi(argv[++i]);
+        else if (arg == "--ramp" && i + 1 < argc) ramp = std::stof(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc) seconds = std::stof(argv[++i]);
+        else if (arg == "--connect" && i + 1 < argc) connectTo = argv[++i];
+        else if (arg == "--enemies" && i + 1 < argc) config.enemyCount = std::stoi(argv[++i]);
+        else if (arg == "--world-size" && i + 1 < argc) config.worldSize = std::stof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) config.seed = (unsigned int)std::stoul(argv[++i]);
+        else if (arg == "--port" && i + 1 < argc) config.port = (uint16_t)std::stoi(argv[++i]);
+        else if (arg == "--spectators" && i + 1 < argc) spectatorCount = std::stoi(argv[++i]);
+        else if (arg == "--relay" && i + 1 < argc) relayTo = argv[++i];
+        else if (arg == "--decode") decode = true;
+        else std::cerr << "Unknown option " << arg
+                       << " (--bots, --ramp, --seconds, --connect, --enemies, --world-size, --seed, --port,"
+                          " --spectators, --relay, --decode)\n";
+    }
+    spectatorCount = std::max(spectatorCount, 0);
+    botCount = std::max(spectatorCount > 0 ? 0 : 1, std::min(botCount, Protocol::MAX_PLAYERS));
+
+    if (!Net::startup()) return -1;
+
+    // Host the server here unless told where it is
+    std::unique_ptr<GameServer> host;
+    std::thread hostThread;
+    NetAddress address;
+    if (connectTo.empty()) {
+        config.maxPlayers = std::max(botCount, 1);
+        config.verbose = false;
+        host.reset(new GameServer());
+        if (!host->start(config)) {
+            Net::cleanup();
+            return -1;
+        }
+        hostThread = std::thread([&host] { host->run(); });
+        address.parse("127.0.0.1", host->getPort());
+    } else if (!address.parse(connectTo, Protocol::DEFAULT_PORT)) {
+        std::cerr << "ERROR::BOTS::BAD_ADDRESS " << connectTo << "\n";
+        Net::cleanup();
+        return -1;
+    }
+    NetAddress relayAddress;
+    if (spectatorCount > 0 && !relayAddress.parse(relayTo, Protocol::DEFAULT_RELAY_PORT)) {
+        std::cerr << "ERROR::BOTS::BAD_ADDRESS " << relayTo << "\n";
+        Net::cleanup();
+        return -1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    World world;
+    bool worldBuilt = false;
+    std::vector<std::unique_ptr<Bot>> bots;
+    bots.reserve(botCount);
+    std::vector<std::unique_ptr<SpectatorClient>> spectators;
+    spectators.reserve(spectatorCount);
+    bool full = false;
+
+    auto start = Clock::now();
+    auto next = start;
+    auto lastReport = start;
+    Clock::time_point fullSince;
+    Totals previous;
+    SpectatorClient::Stats previousWatch;
+    double stepMs = 0, maxStepMs = 0;
+    int steps = 0;
+    std::cout << "Running " << botCount << " bots against " << address.toString() << (host ? " (hosted)" : "");
+    if (spectatorCount > 0) std::cout << ", " << spectatorCount << " spectators on relay " << relayAddress.toString();
+    std::cout << "\n";
+
+    while (running) {
+        // Join one bot per step (a handshake takes about a server tick), at most at the ramp rate
+        float elapsed = std::chrono::duration<float>(Clock::now() - start).count();
+        int wanted = ramp > 0.0f ? std::min(botCount, 1 + (int)(elapsed * ramp)) : botCount;
+        if ((int)bots.size() < wanted) {
+            std::unique_ptr<Bot> bot(new Bot(config.seed + (unsigned int)bots.size()));
+            WorldLayout layout;
+            if (!bot->connect(address, layout)) {
+                std::cerr << "ERROR::BOTS::CONNECT_FAILED after " << bots.size() << " bots\n";
+                break;
+            }
+            if (!worldBuilt) {
+                // Every bot plays in the same world; it is only read (collision, items)
+                world.layout = layout;
+                world.viewDistance = -chunkCoord(-layout.halfSize - 0.5f);
+                world.streaming = false;   // Built inline, no chunk worker threads
+                world.generate();
+                worldBuilt = true;
+            }
+            bots.push_back(std::move(bot));
+        } else if ((int)spectators.size() < spectatorCount) {
+            // Then the spectators, a batch per step (the relay answers at once)
+            bool failed = false;
+            for (int i = 0; i < SPECTATOR_BATCH && (int)spectators.size() < spectatorCount; ++i) {
+                std::unique_ptr<SpectatorClient> s(new SpectatorClient());
+                s->setDecoding(decode);
+                s->setVerbose(false);
+                WorldLayout layout;
+                if (!s->connect(relayAddress, 2.0f, layout)) {
+                    failed = true;
+                    break;
+                }
+                spectators.push_back(std::move(s));
+            }
+            if (failed) {
+                std::cerr << "ERROR::BOTS::SPECTATE_FAILED after " << spectators.size() << " spectators\n";
+                break;
+            }
+        }
+        if (!full && (int)bots.size() == botCount && (int)spectators.size() == spectatorCount) {
+            full = true;
+            fullSince = Clock::now();
+        }
+        if (full && std::chrono::duration<float>(Clock::now() - fullSince).count() > seconds) break;
+
+        auto t = Clock::now();
+        for (auto& b : bots) b->step(world);
+        for (auto& s : spectators) s->poll();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+        stepMs += ms;
+        maxStepMs = std::max(maxStepMs, ms);
+        steps++;
+
+        // Report every 2 seconds
+        auto now = Clock::now();
+        float window = std::chrono::duration<float>(now - lastReport).count();
+        if (window > 2.0f) {
+            Totals current = sum(bots);
+            int n = std::max((int)bots.size(), 1);
+            std::cout << "[DEBUG] Bots: " << bots.size() << " running, step " << stepMs / std::max(steps, 1) << " ms (max "
+                      << maxStepMs << ") | per bot up " << (current.bytesOut - previous.bytesOut) / window / 1024.0f / n
+                      << " KB/s, down " << (current.bytesIn - previous.bytesIn) / window / 1024.0f / n << " KB/s, snapshot loss "
+                      << lossPercent(current.snapshotsLost - previous.snapshotsLost, current.snapshots - previous.snapshots)
+                      << "%, " << (current.shots - previous.shots) / window << " shots/s";
+            if (host) {
+                GameServer::Load load = host->getLoad();
+                std::cout << " | server tick avg " << load.avgTickMs << " ms, max " << load.maxTickMs << " ms, over budget "
+                          << load.overruns << "/" << load.ticks << ", in " << load.kbInPerSec << " KB/s, out "
+                          << load.kbOutPerSec << " KB/s, " << load.commandsLost << " commands lost";
+            }
+            std::cout << "\n";
+            if (!spectators.empty()) {
+                SpectatorClient::Stats watch = sum(spectators);
+                int s = (int)spectators.size();
+                std::cout << "[DEBUG] Spectators: " << s << " watching, per spectator "
+                          << (watch.bytesIn - previousWatch.bytesIn) / window / 1024.0f / s << " KB/s, "
+                          << (watch.frames - previousWatch.frames) / window / s << " frames/s";
+                if (decode) std::cout << ", " << watch.chunksSkipped - previousWatch.chunksSkipped << " of "
+                                      << watch.chunks - previousWatch.chunks << " enemy chunks skipped";
+                std::cout << "\n";
+                previousWatch = watch;
+            }
+            previous = current;
+            stepMs = maxStepMs = 0;
+            steps = 0;
+            lastReport = now;
+        }
+
+        // Fixed command rate; after a stall (a slow handshake) carry on from now
+        next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(Protocol::TICK_STEP));
+        if (Clock::now() - next > std::chrono::milliseconds(250)) next = Clock::now();
+        std::this_thread::sleep_until(next);
+    }
+
+    Totals total = sum(bots);
+    float runSeconds = std::chrono::duration<float>(Clock::now() - start).count();
+    std::cout << "=== BOTS: " << bots.size() << " bots, " << runSeconds << " s ===\n"
+              << "Snapshots " << total.snapshots << ", lost " << lossPercent(total.snapshotsLost, total.snapshots)
+              << "%, shots " << total.shots << "\n";
+    if (!spectators.empty()) {
+        SpectatorClient::Stats watch = sum(spectators);
+        std::cout << "Spectators " << spectators.size() << ": " << watch.frames << " frames, "
+                  << watch.bytesIn / (1024 * 1024) << " MB";
+        if (decode) std::cout << ", " << watch.chunksSkipped << " of " << watch.chunks << " enemy chunks skipped";
+        std::cout << "\n";
+    }
+
+    for (auto& b : bots) b->disconnect();
+    for (auto& s : spectators) s->disconnect();
+    if (host) {
+        host->stop();
+        hostThread.join();
+    }
+    Net::cleanup();
+    return 0;
+}
@@ -1,11 +1,13 @@
 #include "Camera.h"
 #include <glm/gtc/constants.hpp>
 #include <iostream>
+#include <cmath>
 
 //Haider Commit
 // Constructor: initialize camera with position and default orientation
 Camera::Camera(glm::vec3 pos) : position(pos), worldUp(0, 1, 0), yaw(-90.0f), pitch(0.0f),
-                                speed(8.0f), sensitivity(0.1f) {
+                                speed(8.0f), sensitivity(0.1f), velocityY(0.0f), isOnGround(false),
+                                boundsLimit(19.0f) {
     front = glm::vec3(0.0f, 0.0f, -1.0f);
     updateVectors();
 }
@@ -35,11 +37,11 @@ glm::mat4 Camera::getViewMatrix() const {
 
 // Recalculate camera direction vectors based on yaw and pitch angles
 void Camera::updateVectors() {
-    // Calculate front vector from yaw and pitch angles
+    // Calculate front vector from yaw and pitch angles (float overloads, as in frontAfter)
     front = glm::normalize(glm::vec3(
-        cos(glm::radians(yaw)) * cos(glm::radians(pitch)),
-        sin(glm::radians(pitch)),
-        sin(glm::radians(yaw)) * cos(glm::radians(pitch))
+        std::cos(glm::radians(yaw)) * std::cos(glm::radians(pitch)),
+        std::sin(glm::radians(pitch)),
+        std::sin(glm::radians(yaw)) * std::cos(glm::radians(pitch))
     ));
     
     // Calculate right vector perpendicular to front
@@ -51,8 +53,8 @@ void Camera::updateVectors() {
 
 // Handle keyboard input for movement
 void Camera::processKeyboard(int direction, float deltaTime) {
-    // Calculate movement speed for this frame
-    float velocity = speed * deltaTime * 1.5;
+    // Calculate movement speed for this frame (float only, so every build rounds the same way)
+    float velocity = speed * deltaTime * 1.5f;
     
     // Store current Y position to prevent physics interference
     float currentY = position.y;
@@ -67,7 +69,7 @@ void Camera::processKeyboard(int direction, float deltaTime) {
     position.y = currentY;
     
     // Apply world boundary constraints to keep player in world
-    float limit = 19.0f;
+    float limit = boundsLimit;
     if (position.x < -limit) position.x = -limit;
     if (position.x > limit) position.x = limit;
     if (position.z < -limit) position.z = -limit;
@@ -97,3 +99,31 @@ void Camera::processMouse(float xoffset, float yoffset) {
     updateVectors();
 
 }
+
+// Turn to face a point, keeping the same pitch limits as mouse look
+void Camera::lookAt(const glm::vec3& target) {
+    glm::vec3 dir = target - position;
+    if (glm::length(dir) < 1e-4f) return;
+    dir = glm::normalize(dir);
+    yaw = glm::degrees(std::atan2(dir.z, dir.x));
+    pitch = glm::clamp(glm::degrees(std::asin(dir.y)), -89.0f, 89.0f);
+    updateVectors();
+}
+
+// Set the view angles directly, with the same pitch limits as mouse look
+void Camera::setAngles(float newYaw, float newPitch) {
+    yaw = newYaw;
+    pitch = glm::clamp(newPitch, -89.0f, 89.0f);
+    updateVectors();
+}
+
+// Direction the camera would face after processMouse(xoffset, yoffset), without changing it
+glm::vec3 Camera::frontAfter(float xoffset, float yoffset) const {
+    float y = yaw + xoffset * sensitivity;
+    float p = glm::clamp(pitch + yoffset * sensitivity, -89.0f, 89.0f);
+    return glm::normalize(glm::vec3(
+        std::cos(glm::radians(y)) * std::cos(glm::radians(p)),
+        std::sin(glm::radians(p)),
+        std::sin(glm::radians(y)) * std::cos(glm::radians(p))
+    ));
+}
@@ -6,6 +6,8 @@
 
 // Camera class handles first-person view and physics
 // Manages position, orientation, and movement
+// Movement and physics depend only on the current state and deltaTime (no clocks, no
+// randomness), so a run of fixed steps replays bit for bit; client prediction relies on it
 class Camera {
 public:
     glm::vec3 position;      // Camera position in world space
@@ -20,6 +22,7 @@ public:
     float sensitivity;       // Mouse sensitivity for rotation
     float velocityY;         // Vertical velocity for jumping/gravity
     bool isOnGround;         // Whether camera is on ground for jumping
+    float boundsLimit;       // Max distance from origin on X and Z
     
     const float GRAVITY = -15.0f;     // Gravity acceleration
     const float JUMP_FORCE = 7.0f;  // Initial jump velocity
@@ -37,6 +40,15 @@ public:
     // Handle mouse look rotation
     void processMouse(float xoffset, float yoffset);
     
+    // Front vector after a mouse offset, without applying it (used to aim buffered clicks)
+    glm::vec3 frontAfter(float xoffset, float yoffset) const;
+    
+    // Turn to face a point (scripted cameras)
+    void lookAt(const glm::vec3& target);
+    
+    // Set the view angles directly (network commands carry them)
+    void setAngles(float newYaw, float newPitch);
+    
     // Apply gravity and collision physics
     void physics(float deltaTime);
     
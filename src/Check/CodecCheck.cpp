@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Enemy.h"
+#include "../Net/SnapshotCodec.h"
+
+// Headless round-trip checks of the snapshot codec: enemy deltas, views with and without a
+// baseline, bad views and the quantization limits. Exits with 1 if any check fails.
+
+static int checks = 0;
+static int failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    checks++;
+    if (ok) return;
+    failures++;
+    if (failures <= 20) std::cerr << "FAIL: " << what << "\n";
+}
+
+static bool same(const QuantizedEnemy& a, const QuantizedEnemy& b) {
+    for (int i = 0; i < 3; ++i) {
+        if (a.pos[i] != b.pos[i] || a.color[i] != b.color[i]) return false;
+    }
+    return a.health == b.health && a.flags == b.flags;
+}
+
+static QuantizedEnemy randomEnemy(std::mt19937& rng) {
+    QuantizedEnemy q;
+    for (int a = 0; a < 3; ++a) {
+        q.pos[a] = (uint16_t)(rng() & 0xFFFF);
+        q.color[a] = (uint8_t)(rng() & 0xFF);
+    }
+    q.health = (uint8_t)(rng() % 128);
+    q.flags = (uint8_t)(rng() % 8);
+    return q;
+}
+
+// The next state of an enemy: small and large moves (either side of the delta range), health,
+// flags and color changes, or nothing at all
+static QuantizedEnemy randomChange(std::mt19937& rng, const QuantizedEnemy& base) {
+    static const int edges[] = { 0, 1, -1, 511, -512, 512, -513, 40000, -40000 };
+    QuantizedEnemy q = base;
+    int kind = (int)(rng() % 6);
+    if (kind == 0) return q;
+    if (kind == 1 || kind == 5) {
+        for (int a = 0; a < 3; ++a) {
+            int d = (rng() & 1) ? edges[rng() % 9] : (int)(rng() % 1024) - 512;
+            q.pos[a] = (uint16_t)std::min(std::max((int)base.pos[a] + d, 0), 65535);
+        }
+    }
+    if (kind == 2 || kind == 5) {
+        q.health = (uint8_t)(rng() % 128);
+        q.flags = (uint8_t)(rng() % 8);
+    }
+    if (kind == 3 || kind == 5) {
+        for (int c = 0; c < 3; ++c) q.color[c] = (uint8_t)(rng() & 0xFF);
+    }
+    if (kind == 4) q.pos[rng() % 3] = (uint16_t)(rng() & 0xFFFF);
+    return q;
+}
+
+// Writes a view in GameServer::writeView's layout: kept[i] is the new state of base[i], or
+// nullptr when it leaves the view; joined enemies follow in full
+static void writeView(BitWriter& w, const std::vector<ViewEnemy>& base, const std::vector<const QuantizedEnemy*>& kept,
+                      const std::vector<ViewEnemy>& joined, int total) {
+    static const QuantizedEnemy zero;
+    for (size_t i = 0; i < base.size(); ++i) {
+        w.writeBool(kept[i] != nullptr);
+        if (kept[i]) SnapshotCodec::writeEnemy(w, base[i].q, *kept[i]);
+    }
+    w.write((uint32_t)joined.size(), SnapshotCodec::VIEW_JOIN_BITS);
+    for (const ViewEnemy& v : joined) {
+        w.write(v.index, SnapshotCodec::indexBits(total));
+        SnapshotCodec::writeEnemy(w, zero, v.q);
+    }
+}
+
+static bool sameView(const std::vector<ViewEnemy>& a, const std::vector<ViewEnemy>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].index != b[i].index || !same(a[i].q, b[i].q)) return false;
+    }
+    return true;
+}
+
+static void checkQuantization() {
+    const float limits[] = { 0.5f, 20.0f, 200.0f };
+    for (float limit : limits) {
+        std::string at = " (limit " + std::to_string(limit) + ")";
+        check(SnapshotCodec::quantize(-limit, limit) == 0, "quantize(-limit) is 0" + at);
+        check(SnapshotCodec::quantize(limit, limit) == 65535, "quantize(limit) is 65535" + at);
+        check(SnapshotCodec::quantize(-limit * 3.0f, limit) == 0, "quantize clamps below" + at);
+        check(SnapshotCodec::quantize(limit * 3.0f, limit) == 65535, "quantize clamps above" + at);
+        check(SnapshotCodec::dequantize(0, limit) == -limit, "dequantize(0) is -limit" + at);
+        check(std::fabs(SnapshotCodec::dequantize(65535, limit) - limit) <= limit * 1e-6f, "dequantize(65535) is limit" + at);
+
+        // Half a quantum of error, plus float rounding
+        float step = 2.0f * limit / 65535.0f;
+        float worst = 0.0f;
+        for (int i = 0; i <= 1000; ++i) {
+            float v = -limit + 2.0f * limit * i / 1000.0f;
+            worst = std::max(worst, std::fabs(SnapshotCodec::dequantize(SnapshotCodec::quantize(v, limit), limit) - v));
+        }
+        check(worst <= step * 0.5f + limit * 1e-6f, "position round trip within half a quantum" + at);
+    }
+
+    Enemy e(glm::vec3(-100.0f, 0.0f, 100.0f), glm::vec3(-1.0f, 0.5f, 2.0f));
+    e.health = 500.0f;
+    e.chasing = true;
+    QuantizedEnemy q = SnapshotCodec::quantizeEnemy(e, 20.0f);
+    check(q.pos[0] == 0 && q.pos[2] == 65535, "enemy position clamps to the arena");
+    check(q.color[0] == 0 && q.color[1] == 128 && q.color[2] == 255, "enemy color clamps to 0..255");
+    check(q.health == 127, "enemy health clamps to 127");
+    check(q.flags == (ENEMY_ALIVE | ENEMY_CHASING), "enemy flags alive and chasing");
+    e.health = -20.0f;
+    e.alive = false;
+    e.chasing = false;
+    e.color = glm::vec3(0.0f);
+    q = SnapshotCodec::quantizeEnemy(e, 20.0f);
+    check(q.health == 0 && q.flags == ENEMY_DEAD, "dead enemy has no health and only the dead flag");
+
+    NetRemotePlayer p;
+    p.id = 5;
+    p.position = glm::vec3(3.0f, 1.5f, -7.25f);
+    p.yaw = -90.0f;
+    p.pitch = 90.0f;
+    p.health = 200;
+    uint8_t buffer[64];
+    BitWriter w(buffer, sizeof(buffer));
+    SnapshotCodec::writeRemotePlayer(w, p, 20.0f);
+    check(w.getBitCount() == SnapshotCodec::REMOTE_PLAYER_BITS, "remote player is REMOTE_PLAYER_BITS");
+    BitReader r(buffer, w.getByteCount());
+    NetRemotePlayer back = SnapshotCodec::readRemotePlayer(r, 20.0f);
+    check(back.id == 5 && glm::length(back.position - p.position) < 1e-3f, "remote player id and position");
+    check(std::fabs(back.yaw - 270.0f) < 0.01f && std::fabs(back.pitch - 90.0f) < 0.01f, "remote player yaw wraps, pitch keeps its limit");
+    check(back.health == 127, "remote player health clamps to 127");
+}
+
+static void checkEnemyDeltas(std::mt19937& rng) {
+    uint8_t buffer[64];
+    for (int i = 0; i < 20000; ++i) {
+        QuantizedEnemy base = (i % 4 == 0) ? QuantizedEnemy() : randomEnemy(rng);
+        QuantizedEnemy cur = randomChange(rng, base);
+        BitWriter w(buffer, sizeof(buffer));
+        SnapshotCodec::writeEnemy(w, base, cur);
+        int expected = SnapshotCodec::enemyBits(base, cur);
+        BitReader r(buffer, w.getByteCount());
+        QuantizedEnemy back = SnapshotCodec::readEnemy(r, base);
+        check(w.getBitCount() == expected, "enemyBits matches writeEnemy");
+        check(expected <= SnapshotCodec::MAX_ENEMY_BITS, "enemy fits in MAX_ENEMY_BITS");
+        check(same(back, cur) && !r.isBad(), "enemy delta round trip");
+        if (same(base, cur)) check(expected == 1, "unchanged enemy is one bit");
+    }
+}
+
+static void checkViews(std::mt19937& rng) {
+    static const int totals[] = { 1, 2, 255, 256, 5000, 65536 };
+    std::vector<uint8_t> buffer(8192);
+    std::vector<ViewEnemy> base, joined, expected, out;
+    std::vector<QuantizedEnemy> next;
+    std::vector<const QuantizedEnemy*> kept;
+    for (int round = 0; round < 3000; ++round) {
+        int total = totals[round % 6];
+        int baseCount = (round % 3 == 0) ? 0 : (int)(rng() % std::min(total, 200));
+        base.clear();
+        for (int i = 0; i < baseCount; ++i) base.push_back({ (uint16_t)(rng() % total), randomEnemy(rng) });
+
+        next.resize(baseCount);
+        kept.assign(baseCount, nullptr);
+        expected.clear();
+        for (int i = 0; i < baseCount; ++i) {
+            if (rng() % 4 == 0) continue;
+            next[i] = randomChange(rng, base[i].q);
+            kept[i] = &next[i];
+            expected.push_back({ base[i].index, next[i] });
+        }
+        joined.clear();
+        int joins = (int)(rng() % std::min(SnapshotCodec::MAX_VIEW_ENEMIES - (int)expected.size() + 1, 56));
+        if (round % 50 == 1) joins = SnapshotCodec::MAX_VIEW_ENEMIES - (int)expected.size();
+        for (int i = 0; i < joins; ++i) {
+            ViewEnemy v = { (uint16_t)(i == 0 ? total - 1 : rng() % total), randomEnemy(rng) };
+            joined.push_back(v);
+            expected.push_back(v);
+        }
+
+        BitWriter w(buffer.data(), (int)buffer.size());
+        writeView(w, base, kept, joined, total);
+        BitReader r(buffer.data(), w.getByteCount());
+        bool ok = SnapshotCodec::readView(r, base.data(), baseCount, total, out);
+        std::string at = " (total " + std::to_string(total) + ", base " + std::to_string(baseCount) + ")";
+        check(!w.hasOverflowed(), "view fits the check buffer" + at);
+        check(ok && sameView(out, expected), (baseCount ? "delta view round trip" : "full view round trip") + at);
+
+        // Cut short, the same view must be rejected rather than read as zeros
+        if (w.getByteCount() > 1) {
+            BitReader cut(buffer.data(), w.getByteCount() / 2);
+            check(!SnapshotCodec::readView(cut, base.data(), baseCount, total, out), "truncated view is rejected" + at);
+        }
+    }
+}
+
+static void checkBadViews(std::mt19937& rng) {
+    uint8_t buffer[8192];
+    std::vector<ViewEnemy> out;
+    std::vector<ViewEnemy> none;
+    std::vector<const QuantizedEnemy*> noKept;
+
+    // An index past the last enemy, still within the bits of the count
+    const int totals[] = { 3, 5, 100, 1000 };
+    for (int total : totals) {
+        std::vector<ViewEnemy> joined = { { 0, randomEnemy(rng) }, { (uint16_t)total, randomEnemy(rng) } };
+        BitWriter w(buffer, sizeof(buffer));
+        writeView(w, none, noKept, joined, total);
+        BitReader r(buffer, w.getByteCount());
+        check(!SnapshotCodec::readView(r, nullptr, 0, total, out), "out-of-range index is rejected (total " + std::to_string(total) + ")");
+    }
+
+    // More enemies than a view may hold: a full baseline that stays, plus joins
+    std::vector<ViewEnemy> base;
+    std::vector<const QuantizedEnemy*> kept;
+    for (int i = 0; i < SnapshotCodec::MAX_VIEW_ENEMIES; ++i) base.push_back({ (uint16_t)i, randomEnemy(rng) });
+    for (const ViewEnemy& v : base) kept.push_back(&v.q);
+    std::vector<ViewEnemy> joined = { { 300, randomEnemy(rng) } };
+    BitWriter w(buffer, sizeof(buffer));
+    writeView(w, base, kept, joined, 1000);
+    BitReader r(buffer, w.getByteCount());
+    check(!SnapshotCodec::readView(r, base.data(), (int)base.size(), 1000, out), "view over MAX_VIEW_ENEMIES is rejected");
+
+    check(SnapshotCodec::indexBits(1) == 1 && SnapshotCodec::indexBits(2) == 1 && SnapshotCodec::indexBits(3) == 2,
+          "indexBits of small counts");
+    check(SnapshotCodec::indexBits(256) == 8 && SnapshotCodec::indexBits(257) == 9 && SnapshotCodec::indexBits(65536) == 16,
+          "indexBits of large counts");
+}
+
+int main(int argc, char** argv) {
+    unsigned int seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = (unsigned int)std::stoul(argv[++i]);
+        else std::cerr << "Unknown option " << arg << " (--seed)\n";
+    }
+    std::mt19937 rng(seed);
+
+    checkQuantization();
+    checkEnemyDeltas(rng);
+    checkViews(rng);
+    checkBadViews(rng);
+
+    std::cout << "=== CODEC CHECK: " << checks << " checks, " << failures << " failed (seed " << seed << ") ===\n";
+    return failures == 0 ? 0 : 1;
+}
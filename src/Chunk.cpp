@@ -0,0 +1,199 @@
+#include "Chunk.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+
+// Small xorshift generator so chunk contents depend only on (seed, cx, cz)
+static unsigned int nextRandom(unsigned int& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Random float in [0, 1)
+static float randomUnit(unsigned int& state) {
+    return (nextRandom(state) & 0xFFFFFF) / float(0x1000000);
+}
+
+// Add a cube together with its render and collision data
+static void addCube(Chunk& chunk, const Cube& c) {
+    chunk.cubes.push_back(c);
+
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), c.pos);
+    model = glm::scale(model, c.size);
+    chunk.models.push_back(model);
+
+    AABB box = {c.pos - c.size * 0.5f, c.pos + c.size * 0.5f};
+    chunk.colliders.push_back(box);
+
+    if (chunk.cubes.size() == 1) {
+        chunk.bounds = box;
+    } else {
+        chunk.bounds.min = glm::min(chunk.bounds.min, box.min);
+        chunk.bounds.max = glm::max(chunk.bounds.max, box.max);
+    }
+}
+
+// Generate the static geometry for chunk (cx, cz)
+// The union of all chunks reproduces the floor, ceiling and boundary walls of the arena
+void generateChunk(const WorldLayout& layout, int cx, int cz, Chunk& out) {
+    out.cx = cx;
+    out.cz = cz;
+    out.cubes.clear();
+    out.models.clear();
+    out.colliders.clear();
+    out.bounds = {glm::vec3(0.0f), glm::vec3(0.0f)};
+
+    float W = layout.halfSize;
+    float H = layout.height;
+
+    // Chunk extent and its overlap with the playable area
+    float x0 = cx * CHUNK_SIZE, x1 = x0 + CHUNK_SIZE;
+    float z0 = cz * CHUNK_SIZE, z1 = z0 + CHUNK_SIZE;
+    float minX = std::max(x0, -W), maxX = std::min(x1, W);
+    float minZ = std::max(z0, -W), maxZ = std::min(z1, W);
+    bool hasX = minX < maxX;
+    bool hasZ = minZ < maxZ;
+
+    // Floor and ceiling tiles covering this chunk
+    if (hasX && hasZ) {
+        glm::vec3 center((minX + maxX) * 0.5f, 0.0f, (minZ + maxZ) * 0.5f);
+        glm::vec3 tile(maxX - minX, 1.0f, maxZ - minZ);
+        addCube(out, {center, tile, glm::vec3(0.7f, 0.7f, 0.9f), false, 0});
+        addCube(out, {glm::vec3(center.x, H, center.z), tile, glm::vec3(0.6f, 0.9f, 1.0f), false, 0});
+    }
+
+    // Boundary wall segments owned by the chunk that contains the boundary line
+    if (hasZ) {
+        float len = maxZ - minZ, midZ = (minZ + maxZ) * 0.5f;
+        if (x0 <= -W && -W < x1)
+            addCube(out, {glm::vec3(-W, H / 2, midZ), glm::vec3(1, H, len), glm::vec3(0.8f), false, 0});
+        if (x0 <= W && W < x1)
+            addCube(out, {glm::vec3(W, H / 2, midZ), glm::vec3(1, H, len), glm::vec3(0.8f), false, 0});
+    }
+    if (hasX) {
+        float len = maxX - minX, midX = (minX + maxX) * 0.5f;
+        if (z0 <= -W && -W < z1)
+            addCube(out, {glm::vec3(midX, H / 2, -W), glm::vec3(len, H, 1), glm::vec3(0.6f, 0.6f, 1.0f), false, 0});
+        if (z0 <= W && W < z1)
+            addCube(out, {glm::vec3(midX, H / 2, W), glm::vec3(len, H, 1), glm::vec3(0.6f, 0.6f, 1.0f), false, 0});
+    }
+
+    // Procedural pillars for large worlds, kept away from the spawn area
+    if (hasX && hasZ && layout.pillarDensity > 0.0f) {
+        unsigned int state = layout.seed ^ (unsigned int)(cx * 73856093) ^ (unsigned int)(cz * 19349663);
+        if (state == 0) state = 1;
+
+        int count = (int)layout.pillarDensity;
+        if (randomUnit(state) < layout.pillarDensity - count) count++;
+
+        for (int i = 0; i < count; ++i) {
+            float px = minX + 2.0f + randomUnit(state) * std::max(0.0f, maxX - minX - 4.0f);
+            float pz = minZ + 2.0f + randomUnit(state) * std::max(0.0f, maxZ - minZ - 4.0f);
+            float width = 1.5f + randomUnit(state) * 2.5f;
+            if (px * px + pz * pz < 36.0f) continue;
+            addCube(out, {glm::vec3(px, H / 2, pz), glm::vec3(width, H, width),
+                          glm::vec3(0.55f, 0.5f, 0.45f), false, 0});
+        }
+    }
+}
+
+// Constructor: streamer starts idle until start() is called
+ChunkStreamer::ChunkStreamer() : generation(0), inFlight(0), running(false) {}
+
+// Destructor: make sure worker threads are joined
+ChunkStreamer::~ChunkStreamer() {
+    stop();
+}
+
+// Spawn worker threads that generate chunks for the given layout
+void ChunkStreamer::start(const WorldLayout& newLayout, int workerCount) {
+    stop();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        layout = newLayout;
+        running = true;
+        generation++;
+        queue.clear();
+        finished.clear();
+    }
+
+    if (workerCount < 1) workerCount = 1;
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ChunkStreamer::workerLoop, this);
+    }
+}
+
+// Signal workers to exit and wait for them
+void ChunkStreamer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+
+    for (auto& t : workers) {
+        if (t.joinable()) t.join();
+    }
+    workers.clear();
+}
+
+// Queue a chunk for generation
+void ChunkStreamer::request(int cx, int cz) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({cx, cz});
+    }
+    wake.notify_one();
+}
+
+// Forget queued work; chunks finishing later are discarded by the generation check
+void ChunkStreamer::cancelAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    queue.clear();
+    finished.clear();
+}
+
+// Hand finished chunks to the caller
+int ChunkStreamer::collect(std::vector<std::unique_ptr<Chunk>>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    int count = (int)finished.size();
+    for (auto& c : finished) {
+        out.push_back(std::move(c));
+    }
+    finished.clear();
+    return count;
+}
+
+// Number of chunks not yet collected
+int ChunkStreamer::pendingCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int)queue.size() + inFlight + (int)finished.size();
+}
+
+// Worker thread: generate chunks outside the lock
+void ChunkStreamer::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return !running || !queue.empty(); });
+        if (!running) return;
+
+        std::pair<int, int> coord = queue.front();
+        queue.pop_front();
+        unsigned int jobGeneration = generation;
+        WorldLayout jobLayout = layout;
+        inFlight++;
+        lock.unlock();
+
+        std::unique_ptr<Chunk> chunk(new Chunk());
+        generateChunk(jobLayout, coord.first, coord.second, *chunk);
+
+        lock.lock();
+        inFlight--;
+        if (jobGeneration == generation) {
+            finished.push_back(std::move(chunk));
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cmath>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Cube structure represents a single 3D cube in the world
+// Used for both static geometry (walls, floor) and collectible items
+struct Cube {
+    glm::vec3 pos;        // Position in world space
+    glm::vec3 size;       // Width, height, depth dimensions
+    glm::vec3 color;      // RGB color for rendering
+    bool isItem;          // True if collectible item, false if wall/static
+    int id;               // Unique identifier for items
+};
+
+// Axis-aligned bounding box used for collision and culling
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// Side length of one square chunk on the XZ plane (world units)
+const float CHUNK_SIZE = 16.0f;
+
+// Parameters that fully describe the static world
+// Chunks are generated from these alone, so any chunk can be rebuilt on demand
+struct WorldLayout {
+    float halfSize = 20.0f;        // World spans [-halfSize, halfSize] on X and Z
+    float height = 10.0f;          // Height of the boundary walls / ceiling
+    float pillarDensity = 0.0f;    // Average pillars per chunk (0 = empty arena)
+    unsigned int seed = 1337;      // Seed for procedural obstacles
+
+    // How far from the origin a player may move on X and Z
+    float boundsLimit() const { return halfSize - 1.0f; }
+};
+
+// Chunk holds the static geometry for one CHUNK_SIZE x CHUNK_SIZE cell of the world
+// Render data (model matrices) and collision data (AABBs) are built on the worker thread
+struct Chunk {
+    int cx = 0, cz = 0;                 // Chunk grid coordinates
+    std::vector<Cube> cubes;            // Static cubes inside this chunk
+    std::vector<glm::mat4> models;      // Pre-built model matrix per cube
+    std::vector<AABB> colliders;        // Collision box per cube
+    AABB bounds;                        // Bounds of all cubes in the chunk
+};
+
+// Pack chunk coordinates into a single map key
+inline long long chunkKey(int cx, int cz) {
+    return ((long long)cx << 32) ^ (long long)(unsigned int)cz;
+}
+
+// Convert a world-space coordinate to the chunk index containing it
+inline int chunkCoord(float v) {
+    return (int)std::floor(v / CHUNK_SIZE);
+}
+
+// Build the geometry, render and collision data of chunk (cx, cz)
+void generateChunk(const WorldLayout& layout, int cx, int cz, Chunk& out);
+
+// ChunkStreamer generates chunks on background worker threads
+// The main thread requests chunks and collects finished ones each frame
+class ChunkStreamer {
+public:
+    ChunkStreamer();
+    ~ChunkStreamer();
+
+    // Start worker threads for the given layout (restarts if already running)
+    void start(const WorldLayout& layout, int workerCount);
+
+    // Stop and join all worker threads
+    void stop();
+
+    // Queue chunk (cx, cz) for generation
+    void request(int cx, int cz);
+
+    // Drop all queued requests and discard results still in flight
+    void cancelAll();
+
+    // Move all finished chunks into out, returns number collected
+    int collect(std::vector<std::unique_ptr<Chunk>>& out);
+
+    // Number of requests queued or being generated
+    int pendingCount();
+
+private:
+    // Worker thread body: pop requests and generate chunks
+    void workerLoop();
+
+    std::vector<std::thread> workers;                  // Generation threads
+    std::mutex mutex;                                  // Guards everything below
+    std::condition_variable wake;                      // Signals new requests / shutdown
+    std::deque<std::pair<int, int>> queue;             // Chunks waiting for a worker
+    std::vector<std::unique_ptr<Chunk>> finished;      // Chunks ready for the main thread
+    WorldLayout layout;                                // Layout used by the workers
+    unsigned int generation;                           // Bumped on cancel to drop stale work
+    int inFlight;                                      // Chunks currently being generated
+    bool running;                                      // False tells workers to exit
+};
@@ -0,0 +1,266 @@
+#include "Demo.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Input flags packed into one 16-bit field per tick
+enum TickFlags : uint16_t {
+    TICK_FORWARD = 1 << 0,
+    TICK_BACK    = 1 << 1,
+    TICK_LEFT    = 1 << 2,
+    TICK_RIGHT   = 1 << 3,
+    TICK_JUMP    = 1 << 4,
+    TICK_RELOAD  = 1 << 5,
+    TICK_ENTER   = 1 << 6,
+    TICK_PAUSE   = 1 << 7,
+    TICK_QUICKSAVE = 1 << 8,
+    TICK_QUICKLOAD = 1 << 9
+};
+
+static const char HEADER_MAGIC[4] = { 'S', 'D', 'M', '1' };
+static const char FOOTER_MAGIC[4] = { 'S', 'D', 'M', 'X' };
+static const int HEADER_BYTES = 16;
+static const int FOOTER_BYTES = 20;
+static const size_t HANDOFF_BYTES = 16 * 1024;   // Pending bytes that wake the writer
+
+// rand() seed written with the keyframe at a tick
+static uint32_t keyframeSeed(uint32_t tick) {
+    return 0x9E3779B9u ^ (tick * 2654435761u);
+}
+
+// Constructor
+DemoRecorder::DemoRecorder()
+    : recording(false), tick(0), offset(0), keyframeRequested(false), recordMs(0.0), stopping(false) {}
+
+// Destructor: finish the file if still recording
+DemoRecorder::~DemoRecorder() {
+    if (recording) stop();
+}
+
+// Open the file and start the writer thread
+bool DemoRecorder::start(const std::string& path) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "ERROR::DEMO::CANNOT_WRITE " << path << "\n";
+        return false;
+    }
+
+    uint32_t header[3] = { Demo::VERSION, (uint32_t)Demo::KEYFRAME_INTERVAL, 0 };
+    file.write(HEADER_MAGIC, 4);
+    file.write((const char*)header, sizeof(header));
+    offset = HEADER_BYTES;
+    pending.reserve(HANDOFF_BYTES * 2);
+    index.reserve(1024);   // About 85 minutes of keyframes before the index grows
+
+    stopping = false;
+    recording = true;
+    writer = std::thread(&DemoRecorder::writerLoop, this);
+    std::cout << "Recording demo to " << path << "\n";
+    return true;
+}
+
+// Append raw bytes to the pending buffer
+void DemoRecorder::put(const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    pending.insert(pending.end(), p, p + bytes);
+    offset += bytes;
+}
+
+// Write a keyframe when due, then the tick's input
+void DemoRecorder::record(const FrameInput& in, const StateDigest& digest, const Demo::CaptureFn& capture) {
+    if (!recording) return;
+    auto start = std::chrono::steady_clock::now();
+
+    if (tick % Demo::KEYFRAME_INTERVAL == 0 || keyframeRequested) {
+        keyframeRequested = false;
+        uint32_t seed = keyframeSeed(tick);
+        std::srand(seed);
+        state.clear();
+        capture(state);
+
+        index.push_back({ tick, offset });
+        put('K');
+        put(tick);
+        put(seed);
+        put((uint32_t)state.size());
+        put(state.data(), state.size());
+    }
+
+    uint16_t flags = (in.forward ? TICK_FORWARD : 0) | (in.back ? TICK_BACK : 0) |
+                     (in.left ? TICK_LEFT : 0) | (in.right ? TICK_RIGHT : 0) |
+                     (in.jump ? TICK_JUMP : 0) | (in.reload ? TICK_RELOAD : 0) |
+                     (in.enter ? TICK_ENTER : 0) | (in.pause ? TICK_PAUSE : 0) |
+                     (in.quicksave ? TICK_QUICKSAVE : 0) | (in.quickload ? TICK_QUICKLOAD : 0);
+    put('T');
+    put(in.deltaTime);
+    put(in.mouseDX);
+    put(in.mouseDY);
+    put(flags);
+    put((int8_t)in.weaponSlot);
+    put((uint8_t)in.clickCount);
+    put(in.clicks, sizeof(FrameClick) * in.clickCount);
+    put(digest.parts, sizeof(digest.parts));
+    tick++;
+
+    if (pending.size() >= HANDOFF_BYTES) handOff();
+    recordMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Hand the pending buffer to the writer thread
+void DemoRecorder::handOff() {
+    if (pending.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(std::move(pending));
+        if (!spare.empty()) {
+            pending = std::move(spare.back());
+            spare.pop_back();
+        } else {
+            pending = std::vector<unsigned char>();
+            pending.reserve(HANDOFF_BYTES * 2);
+        }
+    }
+    pending.clear();
+    wake.notify_one();
+}
+
+// Writer thread: write queued buffers in order, then recycle them
+void DemoRecorder::writerLoop() {
+    std::vector<std::vector<unsigned char>> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !queued.empty(); });
+        if (queued.empty() && stopping) break;
+
+        batch.swap(queued);
+        lock.unlock();
+        for (auto& buffer : batch) file.write((const char*)buffer.data(), buffer.size());
+        lock.lock();
+        for (auto& buffer : batch) spare.push_back(std::move(buffer));
+        batch.clear();
+    }
+}
+
+// Flush, write the keyframe index and close the file
+void DemoRecorder::stop() {
+    if (!recording) return;
+    handOff();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+
+    // The writer is done, so the file position is offset: the index goes right after the records
+    uint64_t indexOffset = offset;
+    for (const Demo::IndexEntry& e : index) {
+        file.write((const char*)&e.tick, sizeof(e.tick));
+        file.write((const char*)&e.offset, sizeof(e.offset));
+    }
+    uint32_t keyframes = (uint32_t)index.size();
+    file.write((const char*)&tick, sizeof(tick));
+    file.write((const char*)&keyframes, sizeof(keyframes));
+    file.write((const char*)&indexOffset, sizeof(indexOffset));
+    file.write(FOOTER_MAGIC, 4);
+    file.close();
+    recording = false;
+
+    std::cout << "[DEBUG] Demo: " << tick << " ticks, " << keyframes << " keyframes, "
+              << (indexOffset + FOOTER_BYTES + keyframes * 12) / 1024 << " KB, record cost "
+              << (tick ? recordMs * 1000.0 / tick : 0.0) << " us/tick\n";
+}
+
+// Read the header, footer and keyframe index
+bool DemoPlayer::open(const std::string& path) {
+    file.open(path, std::ios::binary);
+    char magic[4];
+    uint32_t header[3];
+    if (!file || !file.read(magic, 4) || std::memcmp(magic, HEADER_MAGIC, 4) != 0 ||
+        !file.read((char*)header, sizeof(header)) || header[0] != Demo::VERSION) {
+        std::cerr << "ERROR::DEMO::NOT_A_DEMO " << path << "\n";
+        return false;
+    }
+
+    uint32_t keyframes = 0;
+    uint64_t indexOffset = 0;
+    file.seekg(-FOOTER_BYTES, std::ios::end);
+    if (!get(tickCount) || !get(keyframes) || !get(indexOffset) || !file.read(magic, 4) ||
+        std::memcmp(magic, FOOTER_MAGIC, 4) != 0) {
+        std::cerr << "ERROR::DEMO::TRUNCATED " << path << " (recording was not stopped cleanly)\n";
+        return false;
+    }
+
+    file.seekg(indexOffset);
+    index.resize(keyframes);
+    for (Demo::IndexEntry& e : index) {
+        if (!get(e.tick) || !get(e.offset)) {
+            std::cerr << "ERROR::DEMO::BAD_INDEX " << path << "\n";
+            return false;
+        }
+    }
+
+    file.seekg(HEADER_BYTES);
+    tick = 0;
+    std::cout << "Playing demo " << path << ": " << tickCount << " ticks, " << keyframes << " keyframes\n";
+    return true;
+}
+
+// Position playback on the nearest keyframe at or before tick
+int DemoPlayer::seek(int target) {
+    const Demo::IndexEntry* best = nullptr;
+    for (const Demo::IndexEntry& e : index) {
+        if ((int)e.tick > target) break;
+        best = &e;
+    }
+    if (!best) return (int)tick;
+
+    file.clear();
+    file.seekg(best->offset);
+    tick = best->tick;
+    return (int)tick;
+}
+
+// Read the next tick's input
+bool DemoPlayer::next(FrameInput& in, StateDigest& digest, const Demo::RestoreFn& restore) {
+    if (tick >= tickCount) return false;
+
+    char type = 0;
+    while (get(type) && type == 'K') {
+        uint32_t kfTick = 0, seed = 0, size = 0;
+        if (!get(kfTick) || !get(seed) || !get(size)) return false;
+        state.resize(size);
+        if (!file.read((char*)state.data(), size)) return false;
+        std::srand(seed);
+        restore(state);
+        tick = kfTick;
+    }
+    if (type != 'T') return false;
+
+    uint16_t flags = 0;
+    int8_t weaponSlot = -1;
+    uint8_t clickCount = 0;
+    in = FrameInput();
+    if (!get(in.deltaTime) || !get(in.mouseDX) || !get(in.mouseDY) || !get(flags) ||
+        !get(weaponSlot) || !get(clickCount) || clickCount > FrameInput::MAX_CLICKS)
+        return false;
+    if (!file.read((char*)in.clicks, sizeof(FrameClick) * clickCount) ||
+        !file.read((char*)digest.parts, sizeof(digest.parts)))
+        return false;
+
+    in.clickCount = clickCount;
+    in.weaponSlot = weaponSlot;
+    in.forward = (flags & TICK_FORWARD) != 0;
+    in.back = (flags & TICK_BACK) != 0;
+    in.left = (flags & TICK_LEFT) != 0;
+    in.right = (flags & TICK_RIGHT) != 0;
+    in.jump = (flags & TICK_JUMP) != 0;
+    in.reload = (flags & TICK_RELOAD) != 0;
+    in.enter = (flags & TICK_ENTER) != 0;
+    in.pause = (flags & TICK_PAUSE) != 0;
+    in.quicksave = (flags & TICK_QUICKSAVE) != 0;
+    in.quickload = (flags & TICK_QUICKLOAD) != 0;
+    tick++;
+    return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameInput.h"
+#include "StateHash.h"
+
+// Gameplay demo files: per-tick input plus periodic full-state keyframes
+//
+// Layout (little endian, as written by the game):
+//   header   "SDM1", version, keyframe interval, reserved
+//   records  'T' + packed FrameInput + StateDigest of the state the tick starts from,
+//            or 'K' + tick, RNG seed, state size, state bytes
+//   index    (tick, file offset) of every keyframe
+//   footer   tick count, keyframe count, index offset, "SDMX"
+//
+// Every keyframe reseeds rand(), so re-simulating from any keyframe reproduces the match.
+// The per-tick digests let playback catch the tick where the re-simulation diverges.
+// Playback seeks by jumping to the nearest keyframe at or before a tick and replaying from there
+namespace Demo {
+    const uint32_t VERSION = 3;
+    const int KEYFRAME_INTERVAL = 300;   // Ticks between keyframes (5 s at 60 Hz)
+
+    // Serialized game state of a keyframe (produced / consumed by the game)
+    using State = std::vector<unsigned char>;
+    using CaptureFn = std::function<void(State&)>;
+    using RestoreFn = std::function<void(const State&)>;
+
+    // Keyframe index entry
+    struct IndexEntry {
+        uint32_t tick;
+        uint64_t offset;
+    };
+}
+
+// DemoRecorder appends ticks on the simulation thread and writes them on a background thread
+// The simulation thread only packs bytes into a buffer; file I/O never blocks a frame
+class DemoRecorder {
+public:
+    DemoRecorder();
+    ~DemoRecorder();
+
+    // Open the file and start the writer thread
+    bool start(const std::string& path);
+
+    // Simulation thread, once per tick before the tick is simulated:
+    // writes a keyframe (reseeding rand()) when one is due, then the tick's input and state digest
+    void record(const FrameInput& in, const StateDigest& digest, const Demo::CaptureFn& capture);
+
+    // Force a keyframe on the next tick (after state changes that input does not explain, e.g. a restart)
+    void requestKeyframe() { keyframeRequested = true; }
+
+    // Flush, write the keyframe index and close the file
+    void stop();
+
+    bool isRecording() const { return recording; }
+    int getTick() const { return (int)tick; }
+
+private:
+    std::ofstream file;
+    bool recording;
+    uint32_t tick;
+    uint64_t offset;                     // File offset of the next byte packed
+    bool keyframeRequested;
+    std::vector<Demo::IndexEntry> index;
+    Demo::State state;                   // Reused keyframe capture buffer
+    std::vector<unsigned char> pending;  // Bytes not yet handed to the writer
+    double recordMs;                     // Time spent in record() (overhead report)
+
+    // Writer thread hand-off
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::vector<unsigned char>> queued;   // Buffers waiting to be written
+    std::vector<std::vector<unsigned char>> spare;    // Written buffers, reused for packing
+    bool stopping;
+
+    // Append raw bytes to the pending buffer
+    void put(const void* data, size_t bytes);
+    template <typename T> void put(const T& value) { put(&value, sizeof(T)); }
+
+    // Hand the pending buffer to the writer thread
+    void handOff();
+
+    // Writer thread body
+    void writerLoop();
+};
+
+// DemoPlayer reads a demo back tick by tick and can seek through its keyframe index
+class DemoPlayer {
+public:
+    // Read the header, footer and keyframe index
+    bool open(const std::string& path);
+
+    // Position playback on the nearest keyframe at or before tick; returns that keyframe's tick
+    // The keyframe is restored by the next call to next(); re-simulate up to tick from there
+    int seek(int tick);
+
+    // Read the next tick's input and the digest of the state it started from when recorded;
+    // keyframes met on the way are restored and reseed rand(). Returns false at the end of the demo
+    bool next(FrameInput& in, StateDigest& digest, const Demo::RestoreFn& restore);
+
+    int getTickCount() const { return (int)tickCount; }
+    int getTick() const { return (int)tick; }
+
+private:
+    std::ifstream file;
+    uint32_t tickCount = 0;
+    uint32_t tick = 0;                   // Tick the next call to next() returns
+    std::vector<Demo::IndexEntry> index;
+    Demo::State state;                   // Reused keyframe buffer
+
+    template <typename T> bool get(T& value) { return (bool)file.read((char*)&value, sizeof(T)); }
+};
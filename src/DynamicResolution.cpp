@@ -0,0 +1,124 @@
+#include "DynamicResolution.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+
+// Constructor
+DynamicResolution::DynamicResolution()
+    : fbo(0), colorBuffer(0), depthBuffer(0), width(0), height(0), scaledWidth(0), scaledHeight(0),
+      queryIndex(0), queryActive(false), budgetMs(15.0f), scale(1.0f), integral(1.0f), gpuMs(0.0f) {
+    for (int i = 0; i < QUERIES; ++i) {
+        queries[i] = 0;
+        queryPending[i] = false;
+    }
+}
+
+// Destructor: release the target and queries
+DynamicResolution::~DynamicResolution() {
+    if (fbo) releaseTarget();
+    if (queries[0]) glDeleteQueries(QUERIES, queries);
+}
+
+// (Re)create the target at the given size
+void DynamicResolution::createTarget(int w, int h) {
+    if (fbo) releaseTarget();
+    width = w;
+    height = h;
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR::DYNRES::FRAMEBUFFER_INCOMPLETE\n";
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Delete the target
+void DynamicResolution::releaseTarget() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    fbo = colorBuffer = depthBuffer = 0;
+}
+
+// Bind the offscreen target at the current scale
+void DynamicResolution::begin3D(int w, int h) {
+    // Minimized windows report 0x0; keep a 1x1 target rather than an incomplete one
+    w = std::max(w, 1);
+    h = std::max(h, 1);
+    if (w != width || h != height) createTarget(w, h);
+
+    if (!queries[0]) glGenQueries(QUERIES, queries);
+
+    // Collect any finished timings; a query is only reused once its result has been read
+    for (int i = 0; i < QUERIES; ++i) {
+        int slot = (queryIndex + i) % QUERIES;
+        if (!queryPending[slot]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &ns);
+        queryPending[slot] = false;
+        update((float)(ns / 1.0e6));
+    }
+    if (!queryPending[queryIndex]) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[queryIndex]);
+        queryActive = true;
+    }
+
+    scaledWidth = std::max(1, (int)(width * scale + 0.5f));
+    scaledHeight = std::max(1, (int)(height * scale + 0.5f));
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, scaledWidth, scaledHeight);
+}
+
+// Upscale the 3D target to the window
+void DynamicResolution::end3D() {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFbo);
+    glBlitFramebuffer(0, 0, scaledWidth, scaledHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+    glViewport(0, 0, width, height);
+}
+
+// Close the frame's timer query
+void DynamicResolution::endFrame() {
+    if (queryActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[queryIndex] = true;
+        queryIndex = (queryIndex + 1) % QUERIES;
+        queryActive = false;
+    }
+
+    // Debug output every 2 seconds
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - lastReport).count() > 2.0f) {
+        std::cout << "[DEBUG] DynRes: scale " << scale << ", " << scaledWidth << "x" << scaledHeight
+                  << ", GPU " << gpuMs << " ms / budget " << budgetMs << " ms\n";
+        lastReport = now;
+    }
+}
+
+// Feed one GPU time sample to the controller
+void DynamicResolution::update(float sampleMs) {
+    gpuMs = sampleMs;
+    if (!adaptive) return;
+
+    // Relative error: positive when there is headroom, negative when over budget
+    float error = (budgetMs - sampleMs) / budgetMs;
+    error = std::max(-1.0f, std::min(error, 1.0f));
+
+    // Clamping the integral stops it winding up while the scale sits at a limit
+    integral = std::max(minScale, std::min(integral + ki * error, maxScale));
+    scale = std::max(minScale, std::min(integral + kp * error, maxScale));
+}
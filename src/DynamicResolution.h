@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+
+// DynamicResolution renders the 3D pass into an offscreen target whose resolution follows
+// a PI controller on measured GPU frame time, then upscales it to the window.
+// The target is allocated at window size and the scene is drawn into a scaled sub-rectangle,
+// so changing the scale never reallocates. GPU time comes from GL_TIME_ELAPSED queries read
+// a few frames late, so the CPU never waits on them
+class DynamicResolution {
+public:
+    static const int QUERIES = 4;    // Timer queries in flight
+
+    DynamicResolution();
+    ~DynamicResolution();
+
+    // GPU frame time to hold, in milliseconds
+    void setBudget(float ms) { budgetMs = ms; }
+
+    // Adaptive scaling on/off; when off the 3D pass renders at native resolution (timedemos)
+    void setAdaptive(bool on) { adaptive = on; if (!on) scale = integral = maxScale; }
+
+    // Framebuffer the 3D target is upscaled into (0 = window; headless runs use their own)
+    void setOutput(unsigned int framebuffer) { outputFbo = framebuffer; }
+
+    // Bind the offscreen target at the current scale; (re)creates it when the window size changes
+    void begin3D(int width, int height);
+
+    // Upscale the 3D target to the window and bind the output framebuffer for the HUD
+    void end3D();
+
+    // The frame is submitted: close its timer query and update the scale
+    void endFrame();
+
+    float getScale() const { return scale; }
+    float getGpuMs() const { return gpuMs; }
+
+private:
+    unsigned int fbo;
+    unsigned int colorBuffer;
+    unsigned int depthBuffer;
+    unsigned int outputFbo = 0;
+    int width, height;               // Window size the target was created for
+    int scaledWidth, scaledHeight;   // Sub-rectangle rendered this frame
+
+    unsigned int queries[QUERIES];
+    bool queryPending[QUERIES];
+    int queryIndex;
+    bool queryActive;
+
+    float budgetMs;
+    bool adaptive = true;
+    float scale;
+    float integral;                  // Integral term, kept within [minScale, maxScale]
+    float gpuMs;                     // Last measured GPU frame time
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    float kp = 0.2f;                 // Proportional gain (per unit of relative error)
+    float ki = 0.05f;                // Integral gain (per frame)
+
+    std::chrono::steady_clock::time_point lastReport = std::chrono::steady_clock::now();
+
+    // (Re)create the target at the given size
+    void createTarget(int w, int h);
+
+    // Delete the target
+    void releaseTarget();
+
+    // Feed one GPU time sample to the controller
+    void update(float sampleMs);
+};
@@ -1,17 +1,12 @@
 #include "Enemy.h"
-#include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
+#include "AllocTracker.h"
 #include <iostream>
 #include <chrono>
 #include <algorithm>
-#include <GLFW/glfw3.h>
 #include <time.h>
 
 //Haider Commit
 
-// Static timer for debug output
-static auto lastEnemyDebug = std::chrono::steady_clock::now();
-
 // Constructor: initialize enemy with position and color
 Enemy::Enemy(glm::vec3 pos, glm::vec3 col)
     : position(pos), color(col), health(100.0f), alive(true),
@@ -30,14 +25,9 @@ void Enemy::update(float deltaTime, glm::vec3 playerPos) {
     // Actual logic in EnemyManager
 }
 
-// Render enemy (placeholder - handled by manager)
-void Enemy::render(unsigned int cubeVAO, glm::mat4 VP, unsigned int shaderID) {
-    // Actual rendering in EnemyManager
-}
-
 // Constructor: initialize enemy manager with default attack values
 EnemyManager::EnemyManager()
-    : attackCooldown(1.0f), attackDamage(15.0f), attackRange(2.0f) {}
+    : attackCooldown(1.0f), attackDamage(15.0f), attackRange(2.0f), worldLimit(20.0f), randomState(0) {}
 
 // Destructor: clean up enemies
 EnemyManager::~EnemyManager() {
@@ -47,17 +37,40 @@ EnemyManager::~EnemyManager() {
 // Add a new enemy to the game world
 void EnemyManager::spawn(glm::vec3 pos, glm::vec3 col) {
     enemies.push_back(Enemy(pos, col));
+    // Room for every enemy in the change list now, so marking during update() never allocates
+    if (changed.capacity() < enemies.size()) changed.reserve(enemies.capacity());
+    changedFlags.resize(enemies.size(), 0);
+    markChanged((int)enemies.size() - 1);
 }
 
 // Update all enemies each frame
 // Handles AI behavior including patrol and chase
 void EnemyManager::update(float deltaTime, glm::vec3 playerPos) {
-    float limit = 20.0f;  // World boundary
+    update(deltaTime, &playerPos, 1);
+}
+
+// Update all enemies against several players; each enemy chases the nearest one
+void EnemyManager::update(float deltaTime, const glm::vec3* players, int playerCount) {
+    AllocScope allocTag(AllocTag::ENEMY);
+    float limit = worldLimit;  // World boundary
 
-    for (auto& e : enemies) {
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        Enemy& e = enemies[i];
         if (!e.alive) continue;  // Skip dead enemies
+        markChanged((int)i);     // Every live enemy moves
         
-        float distToPlayer = glm::distance(e.position, playerPos);
+        // Nearest player (squared distances to pick it, then the exact distance)
+        glm::vec3 playerPos = e.position;
+        float best = 1e30f;
+        for (int p = 0; p < playerCount; ++p) {
+            glm::vec3 d = players[p] - e.position;
+            float d2 = glm::dot(d, d);
+            if (d2 < best) {
+                best = d2;
+                playerPos = players[p];
+            }
+        }
+        float distToPlayer = playerCount > 0 ? glm::distance(e.position, playerPos) : 1e30f;
 
         // If player is close, chase them
         if (distToPlayer < 18.0f && e.color != glm::vec3(0.0,0.0,0.0)) {
@@ -73,9 +86,9 @@ void EnemyManager::update(float deltaTime, glm::vec3 playerPos) {
             // Pick new patrol target every 5 seconds or when reached
             if (glm::distance(e.position, e.patrolTarget) < 0.5f || e.patrolTimer > 5.0f) {
                 e.patrolTarget = glm::vec3(
-                    -limit + (rand() % int(limit * 200)) / 100.0f,
+                    -limit + (random() % int(limit * 200)) / 100.0f,
                     1.8f,
-                    -limit + (rand() % int(limit * 200)) / 100.0f
+                    -limit + (random() % int(limit * 200)) / 100.0f
                 );
                 e.patrolTimer = 0.0f;
             }
@@ -96,87 +109,95 @@ void EnemyManager::update(float deltaTime, glm::vec3 playerPos) {
     }
 }
 
-// Render all living enemies with health bars
-void EnemyManager::render(unsigned int VAO, glm::mat4 VP, unsigned int shaderID) {
-    glBindVertexArray(VAO);
+// Enemy body is a 1.5 unit cube; the health bar sits 1.8 units above its center
+AABB EnemyManager::getBounds(const Enemy& e) {
+    return {e.position - glm::vec3(0.75f), e.position + glm::vec3(0.75f, 1.95f, 0.75f)};
+}
 
-    // Debug output every 2 seconds
-    auto now = std::chrono::steady_clock::now();
-    if (std::chrono::duration<float>(now - lastEnemyDebug).count() > 2.0f) {
-        std::cout << "[DEBUG] Rendering " << enemies.size() << " enemies\n";
-        lastEnemyDebug = now;
-    }
+// Box that shots are tested against: the 1.5 unit body cube
+AABB EnemyManager::getHitBox(const Enemy& e) {
+    return {e.position - glm::vec3(0.75f), e.position + glm::vec3(0.75f)};
+}
 
-    for (const auto& e : enemies) {
-        if (!e.alive) continue;
-        
-        // Render enemy body as cube
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, e.position);
-        model = glm::scale(model, glm::vec3(1.5f));
-        glm::mat4 mvp = VP * model;
-
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "uMVP"), 1, GL_FALSE, &mvp[0][0]);
-        glUniform3fv(glGetUniformLocation(shaderID, "uColor"), 1, &e.color[0]);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        // Render health bar above enemy
-        float healthRatio = e.health / 100.0f;
-        if (healthRatio > 0) {
-            glm::mat4 barModel = glm::translate(model, glm::vec3(0, 1.2f, 0));
-            barModel = glm::scale(barModel, glm::vec3(healthRatio * 1.0f, 0.15f, 0.15f));
-
-            glm::mat4 barMVP = VP * barModel;
-            glUniformMatrix4fv(glGetUniformLocation(shaderID, "uMVP"), 1, GL_FALSE, &barMVP[0][0]);
-            glUniform3f(glGetUniformLocation(shaderID, "uColor"), 1.0f, 0.0f, 0.0f);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        }
-    }
-    glBindVertexArray(0);
+// Ray direction reciprocal for the slab test (zero components nudged like before)
+static glm::vec3 inverseDir(const glm::vec3& dir) {
+    return glm::vec3(1.0f / (dir.x != 0 ? dir.x : 1e-6f), 1.0f / (dir.y != 0 ? dir.y : 1e-6f),
+                     1.0f / (dir.z != 0 ? dir.z : 1e-6f));
+}
+
+// Ray-AABB slab test; t is the entry distance along the ray
+static bool rayHitsBox(const glm::vec3& orig, const glm::vec3& invDir, const AABB& box, float& t) {
+    const glm::vec3& min = box.min;
+    const glm::vec3& max = box.max;
+
+    // Ray-AABB intersection on X axis
+    float tmin = (min.x - orig.x) * invDir.x;
+    float tmax = (max.x - orig.x) * invDir.x;
+    if (tmin > tmax) std::swap(tmin, tmax);
+
+    // Ray-AABB intersection on Y axis
+    float ty_min = (min.y - orig.y) * invDir.y;
+    float ty_max = (max.y - orig.y) * invDir.y;
+    if (ty_min > ty_max) std::swap(ty_min, ty_max);
+
+    if (tmin > ty_max || ty_min > tmax) return false;
+    if (ty_min > tmin) tmin = ty_min;
+    if (ty_max < tmax) tmax = ty_max;
+
+    // Ray-AABB intersection on Z axis
+    float tz_min = (min.z - orig.z) * invDir.z;
+    float tz_max = (max.z - orig.z) * invDir.z;
+    if (tz_min > tz_max) std::swap(tz_min, tz_max);
+
+    if (tmin > tz_max || tz_min > tmax) return false;
+    if (tz_min > tmin) tmin = tz_min;
+
+    t = tmin;
+    return true;
 }
 
 // Ray-AABB intersection test for shooting enemies
 bool EnemyManager::hitTest(const glm::vec3& orig, const glm::vec3& dir, int& outID, float& outDist) {
     outDist = 1e9f;
     int best = -1;
+    glm::vec3 invDir = inverseDir(dir);
     
     for (size_t i = 0; i < enemies.size(); ++i) {
         if (!enemies[i].alive) continue;
         
-        const Enemy& e = enemies[i];
-        // Create bounding box around enemy
-        glm::vec3 min = e.position - glm::vec3(0.75f);
-        glm::vec3 max = e.position + glm::vec3(0.75f);
-
-        // Ray-AABB intersection on X axis
-        float tmin = (min.x - orig.x) / (dir.x != 0 ? dir.x : 1e-6f);
-        float tmax = (max.x - orig.x) / (dir.x != 0 ? dir.x : 1e-6f);
-        if (tmin > tmax) std::swap(tmin, tmax);
-
-        // Ray-AABB intersection on Y axis
-        float ty_min = (min.y - orig.y) / (dir.y != 0 ? dir.y : 1e-6f);
-        float ty_max = (max.y - orig.y) / (dir.y != 0 ? dir.y : 1e-6f);
-        if (ty_min > ty_max) std::swap(ty_min, ty_max);
-
-        if (tmin > ty_max || ty_min > tmax) continue;
-        if (ty_min > tmin) tmin = ty_min;
-        if (ty_max < tmax) tmax = ty_max;
+        // Find closest hit enemy
+        float t;
+        if (rayHitsBox(orig, invDir, getHitBox(enemies[i]), t) && t > 0 && t < outDist) {
+            outDist = t;
+            best = (int)i;
+        }
+    }
+    
+    if (best != -1) {
+        outID = best;
+        return true;
+    }
+    return false;
+}
 
-        // Ray-AABB intersection on Z axis
-        float tz_min = (min.z - orig.z) / (dir.z != 0 ? dir.z : 1e-6f);
-        float tz_max = (max.z - orig.z) / (dir.z != 0 ? dir.z : 1e-6f);
-        if (tz_min > tz_max) std::swap(tz_min, tz_max);
+// Same test against stored hit boxes; empty boxes (min > max) are enemies that were dead
+bool EnemyManager::hitTest(const glm::vec3& orig, const glm::vec3& dir, const RewindFrame& frame, int& outID, float& outDist) const {
+    outDist = 1e9f;
+    int best = -1;
+    glm::vec3 invDir = inverseDir(dir);
 
-        if (tmin > tz_max || tz_min > tmax) continue;
-        if (tz_min > tmin) tmin = tz_min;
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        const AABB& box = frame.boxes[i];
+        if (box.min.x > box.max.x) continue;
+        if (frame.spawns[i] != frame.current[i]) continue;   // Respawned since: that life is over
 
-        // Find closest hit enemy
-        if (tmin > 0 && tmin < outDist) {
-            outDist = tmin;
+        float t;
+        if (rayHitsBox(orig, invDir, box, t) && t > 0 && t < outDist) {
+            outDist = t;
             best = (int)i;
         }
     }
-    
+
     if (best != -1) {
         outID = best;
         return true;
@@ -186,7 +207,9 @@ bool EnemyManager::hitTest(const glm::vec3& orig, const glm::vec3& dir, int& out
 
 // Apply damage from enemies to player
 void EnemyManager::attackPlayer(glm::vec3 playerPos, int& playerHealth, float deltaTime) {
-    for (auto& e : enemies) {
+    AllocScope allocTag(AllocTag::ENEMY);
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        Enemy& e = enemies[i];
         if (!e.alive) continue;
         
         // Calculate distance to player
@@ -196,6 +219,7 @@ void EnemyManager::attackPlayer(glm::vec3 playerPos, int& playerHealth, float de
 
         // If player is in melee range, attack
         if (dist < MELEE_RANGE) {
+            markChanged((int)i);
             e.attackTimer += deltaTime;
             if (e.attackTimer >= ATTACK_COOLDOWN) {
                 int damage = (e.color== glm::vec3(0.0,0.0,0.0))? 0 : 15;
@@ -205,7 +229,8 @@ void EnemyManager::attackPlayer(glm::vec3 playerPos, int& playerHealth, float de
             }
         } 
         // Otherwise reset cooldown
-        else {
+        else if (e.attackTimer != 0.0f) {
+            markChanged((int)i);
             e.attackTimer = 0.0f;
         }
     }
@@ -217,12 +242,83 @@ void EnemyManager::attackPlayer(glm::vec3 playerPos, int& playerHealth, float de
     }
 }
 
+// Multiplayer: each enemy attacks the nearest player in melee range
+void EnemyManager::attackPlayers(const glm::vec3* players, int* health, int playerCount, float deltaTime) {
+    AllocScope allocTag(AllocTag::ENEMY);
+    const float MELEE_RANGE = 1.8f;
+    const float ATTACK_COOLDOWN = 1.0f;
+
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        Enemy& e = enemies[i];
+        if (!e.alive) continue;
+
+        int target = -1;
+        float best = MELEE_RANGE * MELEE_RANGE;
+        for (int p = 0; p < playerCount; ++p) {
+            glm::vec3 d = players[p] - e.position;
+            float d2 = glm::dot(d, d);
+            if (d2 < best) {
+                best = d2;
+                target = p;
+            }
+        }
+
+        // Same cooldown rule as attackPlayer: the timer only runs while someone is in range
+        if (target >= 0) {
+            markChanged((int)i);
+            e.attackTimer += deltaTime;
+            if (e.attackTimer >= ATTACK_COOLDOWN) {
+                if (e.color != glm::vec3(0.0f)) health[target] -= 15;
+                e.attackTimer = 0.0f;
+            }
+        } else if (e.attackTimer != 0.0f) {
+            markChanged((int)i);
+            e.attackTimer = 0.0f;
+        }
+    }
+}
+
 // Remove all enemies from the game
 void EnemyManager::clear() {
     enemies.clear();
+    clearChanged();
     std::cout << "All enemies cleared\n";
 }
 
+// Use an own xorshift sequence instead of rand()
+void EnemyManager::seedRandom(unsigned int seed) {
+    randomState = seed * 2654435761u + 1;
+    if (randomState == 0) randomState = 1;
+}
+
+// Next non-negative random number (31 bits once seeded)
+int EnemyManager::random() {
+    if (randomState == 0) return rand();
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return (int)(randomState >> 1);
+}
+
+// Remember that enemy `index` was written (once per clearChanged)
+void EnemyManager::markChanged(int index) {
+    if (index >= (int)changedFlags.size()) changedFlags.resize(std::max(enemies.size(), (size_t)index + 1), 0);
+    if (changedFlags[index]) return;
+    changedFlags[index] = 1;
+    changed.push_back(index);
+}
+
+// Every enemy was written (restores, resizes)
+void EnemyManager::markAllChanged() {
+    for (size_t i = 0; i < enemies.size(); ++i) markChanged((int)i);
+}
+
+// Start a new round of change tracking
+void EnemyManager::clearChanged() {
+    for (int i : changed) changedFlags[i] = 0;
+    changed.clear();
+}
+
 // Return reference to enemy vector
 std::vector<Enemy>& EnemyManager::getAllEnemies() {
     return enemies;
@@ -233,3 +329,52 @@ int EnemyManager::getEnemyCount() const {
     return enemies.size();
 }
 
+// Keep the last `ticks` ticks; drops what was stored
+void EnemyHistory::reset(int ticks) {
+    capacity = std::max(ticks, 1);
+    stored = 0;
+    enemyCount = 0;
+    newest = 0;
+    boxes.clear();
+    spawns.clear();
+    current.clear();
+}
+
+// Store this tick's hit boxes (dead enemies get an empty box)
+void EnemyHistory::record(uint32_t tick, const std::vector<Enemy>& enemies) {
+    if ((int)enemies.size() != enemyCount) {
+        // Enemy count changed (first record): older ticks no longer line up
+        enemyCount = (int)enemies.size();
+        boxes.assign((size_t)capacity * enemyCount, AABB{});
+        spawns.assign((size_t)capacity * enemyCount, 0);
+        current.assign(enemyCount, 0);
+        stored = 0;
+    }
+    size_t offset = (size_t)(tick % capacity) * enemyCount;
+    AABB* slot = boxes.data() + offset;
+    const AABB empty = {glm::vec3(1.0f), glm::vec3(-1.0f)};
+    for (int i = 0; i < enemyCount; ++i) {
+        slot[i] = enemies[i].alive ? EnemyManager::getHitBox(enemies[i]) : empty;
+    }
+    std::copy(current.begin(), current.end(), spawns.begin() + offset);
+    newest = tick;
+    stored = std::min(stored + 1, capacity);
+}
+
+// Bump the enemy's spawn generation; boxes stored under the old one no longer match
+void EnemyHistory::respawned(int index) {
+    if (index >= 0 && index < enemyCount) current[index]++;
+}
+
+// Hit boxes of a tick, clamped to the stored window
+RewindFrame EnemyHistory::getBoxes(uint32_t tick, int count, uint32_t& usedTick) const {
+    RewindFrame frame;
+    if (stored == 0 || count != enemyCount) return frame;
+    uint32_t oldest = newest - (uint32_t)(stored - 1);
+    usedTick = std::min(std::max(tick, oldest), newest);
+    size_t offset = (size_t)(usedTick % capacity) * enemyCount;
+    frame.boxes = boxes.data() + offset;
+    frame.spawns = spawns.data() + offset;
+    frame.current = current.data();
+    return frame;
+}
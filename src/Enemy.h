@@ -1,7 +1,10 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include "Shader.h"
+#include "Occlusion.h"
+#include "RenderQueue.h"
 
 //Haider Commit
 
@@ -33,6 +36,15 @@ public:
     void render(unsigned int cubeVAO, glm::mat4 VP, unsigned int shaderID);
 };
 
+// One tick of EnemyHistory, read in place from its ring
+// A box recorded under another spawn generation than the enemy's current one belongs to
+// a life that has ended (the enemy respawned since) and is not a target
+struct RewindFrame {
+    const AABB* boxes = nullptr;        // Hit box per enemy, nullptr if nothing is stored
+    const uint32_t* spawns = nullptr;   // Spawn generation each box was recorded under
+    const uint32_t* current = nullptr;  // Spawn generation of each enemy now
+};
+
 // EnemyManager class manages all enemies in the game
 // Handles spawning, updating, rendering, and combat
 class EnemyManager {
@@ -41,6 +53,8 @@ public:
     float attackCooldown;          // Time between enemy attacks
     float attackDamage;            // Damage per attack
     float attackRange;             // Distance for melee attack
+    float worldLimit;              // Enemies stay within [-worldLimit, worldLimit] on X and Z
+    unsigned int randomState;      // Own random sequence once seeded (0 = the global rand())
 
     EnemyManager();
     ~EnemyManager();
@@ -51,21 +65,85 @@ public:
     // Remove all enemies
     void clear();
     
+    // Use an own random sequence instead of rand() (servers hosting several matches on
+    // several threads); single player keeps rand(), which demos and the timedemo seed
+    void seedRandom(unsigned int seed);
+    
+    // Next non-negative random number for patrols and spawns (rand() until seeded)
+    int random();
+    
     // Update all enemies each frame
     void update(float deltaTime, glm::vec3 playerPos);
     
-    // Render all enemies
-    void render(unsigned int cubeVAO, glm::mat4 VP, unsigned int shaderID);
+    // Update all enemies against several players; each enemy chases the nearest one
+    void update(float deltaTime, const glm::vec3* players, int playerCount);
+    
+    // Record all enemies, skipping those hidden behind occluders when a culler is given
+    void render(RenderQueue& queue, unsigned int cubeVAO, unsigned int shaderID, OcclusionCuller* culler = nullptr);
+    
+    // Bounding box of an enemy including its health bar
+    static AABB getBounds(const Enemy& e);
+    
+    // Box that shots are tested against
+    static AABB getHitBox(const Enemy& e);
     
     // Apply damage to player from enemies
     void attackPlayer(glm::vec3 playerPos, int& playerHealth, float deltaTime);
     
+    // Multiplayer: each enemy attacks the nearest player in melee range (health[i] belongs to players[i])
+    void attackPlayers(const glm::vec3* players, int* health, int playerCount, float deltaTime);
+    
     // Ray-based hit detection for shooting enemies
     bool hitTest(const glm::vec3& orig, const glm::vec3& dir, int& outID, float& outDist);
     
+    // Same test against stored hit boxes, one per enemy (lag compensation, see EnemyHistory)
+    bool hitTest(const glm::vec3& orig, const glm::vec3& dir, const RewindFrame& frame, int& outID, float& outDist) const;
+    
     // Get reference to all enemies
     std::vector<Enemy>& getAllEnemies();
     
     // Get number of enemies
     int getEnemyCount() const;
+
+    // Enemies written since the last clearChanged(), for StateHash to rehash only those
+    // update(), the attacks and spawn() mark their own writes; code that writes enemies
+    // directly (shots, respawns, restores, replication) marks them itself
+    void markChanged(int index);
+    void markAllChanged();
+    const std::vector<int>& getChanged() const { return changed; }
+    void clearChanged();
+
+private:
+    std::vector<int> changed;             // Indices marked since clearChanged(), each once
+    std::vector<uint8_t> changedFlags;    // By enemy: already in changed
+};
+
+// EnemyHistory keeps the enemy hit boxes of the last few ticks (server lag compensation)
+// Shots are tested against the boxes of the tick the shooter was looking at, read in place
+// from the ring: rewinding copies nothing and never touches the live enemies.
+class EnemyHistory {
+public:
+    // Keep the last `ticks` ticks; drops what was stored
+    void reset(int ticks);
+
+    // Store this tick's hit boxes (dead enemies get an empty box)
+    void record(uint32_t tick, const std::vector<Enemy>& enemies);
+
+    // Enemy `index` came back as a new enemy: its older boxes stop being targets
+    void respawned(int index);
+
+    // Hit boxes of a tick, clamped to the stored window (usedTick says which tick they are from)
+    // frame.boxes is nullptr if nothing has been recorded for the current enemy count
+    RewindFrame getBoxes(uint32_t tick, int enemyCount, uint32_t& usedTick) const;
+
+    uint32_t getNewestTick() const { return newest; }
+
+private:
+    int capacity = 0;
+    int stored = 0;              // Ticks recorded (up to capacity)
+    int enemyCount = 0;
+    uint32_t newest = 0;
+    std::vector<AABB> boxes;     // capacity slots of enemyCount boxes, slot = tick % capacity
+    std::vector<uint32_t> spawns;   // Spawn generation of every stored box, same layout
+    std::vector<uint32_t> current;  // Spawn generation of each enemy now
 };
@@ -0,0 +1,54 @@
+#include "Enemy.h"
+#include "AllocTracker.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <chrono>
+
+// Drawing only: the simulation in Enemy.cpp is shared with the dedicated server, which has no GL
+
+// Static timer for debug output
+static auto lastEnemyDebug = std::chrono::steady_clock::now();
+
+// Render enemy (placeholder - handled by manager)
+void Enemy::render(unsigned int cubeVAO, glm::mat4 VP, unsigned int shaderID) {
+    // Actual rendering in EnemyManager
+}
+
+// Render all living enemies with health bars
+void EnemyManager::render(RenderQueue& queue, unsigned int VAO, unsigned int shaderID, OcclusionCuller* culler) {
+    AllocScope allocTag(AllocTag::ENEMY);
+    int occluded = 0;
+    for (const auto& e : enemies) {
+        if (!e.alive) continue;
+        
+        // Skip enemies hidden behind walls
+        if (culler && !culler->isVisible(getBounds(e))) {
+            occluded++;
+            continue;
+        }
+        
+        // Render enemy body as cube
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, e.position);
+        model = glm::scale(model, glm::vec3(1.5f));
+
+        queue.drawMesh(PASS_OPAQUE, shaderID, VAO, GL_TRIANGLES, 36, true, model, e.color, e.position);
+
+        // Render health bar above enemy
+        float healthRatio = e.health / 100.0f;
+        if (healthRatio > 0) {
+            glm::mat4 barModel = glm::translate(model, glm::vec3(0, 1.2f, 0));
+            barModel = glm::scale(barModel, glm::vec3(healthRatio * 1.0f, 0.15f, 0.15f));
+
+            queue.drawMesh(PASS_OPAQUE, shaderID, VAO, GL_TRIANGLES, 36, true, barModel, glm::vec3(1.0f, 0.0f, 0.0f), e.position);
+        }
+    }
+
+    // Debug output every 2 seconds
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - lastEnemyDebug).count() > 2.0f) {
+        std::cout << "[DEBUG] Rendering " << enemies.size() << " enemies (" << occluded << " occluded)\n";
+        lastEnemyDebug = now;
+    }
+}
@@ -0,0 +1,80 @@
+#include "FrameArena.h"
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+// Constructor: one block of the given size
+FrameArena::FrameArena(size_t capacity)
+    : base(static_cast<char*>(std::malloc(capacity))), capacity(capacity), used(0), spilled(0), peak(0) {
+    overflow.reserve(16);
+}
+
+// Destructor: free the main block and any spill
+FrameArena::~FrameArena() {
+    reset();
+    std::free(base);
+}
+
+// Start of frame: drop every allocation (and grow if the last frame spilled)
+void FrameArena::reset() {
+    for (char* block : overflow) std::free(block);
+    overflow.clear();
+
+    if (spilled > 0) {
+        // Grow to the whole frame plus headroom so the next frames stay in one block
+        size_t grown = (used + spilled) * 3 / 2;
+        std::cout << "[DEBUG] Frame arena: " << used + spilled << " bytes in one frame, growing to " << grown << "\n";
+        std::free(base);
+        base = static_cast<char*>(std::malloc(grown));
+        capacity = grown;
+    }
+    used = 0;
+    spilled = 0;
+}
+
+// Allocate bytes with the given alignment; valid until the next reset()
+void* FrameArena::allocate(size_t bytes, size_t align) {
+    uintptr_t start = (reinterpret_cast<uintptr_t>(base) + used + align - 1) & ~(uintptr_t)(align - 1);
+    size_t end = start - reinterpret_cast<uintptr_t>(base) + bytes;
+    if (end <= capacity) {
+        used = end;
+        if (used + spilled > peak) peak = used + spilled;
+        return reinterpret_cast<void*>(start);
+    }
+
+    // Out of room: spill to the heap for the rest of this frame (malloc is max_align_t aligned)
+    char* block = static_cast<char*>(std::malloc(bytes + align));
+    overflow.push_back(block);
+    spilled += bytes + align;
+    if (used + spilled > peak) peak = used + spilled;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(block) + align - 1) & ~(uintptr_t)(align - 1);
+    return reinterpret_cast<void*>(aligned);
+}
+
+// Give back an allocation; only the most recent one is actually reclaimed
+// (lets a growing vector reuse its old space when nothing was allocated after it)
+void FrameArena::free(void* p, size_t bytes) {
+    char* c = static_cast<char*>(p);
+    if (c >= base && c < base + capacity && c + bytes == base + used) used = c - base;
+}
+
+// printf-style formatting into the arena; the string is valid until the next reset()
+const char* FrameArena::format(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list sizing;
+    va_copy(sizing, args);
+    int len = std::vsnprintf(nullptr, 0, fmt, sizing);
+    va_end(sizing);
+
+    if (len < 0) {
+        va_end(args);
+        return "";
+    }
+    char* out = static_cast<char*>(allocate(len + 1, 1));
+    std::vsnprintf(out, len + 1, fmt, args);
+    va_end(args);
+    return out;
+}
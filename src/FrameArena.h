@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// FrameArena is a linear (bump) allocator for memory that only lives for one frame.
+// Allocating moves a pointer forward, freeing is a no-op, and reset() at the top of the
+// frame releases everything at once. It is used from a single thread (the simulation step).
+// A frame that runs past the end spills into heap blocks, and the next reset() grows the
+// arena to the frame's high-water mark so later frames fit again.
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Start of frame: drop every allocation (and grow if the last frame spilled)
+    void reset();
+
+    // Allocate bytes with the given alignment (power of two); valid until the next reset()
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+    // Give back an allocation; only the most recent one is actually reclaimed
+    void free(void* p, size_t bytes);
+
+    // printf-style formatting into the arena; the string is valid until the next reset()
+    const char* format(const char* fmt, ...);
+
+    size_t getUsed() const { return used; }
+    size_t getCapacity() const { return capacity; }
+    size_t getPeak() const { return peak; }       // Most bytes used by one frame so far
+
+private:
+    char* base;                                   // Main block
+    size_t capacity;                              // Size of the main block
+    size_t used;                                  // Bytes handed out from the main block this frame
+    size_t spilled;                               // Bytes that went to overflow blocks this frame
+    size_t peak;
+    std::vector<char*> overflow;                  // Heap blocks for this frame's spill, freed on reset
+};
+
+// STL allocator that takes its memory from a FrameArena, e.g. for per-frame vectors
+// Containers using it must not outlive the frame they were created in
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) { arena->free(p, n * sizeof(T)); }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+private:
+    template <class U> friend class ArenaAllocator;
+    FrameArena* arena;
+};
+
+// Per-frame vector: construct with ArenaVector<T> v(arena)
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,26 @@
+#pragma once
+
+// A left click buffered during the frame, with the mouse motion that came before it
+// so the shot can be aimed where the player was looking when they clicked
+struct FrameClick {
+    float mouseDX, mouseDY;
+};
+
+// Input sampled on the main thread for one simulation step
+// The simulation runs on the pipeline worker and must not call GLFW itself
+struct FrameInput {
+    static const int MAX_CLICKS = 8;
+
+    float deltaTime = 0.0f;
+    float mouseDX = 0.0f, mouseDY = 0.0f;    // Mouse motion since the last step (coalesced)
+    FrameClick clicks[MAX_CLICKS] = {};      // Left clicks since the last step, in order
+    int clickCount = 0;
+    bool forward = false, back = false, left = false, right = false;
+    bool jump = false, reload = false;
+    bool enter = false, pause = false, escape = false;
+    bool quicksave = false, quickload = false;   // F5 / F9 pressed this step
+    int weaponSlot = -1;                     // Weapon to switch to (-1 = none)
+    int width = 0, height = 0;               // Framebuffer size for the HUD
+    float time = 0.0f;                       // glfwGetTime() when sampled (shader animation only, not replayed)
+    int demoFrame = -1;                      // Timedemo step that drives the camera (-1 = player input)
+};
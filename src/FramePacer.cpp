@@ -0,0 +1,95 @@
+#include "FramePacer.h"
+#include "TickClock.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+// Parse a --pacing value
+bool FramePacer::parse(const std::string& spec) {
+    std::string name = spec;
+    float fps = 0.0f;
+    size_t colon = spec.find(':');
+    if (colon != std::string::npos) {
+        name = spec.substr(0, colon);
+        fps = (float)std::atof(spec.substr(colon + 1).c_str());
+    }
+
+    if (name == "vsync") mode = PacingMode::VSYNC;
+    else if (name == "uncapped") mode = PacingMode::UNCAPPED;
+    else if (name == "limit" && fps > 0.0f) mode = PacingMode::LIMIT;
+    else if (name == "lowlatency") mode = PacingMode::LOW_LATENCY;
+    else return false;
+
+    targetFps = fps;
+    return true;
+}
+
+// Set the swap interval for the mode
+void FramePacer::apply() {
+    if (mode == PacingMode::LOW_LATENCY && targetFps <= 0.0f) {
+        // Pace to the monitor and let vsync line the present up with the refresh
+        const GLFWvidmode* vidmode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        targetFps = (vidmode && vidmode->refreshRate > 0) ? (float)vidmode->refreshRate : 60.0f;
+        glfwSwapInterval(1);
+    } else {
+        glfwSwapInterval(mode == PacingMode::VSYNC ? 1 : 0);
+    }
+
+    if (targetFps > 0.0f)
+        period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+    nextStart = Clock::now();
+    lastPresent = Clock::now();
+
+    const char* names[] = { "vsync", "uncapped", "limit", "lowlatency" };
+    std::cout << "Frame pacing: " << names[(int)mode];
+    if (targetFps > 0.0f) std::cout << " @ " << targetFps << " fps";
+    std::cout << "\n";
+}
+
+// Block until the next frame should start sampling input
+void FramePacer::waitForFrameStart() {
+    if (mode == PacingMode::LIMIT) {
+        TickClock::waitUntil(nextStart, SPIN);
+        auto now = Clock::now();
+        // Keep a steady cadence, but do not try to catch up after a long hitch
+        nextStart = (now - nextStart > period) ? now + period : nextStart + period;
+    } else if (mode == PacingMode::LOW_LATENCY) {
+        // Start as late as possible while still finishing before the next present
+        auto work = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float, std::milli>(workEstimateMs + marginMs));
+        auto deadline = lastPresent + period;
+        if (deadline - work > Clock::now()) TickClock::waitUntil(deadline - work, SPIN);
+    }
+    frameStart = Clock::now();
+}
+
+// The frame's CPU work is done and glfwSwapBuffers is about to be called
+void FramePacer::beginPresent() {
+    // Track how long a frame takes from start to swap (the vsync wait inside the swap is
+    // exactly what low latency mode removes, so it is not counted); rise fast, decay slowly
+    float workMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+    workEstimateMs = workMs > workEstimateMs ? workMs : workEstimateMs * 0.95f + workMs * 0.05f;
+}
+
+// A frame built from input sampled at inputTime has just been presented
+void FramePacer::framePresented(Clock::time_point inputTime) {
+    auto now = Clock::now();
+    lastPresent = now;
+
+    float latencyMs = std::chrono::duration<float, std::milli>(now - inputTime).count();
+    latencySumMs += latencyMs;
+    latencyMaxMs = std::max(latencyMaxMs, latencyMs);
+    latencyCount++;
+
+    // Debug output every 2 seconds
+    float elapsed = std::chrono::duration<float>(now - lastReport).count();
+    if (elapsed > 2.0f) {
+        std::cout << "[DEBUG] Pacing: " << latencyCount / elapsed << " fps, input-to-present avg "
+                  << latencySumMs / latencyCount << " ms, max " << latencyMaxMs << " ms\n";
+        latencySumMs = 0.0f;
+        latencyMaxMs = 0.0f;
+        latencyCount = 0;
+        lastReport = now;
+    }
+}
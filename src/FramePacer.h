@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// How frames are paced
+enum class PacingMode {
+    VSYNC,         // Swap interval 1, the driver blocks in glfwSwapBuffers
+    UNCAPPED,      // Swap interval 0, no waiting
+    LIMIT,         // Swap interval 0, sleep + spin to a target frame rate
+    LOW_LATENCY    // Wait until just before the next present, then poll, simulate and render
+};
+
+// FramePacer decides when each frame starts and measures input-to-present latency
+// (time from sampling input to glfwSwapBuffers returning with a frame built from it)
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::chrono::milliseconds SPIN{2};   // Spun, not slept, before a frame start
+
+    // Parse a --pacing value: vsync, uncapped, limit:<fps>, lowlatency or lowlatency:<fps>
+    bool parse(const std::string& spec);
+
+    // Set the swap interval for the mode; lowlatency without a rate follows the monitor refresh
+    // Call with the GL context current
+    void apply();
+
+    // Block until the next frame should start sampling input
+    void waitForFrameStart();
+
+    // The frame's CPU work is done and glfwSwapBuffers is about to be called
+    void beginPresent();
+
+    // A frame built from input sampled at inputTime has just been presented
+    void framePresented(Clock::time_point inputTime);
+
+    PacingMode getMode() const { return mode; }
+    float getTargetFps() const { return targetFps; }
+
+private:
+    PacingMode mode = PacingMode::VSYNC;
+    float targetFps = 0.0f;                  // 0 = monitor refresh (low latency)
+    Clock::duration period{};                // Frame period for LIMIT / LOW_LATENCY
+    Clock::time_point nextStart{};           // Limiter: when the next frame may start
+    Clock::time_point frameStart{};          // When the current frame started
+    Clock::time_point lastPresent{};         // When the last frame was presented
+    float workEstimateMs = 4.0f;             // Low latency: smoothed frame start to swap time
+    float marginMs = 1.0f;                   // Low latency: safety margin before the deadline
+
+    // Latency samples for the periodic report
+    float latencySumMs = 0.0f;
+    float latencyMaxMs = 0.0f;
+    int latencyCount = 0;
+    Clock::time_point lastReport = Clock::now();
+};
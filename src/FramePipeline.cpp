@@ -0,0 +1,69 @@
+#include "FramePipeline.h"
+#include <chrono>
+
+// Constructor: start the worker thread
+FramePipeline::FramePipeline()
+    : recordIndex(0), hasJob(false), jobDone(false), running(true), busy(false), lastJobMs(0.0f) {
+    worker = std::thread(&FramePipeline::workerLoop, this);
+}
+
+// Destructor: finish any outstanding job and join the worker
+FramePipeline::~FramePipeline() {
+    if (busy) wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+// Hand a frame's input to the worker
+void FramePipeline::kick(const FrameInput& input) {
+    if (busy) wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingInput = input;
+        hasJob = true;
+        jobDone = false;
+    }
+    busy = true;
+    wake.notify_all();
+}
+
+// Block until the worker has finished, then flip the queues
+RenderQueue* FramePipeline::wait() {
+    if (!busy) return nullptr;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.wait(lock, [this] { return jobDone; });
+    jobDone = false;
+    busy = false;
+
+    RenderQueue* recorded = &queues[recordIndex];
+    recordIndex ^= 1;
+    return recorded;
+}
+
+// Worker: run jobs as they arrive
+void FramePipeline::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return !running || hasJob; });
+        if (!running) return;
+
+        FrameInput input = pendingInput;
+        hasJob = false;
+        RenderQueue& target = queues[recordIndex];
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        job(target, input);
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        lastJobMs.store(ms, std::memory_order_relaxed);
+        jobDone = true;
+        wake.notify_all();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "RenderQueue.h"
+#include "FrameInput.h"
+
+// FramePipeline runs the simulation and draw-list recording of frame N+1
+// on a worker thread while the GL thread submits the list of frame N.
+// Two render queues are used: one being recorded, one being executed.
+// The job is set once; each kick only copies the frame's input, so kicking never allocates.
+class FramePipeline {
+public:
+    using Job = std::function<void(RenderQueue&, const FrameInput&)>;
+
+    FramePipeline();
+    ~FramePipeline();
+
+    // Access both queues (e.g. to register programs on each)
+    RenderQueue& getQueue(int index) { return queues[index]; }
+
+    // Set the per-frame job (call before the first kick)
+    void setJob(Job newJob) { job = std::move(newJob); }
+
+    // Run the job on the worker with this input; it records into the queue not currently being executed
+    void kick(const FrameInput& input);
+
+    // Wait for the running job and return the queue it recorded (nullptr if nothing was kicked)
+    RenderQueue* wait();
+
+    // True while a kicked job has not been collected with wait()
+    bool isBusy() const { return busy; }
+
+    // Time the last job took on the worker (ms); safe to read while a job runs
+    float getLastJobMs() const { return lastJobMs.load(std::memory_order_relaxed); }
+
+private:
+    // Worker thread body: run one job per kick
+    void workerLoop();
+
+    RenderQueue queues[2];                       // Double-buffered draw lists
+    int recordIndex;                             // Queue the next job records into
+    std::thread worker;                          // Simulation / recording thread
+    std::mutex mutex;                            // Guards the job hand-off
+    std::condition_variable wake;                // Signals job start and completion
+    Job job;                                     // Per-frame job
+    FrameInput pendingInput;                     // Input for the kicked job
+    bool hasJob;                                 // Job waiting to run
+    bool jobDone;                                // Job finished, not yet collected
+    bool running;                                // False tells the worker to exit
+    bool busy;                                   // Kicked and not yet collected (main thread only)
+    std::atomic<float> lastJobMs;                // Duration of the last job (written by the worker)
+};
@@ -1,4 +1,5 @@
 #include "main_gui.h"
+#include "../AllocTracker.h"
 
 // Global pointers to screen objects
 StartScreen* g_startScreen = nullptr;      // Start menu screen
@@ -16,6 +17,7 @@ void initializeGUI(float screenWidth, float screenHeight) {
 // Render start menu screen
 // Displays main menu with play and exit buttons
 void renderStartMenuScreen() {
+    AllocScope allocTag(AllocTag::GUI);
     if (g_startScreen) {
         g_startScreen->renderStartScreen();
     }
@@ -24,6 +26,7 @@ void renderStartMenuScreen() {
 // Render pause menu screen
 // Displays pause menu with resume, restart, and main menu buttons
 void renderPauseMenuScreen() {
+    AllocScope allocTag(AllocTag::GUI);
     if (g_pauseScreen) {
         g_pauseScreen->renderPauseScreen();
     }
@@ -32,6 +35,7 @@ void renderPauseMenuScreen() {
 // Render end menu screen
 // Displays game over screen with final score
 void renderEndMenuScreen() {
+    AllocScope allocTag(AllocTag::GUI);
     if (g_endScreen) {
         g_endScreen->renderEndScreen(0, false);
     }
@@ -0,0 +1,156 @@
+#include "GameSnapshot.h"
+#include "Camera.h"
+#include "Enemy.h"
+#include "World.h"
+#include "WeaponSystem.h"
+#include "tracer.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+extern int playerHealth;
+extern int score;
+extern int currentAmmo;
+extern int reserveMags;
+extern int partialMagAmmo;
+extern bool pauseKeyPressed;
+extern bool enterpressed;
+extern WeaponSystem ws;
+extern TracerManager tracerManager;
+
+static_assert(std::is_trivially_copyable<Enemy>::value, "Enemy is stored with memcpy");
+static_assert(std::is_trivially_copyable<Cube>::value, "Cube is stored with memcpy");
+static_assert(std::is_trivially_copyable<Tracer>::value, "Tracer is stored with memcpy");
+
+static const char SNAPSHOT_MAGIC[4] = { 'G', 'S', 'N', 'P' };
+
+// Replace out with an image of the current state
+void GameSnapshot::capture(std::vector<unsigned char>& out, const Camera& camera, const EnemyManager& enemies, const World& world) {
+    SnapshotHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, 4);
+    h.version = VERSION;
+    h.worldHalfSize = world.layout.halfSize;
+    h.worldSeed = world.layout.seed;
+
+    h.playerHealth = playerHealth;
+    h.score = score;
+    h.currentAmmo = currentAmmo;
+    h.reserveMags = reserveMags;
+    h.partialMagAmmo = partialMagAmmo;
+    h.pauseKeyPressed = pauseKeyPressed;
+    h.enterPressed = enterpressed;
+
+    h.currentWeapon = ws.currentWeapon;
+    for (int i = 0; i < 3; ++i) {
+        h.reservedMags[i] = ws.weapons[i].reservedMags;
+        h.partialAmmo[i] = ws.weapons[i].partialAmmo;
+        h.weaponAmmo[i] = ws.weapons[i].currentAmmo;
+    }
+
+    h.position[0] = camera.position.x;
+    h.position[1] = camera.position.y;
+    h.position[2] = camera.position.z;
+    h.yaw = camera.yaw;
+    h.pitch = camera.pitch;
+    h.velocityY = camera.velocityY;
+    h.onGround = camera.isOnGround;
+
+    h.enemyCount = (uint32_t)enemies.enemies.size();
+    h.itemCount = (uint32_t)world.cubes.size();
+    h.tracerCount = (uint32_t)tracerManager.tracers.size();
+    size_t enemyBytes = h.enemyCount * sizeof(Enemy);
+    size_t itemBytes = h.itemCount * sizeof(Cube);
+    size_t tracerBytes = h.tracerCount * sizeof(Tracer);
+    h.bytes = (uint32_t)(sizeof(h) + enemyBytes + itemBytes + tracerBytes);
+
+    out.resize(h.bytes);
+    unsigned char* p = out.data();
+    std::memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+    std::memcpy(p, enemies.enemies.data(), enemyBytes);
+    p += enemyBytes;
+    std::memcpy(p, world.cubes.data(), itemBytes);
+    p += itemBytes;
+    std::memcpy(p, tracerManager.tracers.data(), tracerBytes);
+}
+
+// Restore an image
+bool GameSnapshot::restore(const std::vector<unsigned char>& in, Camera& camera, EnemyManager& enemies, World& world) {
+    SnapshotHeader h;
+    if (in.size() < sizeof(h)) return false;
+    std::memcpy(&h, in.data(), sizeof(h));
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, 4) != 0 || h.version != VERSION || h.bytes != in.size() ||
+        h.bytes != sizeof(h) + h.enemyCount * sizeof(Enemy) + h.itemCount * sizeof(Cube) + h.tracerCount * sizeof(Tracer))
+        return false;
+    if (h.worldHalfSize != world.layout.halfSize || h.worldSeed != world.layout.seed) {
+        std::cerr << "Snapshot belongs to a different world, not restored\n";
+        return false;
+    }
+
+    playerHealth = h.playerHealth;
+    score = h.score;
+    currentAmmo = h.currentAmmo;
+    reserveMags = h.reserveMags;
+    partialMagAmmo = h.partialMagAmmo;
+    pauseKeyPressed = h.pauseKeyPressed != 0;
+    enterpressed = h.enterPressed != 0;
+
+    ws.currentWeapon = h.currentWeapon;
+    for (int i = 0; i < 3; ++i) {
+        ws.weapons[i].reservedMags = h.reservedMags[i];
+        ws.weapons[i].partialAmmo = h.partialAmmo[i];
+        ws.weapons[i].currentAmmo = h.weaponAmmo[i];
+    }
+
+    camera.position = glm::vec3(h.position[0], h.position[1], h.position[2]);
+    camera.yaw = h.yaw;
+    camera.pitch = h.pitch;
+    camera.velocityY = h.velocityY;
+    camera.isOnGround = h.onGround != 0;
+    camera.processMouse(0.0f, 0.0f);   // Rebuild the view vectors from yaw / pitch
+
+    // resize keeps the vectors' capacity, so restoring into a running game does not allocate
+    const unsigned char* p = in.data() + sizeof(h);
+    enemies.enemies.resize(h.enemyCount, Enemy(glm::vec3(0.0f), glm::vec3(0.0f)));
+    std::memcpy(enemies.enemies.data(), p, h.enemyCount * sizeof(Enemy));
+    enemies.markAllChanged();
+    p += h.enemyCount * sizeof(Enemy);
+    world.cubes.resize(h.itemCount);
+    std::memcpy(world.cubes.data(), p, h.itemCount * sizeof(Cube));
+    p += h.itemCount * sizeof(Cube);
+    tracerManager.tracers.resize(h.tracerCount);
+    std::memcpy(tracerManager.tracers.data(), p, h.tracerCount * sizeof(Tracer));
+    return true;
+}
+
+// Write an image to disk
+bool GameSnapshot::save(const std::vector<unsigned char>& image, const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write((const char*)image.data(), image.size())) {
+        std::cerr << "ERROR::SNAPSHOT::CANNOT_WRITE " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Read an image from disk; other versions are rejected
+bool GameSnapshot::load(std::vector<unsigned char>& image, const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    SnapshotHeader h;
+    if (size < (std::streamsize)sizeof(h)) return false;
+
+    image.resize((size_t)size);
+    file.seekg(0);
+    if (!file.read((char*)image.data(), size)) return false;
+    std::memcpy(&h, image.data(), sizeof(h));
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, 4) != 0 || h.version != VERSION || h.bytes != (uint32_t)size) {
+        std::cerr << "Ignoring " << path << " (not a version " << VERSION << " snapshot)\n";
+        image.clear();
+        return false;
+    }
+    return true;
+}
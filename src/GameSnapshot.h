@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Camera;
+class EnemyManager;
+class World;
+
+// Fixed part of a snapshot; the enemy, item and tracer arrays follow it back to back
+// Everything is plain data, so capture and restore are a handful of memcpys
+struct SnapshotHeader {
+    char magic[4];                   // "GSNP"
+    uint32_t version;
+    uint32_t bytes;                  // Total size including the arrays
+    float worldHalfSize;             // World the snapshot belongs to
+    uint32_t worldSeed;
+
+    // Globals from main.cpp
+    int32_t playerHealth, score, currentAmmo, reserveMags, partialMagAmmo;
+    uint8_t pauseKeyPressed, enterPressed, pad[2];
+
+    // WeaponSystem (bullet types are fixed per slot, so only the counters are stored)
+    int32_t currentWeapon;
+    int32_t reservedMags[3], partialAmmo[3], weaponAmmo[3];
+
+    // Camera
+    float position[3];
+    float yaw, pitch, velocityY;
+    uint8_t onGround, pad2[3];
+
+    uint32_t enemyCount, itemCount, tracerCount;
+};
+
+// GameSnapshot captures the complete game state into a versioned binary image and restores it
+// Captures reuse the output buffer, so steady-state saves do not allocate
+class GameSnapshot {
+public:
+    static const uint32_t VERSION = 1;
+
+    // Replace out with an image of the current state
+    static void capture(std::vector<unsigned char>& out, const Camera& camera, const EnemyManager& enemies, const World& world);
+
+    // Restore an image; returns false (and changes nothing) if it is not a valid snapshot for this world
+    static bool restore(const std::vector<unsigned char>& in, Camera& camera, EnemyManager& enemies, World& world);
+
+    // Write / read an image to / from disk; load() rejects other versions
+    static bool save(const std::vector<unsigned char>& image, const std::string& path);
+    static bool load(std::vector<unsigned char>& image, const std::string& path);
+};
@@ -0,0 +1,130 @@
+#include "HeadlessContext.h"
+#include <glad/glad.h>
+#include <iostream>
+#include <cstring>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+
+// From EGL_EXT_platform_base / EGL_MESA_platform_surfaceless (not in every egl.h)
+#define HEADLESS_PLATFORM_SURFACELESS_MESA 0x31DD
+typedef EGLDisplay (*PFN_GetPlatformDisplay)(EGLenum platform, void* nativeDisplay, const EGLint* attribs);
+#endif
+
+// Constructor
+HeadlessContext::HeadlessContext()
+    : display(nullptr), context(nullptr), surface(nullptr), fbo(0), colorBuffer(0), depthBuffer(0) {}
+
+// Destructor: release the framebuffer and the context
+HeadlessContext::~HeadlessContext() {
+#ifdef __linux__
+    if (!context) return;
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface) eglDestroySurface((EGLDisplay)display, (EGLSurface)surface);
+    eglDestroyContext((EGLDisplay)display, (EGLContext)context);
+    eglTerminate((EGLDisplay)display);
+#endif
+}
+
+// GL entry point lookup for gladLoadGLLoader
+void* HeadlessContext::getProcAddress(const char* name) {
+#ifdef __linux__
+    return (void*)eglGetProcAddress(name);
+#else
+    (void)name;
+    return nullptr;
+#endif
+}
+
+// Create the context and framebuffer
+bool HeadlessContext::create(int width, int height) {
+#ifdef __linux__
+    // Surfaceless display if the driver offers it, otherwise the default display with a pbuffer
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    const char* clientExts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFN_GetPlatformDisplay getPlatformDisplay = (PFN_GetPlatformDisplay)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    bool surfaceless = clientExts && std::strstr(clientExts, "EGL_MESA_platform_surfaceless") && getPlatformDisplay;
+    if (surfaceless) dpy = getPlatformDisplay(HEADLESS_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (dpy == EGL_NO_DISPLAY) {
+        surfaceless = false;
+        dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, nullptr, nullptr)) {
+        std::cerr << "ERROR::HEADLESS::NO_EGL_DISPLAY\n";
+        return false;
+    }
+    display = dpy;
+
+    EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(dpy, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        std::cerr << "ERROR::HEADLESS::NO_EGL_CONFIG\n";
+        return false;
+    }
+
+    eglBindAPI(EGL_OPENGL_API);
+    EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, contextAttribs);
+    if (ctx == EGL_NO_CONTEXT) {
+        std::cerr << "ERROR::HEADLESS::CONTEXT_CREATION_FAILED\n";
+        return false;
+    }
+    context = ctx;
+
+    EGLSurface surf = EGL_NO_SURFACE;
+    if (!surfaceless) {
+        EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surf = eglCreatePbufferSurface(dpy, config, pbufferAttribs);
+        surface = surf;
+    }
+    if (!eglMakeCurrent(dpy, surf, surf, ctx)) {
+        std::cerr << "ERROR::HEADLESS::MAKE_CURRENT_FAILED\n";
+        return false;
+    }
+    if (!gladLoadGLLoader((GLADloadproc)getProcAddress)) {
+        std::cerr << "ERROR::HEADLESS::GL_LOAD_FAILED\n";
+        return false;
+    }
+
+    // Window stand-in: color + depth, bound like the default framebuffer would be
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR::HEADLESS::FRAMEBUFFER_INCOMPLETE\n";
+        return false;
+    }
+    glViewport(0, 0, width, height);
+
+    std::cout << "Headless " << (surfaceless ? "surfaceless" : "pbuffer") << " context: "
+              << glGetString(GL_RENDERER) << ", " << width << "x" << height << "\n";
+    return true;
+#else
+    (void)width;
+    (void)height;
+    std::cerr << "ERROR::HEADLESS::EGL_NOT_AVAILABLE (headless rendering needs a Linux build)\n";
+    return false;
+#endif
+}
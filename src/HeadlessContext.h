@@ -0,0 +1,29 @@
+#pragma once
+
+// HeadlessContext creates a GL 3.3 core context without a window, for benchmarks on
+// machines with no display (CI, perf boxes). It uses an EGL surfaceless context
+// (EGL_MESA_platform_surfaceless, works with Mesa llvmpipe) or a 1x1 pbuffer when that
+// is missing, and renders into its own framebuffer object instead of a window.
+// EGL is only available on Linux builds; elsewhere create() fails
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // Create the context and a width x height framebuffer, and make the context current
+    bool create(int width, int height);
+
+    // GL entry point lookup for gladLoadGLLoader
+    static void* getProcAddress(const char* name);
+
+    // Framebuffer that stands in for the window
+    unsigned int getFramebuffer() const { return fbo; }
+
+private:
+    void* display;                   // EGLDisplay
+    void* context;                   // EGLContext
+    void* surface;                   // EGLSurface (pbuffer fallback only)
+    unsigned int fbo;
+    unsigned int colorBuffer;
+    unsigned int depthBuffer;
+};
@@ -0,0 +1,22 @@
+#include "InputQueue.h"
+
+// Producer: append an event; returns false if the queue is full
+bool InputQueue::push(const InputEvent& e) {
+    unsigned int t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) >= CAPACITY) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    events[t & (CAPACITY - 1)] = e;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+// Consumer: take the oldest event; returns false if the queue is empty
+bool InputQueue::pop(InputEvent& e) {
+    unsigned int h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return false;
+    e = events[h & (CAPACITY - 1)];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+
+// Kinds of buffered input events
+enum class InputEventType : unsigned char {
+    MOUSE_MOVE,       // Relative mouse motion (dx, dy)
+    BUTTON_PRESS,     // Mouse button pressed
+    BUTTON_RELEASE    // Mouse button released
+};
+
+// One input event with the time it was received (glfwGetTime seconds)
+struct InputEvent {
+    InputEventType type;
+    int button;       // GLFW mouse button (press / release)
+    float dx, dy;     // Motion (mouse move)
+    double time;
+};
+
+// InputQueue is a lock-free single-producer / single-consumer ring of input events
+// GLFW callbacks push, the frame's input gathering pops; neither side ever blocks.
+// If the consumer falls behind by CAPACITY events, new events are dropped and counted
+class InputQueue {
+public:
+    static const unsigned int CAPACITY = 4096;   // Must be a power of two
+
+    // Producer: append an event; returns false if the queue is full
+    bool push(const InputEvent& e);
+
+    // Consumer: take the oldest event; returns false if the queue is empty
+    bool pop(InputEvent& e);
+
+    // Events dropped because the queue was full
+    int getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    InputEvent events[CAPACITY];
+    std::atomic<unsigned int> head{0};   // Next slot to read (consumer)
+    std::atomic<unsigned int> tail{0};   // Next slot to write (producer)
+    std::atomic<int> dropped{0};
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+
+// Bit-level packet writer over a fixed buffer, LSB first; writes past the end are dropped and flagged
+class BitWriter {
+public:
+    BitWriter(void* buffer, int capacityBytes) : data((uint8_t*)buffer), capacity(capacityBytes), bitPos(0), overflow(false) {}
+
+    // Write the low `bits` bits of value (bits <= 32)
+    void write(uint32_t value, int bits) {
+        if (bitPos + bits > capacity * 8) { overflow = true; return; }
+        while (bits > 0) {
+            int byte = bitPos >> 3;
+            int offset = bitPos & 7;
+            int n = bits < 8 - offset ? bits : 8 - offset;
+            if (offset == 0) data[byte] = 0;
+            data[byte] |= (uint8_t)((value & ((1u << n) - 1)) << offset);
+            value >>= n;
+            bits -= n;
+            bitPos += n;
+        }
+    }
+
+    void writeBool(bool value) { write(value ? 1 : 0, 1); }
+
+    // Signed value in `bits` bits (two's complement)
+    void writeSigned(int32_t value, int bits) { write((uint32_t)value, bits); }
+
+    // Drop everything written after a position returned by getBitCount()
+    void rewind(int position) {
+        bitPos = position;
+        if (bitPos & 7) data[bitPos >> 3] &= (uint8_t)((1u << (bitPos & 7)) - 1);
+        overflow = false;
+    }
+
+    int getBitCount() const { return bitPos; }
+    int getByteCount() const { return (bitPos + 7) >> 3; }
+    bool hasOverflowed() const { return overflow; }
+
+private:
+    uint8_t* data;
+    int capacity;
+    int bitPos;
+    bool overflow;
+};
+
+// Bit-level packet reader matching BitWriter; reads past the end return zeros and flag the stream as bad
+class BitReader {
+public:
+    BitReader(const void* buffer, int sizeBytes) : data((const uint8_t*)buffer), size(sizeBytes), bitPos(0), bad(false) {}
+
+    uint32_t read(int bits) {
+        if (bitPos + bits > size * 8) { bad = true; return 0; }
+        uint32_t value = 0;
+        int shift = 0;
+        while (bits > 0) {
+            int offset = bitPos & 7;
+            int n = bits < 8 - offset ? bits : 8 - offset;
+            value |= (uint32_t)((data[bitPos >> 3] >> offset) & ((1u << n) - 1)) << shift;
+            shift += n;
+            bits -= n;
+            bitPos += n;
+        }
+        return value;
+    }
+
+    bool readBool() { return read(1) != 0; }
+
+    int32_t readSigned(int bits) {
+        uint32_t value = read(bits);
+        if (bits < 32 && (value & (1u << (bits - 1)))) value |= ~0u << bits;   // Sign-extend
+        return (int32_t)value;
+    }
+
+    bool isBad() const { return bad; }
+
+private:
+    const uint8_t* data;
+    int size;
+    int bitPos;
+    bool bad;
+};
@@ -0,0 +1,96 @@
+#include "ClientPrediction.h"
+#include "PlayerMove.h"
+#include "../World.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+ClientPrediction::ClientPrediction() : lastDebug(std::chrono::steady_clock::now()) {}
+
+// Start from a camera (position, bounds); drops all pending commands
+void ClientPrediction::reset(const Camera& camera) {
+    body.position = camera.position;
+    body.velocityY = camera.velocityY;
+    body.isOnGround = camera.isOnGround;
+    body.boundsLimit = camera.boundsLimit;
+    body.setAngles(camera.yaw, camera.pitch);
+    newestSeq = 0;
+    ackedSeq = 0;
+    previousPosition = body.position;
+    errorOffset = glm::vec3(0.0f);
+}
+
+ClientPrediction::PredictedState ClientPrediction::capture() const {
+    return { body.position, body.velocityY, body.isOnGround };
+}
+
+// Run a command locally right after it was sent
+void ClientPrediction::predict(const PlayerCommand& cmd, const World& world) {
+    previousPosition = body.position;
+    PlayerMove::move(body, cmd, world);
+    commands[cmd.seq % BUFFER] = cmd;
+    states[cmd.seq % BUFFER] = capture();
+    newestSeq = cmd.seq;
+}
+
+// Server state after command ackSeq: rewind to it and replay the commands after it
+void ClientPrediction::reconcile(uint32_t ackSeq, const NetPlayerState& server, const World& world) {
+    if (ackSeq > newestSeq || ackSeq < ackedSeq) return;   // Before a reset, or an older snapshot
+
+    // How far off the prediction for the acknowledged command was
+    bool tracked = newestSeq - ackSeq < (uint32_t)BUFFER;
+    if (ackSeq > ackedSeq && ackSeq > 0 && tracked) {
+        float error = glm::distance(states[ackSeq % BUFFER].position, server.position);
+        if (error > 1e-3f) {
+            corrections++;
+            maxError = std::max(maxError, error);
+        }
+    }
+    ackedSeq = ackSeq;
+
+    glm::vec3 before = body.position;
+    body.position = server.position;
+    body.velocityY = server.velocityY;
+    body.isOnGround = server.onGround != 0;
+
+    if (!tracked) {
+        // Too far behind to replay: take the server's word
+        ackedSeq = newestSeq;
+        previousPosition = body.position;
+    } else if (ackSeq == newestSeq) {
+        previousPosition += body.position - before;
+    } else {
+        for (uint32_t seq = ackSeq + 1; seq <= newestSeq; ++seq) {
+            if (seq == newestSeq) previousPosition = body.position;
+            PlayerMove::move(body, commands[seq % BUFFER], world);
+            states[seq % BUFFER] = capture();
+            replayed++;
+        }
+    }
+
+    // Show the correction gradually, unless it is a teleport (respawn)
+    glm::vec3 jump = before - body.position;
+    if (glm::length(jump) > SNAP_DISTANCE) errorOffset = glm::vec3(0.0f);
+    else errorOffset += jump;
+
+    // Debug output every 2 seconds
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - lastDebug).count() > 2.0f) {
+        if (verbose) std::cout << "[DEBUG] Prediction: " << getPendingCount() << " commands in flight, " << corrections
+                  << " corrections (max " << maxError << "), " << replayed << " commands replayed\n";
+        corrections = 0;
+        replayed = 0;
+        maxError = 0.0f;
+        lastDebug = now;
+    }
+}
+
+// Decay the visual correction
+void ClientPrediction::update(float deltaTime) {
+    errorOffset *= std::exp(-SMOOTHING * deltaTime);
+    if (glm::dot(errorOffset, errorOffset) < 1e-8f) errorOffset = glm::vec3(0.0f);
+}
+
+glm::vec3 ClientPrediction::getRenderPosition(float alpha) const {
+    return glm::mix(previousPosition, body.position, glm::clamp(alpha, 0.0f, 1.0f)) + errorOffset;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Protocol.h"
+#include "../Camera.h"
+
+class World;
+
+// ClientPrediction moves the local player the moment a command is sent instead of a round trip later
+// Every command runs through PlayerMove::move locally and is kept, with the state it produced,
+// until the server acknowledges it. On each snapshot the player is rewound to the server's state
+// after the acknowledged command and the newer commands are replayed. Any visual jump that
+// causes is kept as an offset that decays over a few frames.
+class ClientPrediction {
+public:
+    static const int BUFFER = 128;             // Commands in flight (about 2 s at 60 Hz)
+    static constexpr float SMOOTHING = 12.0f;  // Correction decay rate (1/s)
+    static constexpr float SNAP_DISTANCE = 2.0f;   // Larger corrections (respawns) are not smoothed
+
+    ClientPrediction();
+
+    // Start from a camera (position, bounds); drops all pending commands
+    void reset(const Camera& camera);
+
+    // Run a command locally right after it was sent
+    void predict(const PlayerCommand& cmd, const World& world);
+
+    // Server state after command ackSeq: rewind to it and replay the commands after it
+    void reconcile(uint32_t ackSeq, const NetPlayerState& server, const World& world);
+
+    // Decay the visual correction
+    void update(float deltaTime);
+
+    // Position to draw: between the last two predicted steps (alpha = fraction of the
+    // next step already elapsed), plus the decaying correction
+    glm::vec3 getRenderPosition(float alpha) const;
+
+    const Camera& getCamera() const { return body; }
+
+    // Print the 2 second debug line (on by default; load test bots turn it off)
+    void setVerbose(bool on) { verbose = on; }
+    int getPendingCount() const { return (int)(newestSeq - ackedSeq); }
+
+private:
+    struct PredictedState {
+        glm::vec3 position;
+        float velocityY;
+        bool onGround;
+    };
+
+    Camera body;                               // Predicted player (only the movement state is used)
+    PlayerCommand commands[BUFFER];            // By seq % BUFFER
+    PredictedState states[BUFFER];             // State after each command
+    uint32_t newestSeq = 0;
+    uint32_t ackedSeq = 0;
+    glm::vec3 previousPosition = glm::vec3(0.0f);   // Before the newest command
+    glm::vec3 errorOffset = glm::vec3(0.0f);
+
+    // Stats for the debug line
+    bool verbose = true;
+    int corrections = 0;
+    int replayed = 0;
+    float maxError = 0.0f;
+    std::chrono::steady_clock::time_point lastDebug;
+
+    PredictedState capture() const;
+};
@@ -0,0 +1,204 @@
+#include "NetClient.h"
+#include "../Enemy.h"
+#include "../World.h"
+#include <iostream>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+NetClient::NetClient() : lastHeard(Clock::now()) {}
+
+NetClient::~NetClient() {
+    disconnect();
+}
+
+// Blocking handshake: CONNECT is resent every 250 ms until ACCEPT, REJECT or the timeout
+bool NetClient::connect(const NetAddress& address, float timeoutSeconds, WorldLayout& layout) {
+    if (!socket.open(0)) return false;
+    server = address;
+
+    auto start = Clock::now();
+    auto lastSend = start - std::chrono::seconds(1);
+    uint8_t buffer[Protocol::MAX_PACKET];
+    while (std::chrono::duration<float>(Clock::now() - start).count() < timeoutSeconds) {
+        if (Clock::now() - lastSend > std::chrono::milliseconds(250)) {
+            PacketWriter w(buffer, sizeof(buffer));
+            Protocol::writeHeader(w, MessageType::CONNECT);
+            socket.sendTo(server, buffer, w.getSize());
+            lastSend = Clock::now();
+        }
+
+        NetAddress from;
+        int bytes;
+        while ((bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+            if (from != server) continue;
+            PacketReader r(buffer, bytes);
+            MessageType type;
+            if (!Protocol::readHeader(r, type)) continue;
+            if (type == MessageType::REJECT) {
+                std::cerr << "ERROR::NET::SERVER_FULL " << server.toString() << "\n";
+                socket.close();
+                return false;
+            }
+            if (type != MessageType::ACCEPT) continue;
+            playerId = r.read<uint16_t>();
+            serverTick = r.read<uint32_t>();
+            layout = Protocol::readLayout(r);
+            if (r.isBad()) continue;
+            limit = layout.halfSize;
+
+            connected = true;
+            lastHeard = Clock::now();
+            if (verbose) std::cout << "Connected to " << server.toString() << " as player " << (int)playerId << "\n";
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::cerr << "ERROR::NET::CONNECT_TIMEOUT " << server.toString() << "\n";
+    socket.close();
+    return false;
+}
+
+void NetClient::disconnect() {
+    if (!connected) return;
+    uint8_t buffer[16];
+    PacketWriter w(buffer, sizeof(buffer));
+    Protocol::writeHeader(w, MessageType::DISCONNECT);
+    socket.sendTo(server, buffer, w.getSize());
+    socket.close();
+    connected = false;
+}
+
+bool NetClient::hasTimedOut() const {
+    return connected && std::chrono::duration<float>(Clock::now() - lastHeard).count() > Protocol::TIMEOUT_SECONDS;
+}
+
+// Send the next command together with the previous ones (newest last)
+uint32_t NetClient::sendCommand(PlayerCommand cmd) {
+    cmd.seq = nextSeq++;
+    if (recentCount == Protocol::INPUT_REDUNDANCY) {
+        for (int i = 1; i < recentCount; ++i) recent[i - 1] = recent[i];
+        recentCount--;
+    }
+    recent[recentCount++] = cmd;
+
+    uint8_t buffer[128];
+    PacketWriter w(buffer, sizeof(buffer));
+    Protocol::writeHeader(w, MessageType::INPUT);
+    w.write(completeTick);
+    w.write((uint8_t)recentCount);
+    for (int i = 0; i < recentCount; ++i) Protocol::writeCommand(w, recent[i]);
+    socket.sendTo(server, buffer, w.getSize());
+    stats.packetsOut++;
+    stats.bytesOut += w.getSize();
+    return cmd.seq;
+}
+
+// Receive everything waiting; true if newer state arrived
+bool NetClient::poll() {
+    if (!connected) return false;
+    uint32_t before = serverTick;
+    uint32_t completeBefore = completeTick;
+    uint8_t buffer[Protocol::MAX_PACKET];
+    NetAddress from;
+    int bytes;
+    while ((bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+        if (from != server) continue;
+        PacketReader r(buffer, bytes);
+        MessageType type;
+        if (!Protocol::readHeader(r, type)) continue;
+        lastHeard = Clock::now();
+        stats.packetsIn++;
+        stats.bytesIn += bytes;
+        if (type == MessageType::SNAPSHOT) readSnapshot(r);
+        else if (type == MessageType::DISCONNECT) {
+            std::cout << "Server closed the connection\n";
+            socket.close();
+            connected = false;
+            return false;
+        }
+    }
+    return serverTick != before || completeTick != completeBefore;
+}
+
+// A complete snapshot still in the ring, or null
+const NetClient::SnapshotRecord* NetClient::findSnapshot(uint32_t tick) const {
+    const SnapshotRecord& rec = history[(tick / Protocol::SNAPSHOT_INTERVAL) % Protocol::SNAPSHOT_HISTORY];
+    return tick != 0 && rec.tick == tick ? &rec : nullptr;
+}
+
+// Take one snapshot packet if it is newer than what we have and its baseline is still kept
+void NetClient::readSnapshot(PacketReader& r) {
+    uint32_t tick = r.read<uint32_t>();
+    uint32_t baseline = r.read<uint32_t>();
+    uint32_t ack = r.read<uint32_t>();
+    uint8_t items = r.read<uint8_t>();
+    NetPlayerState state = Protocol::readPlayerState(r);
+    int total = r.read<uint16_t>();
+    int remoteCount = r.read<uint8_t>();
+    if (r.isBad() || tick <= serverTick || remoteCount > Protocol::MAX_REMOTE_PLAYERS) return;
+    const SnapshotRecord* base = nullptr;
+    if (baseline != 0 && !(base = findSnapshot(baseline))) return;
+
+    BitReader bits(r.getCurrent(), r.getRemaining());
+    NetRemotePlayer incoming[Protocol::MAX_REMOTE_PLAYERS];
+    for (int i = 0; i < remoteCount; ++i) incoming[i] = SnapshotCodec::readRemotePlayer(bits, limit);
+    if (!SnapshotCodec::readView(bits, base ? base->enemies.data() : nullptr, base ? (int)base->enemies.size() : 0,
+                                 total, decoded)) return;
+
+    serverTick = tick;
+    ackSeq = ack;
+    itemsMask = items;
+    self = state;
+    remotes.assign(incoming, incoming + remoteCount);
+
+    // Hide the enemies of the view shown so far, then show the new one
+    enemyStates.resize(total);
+    if (const SnapshotRecord* shown = findSnapshot(completeTick)) {
+        for (const ViewEnemy& v : shown->enemies) {
+            if (v.index < total) enemyStates[v.index].flags = 0;
+        }
+    }
+    SnapshotRecord& rec = history[(tick / Protocol::SNAPSHOT_INTERVAL) % Protocol::SNAPSHOT_HISTORY];
+    rec.enemies.swap(decoded);
+    rec.tick = tick;
+    if (completeTick != 0) stats.snapshotsLost += (int)((tick - completeTick) / Protocol::SNAPSHOT_INTERVAL) - 1;
+    stats.snapshots++;
+    completeTick = tick;
+    for (const ViewEnemy& v : rec.enemies) enemyStates[v.index] = SnapshotCodec::dequantizeEnemy(v.q, limit);
+}
+
+// Copy replicated enemies into the local manager (only for drawing; the AI runs on the server)
+void NetClient::applyEnemyStates(const std::vector<NetEnemy>& states, EnemyManager& enemies) {
+    if (enemies.enemies.size() != states.size()) {
+        enemies.clear();
+        for (size_t i = 0; i < states.size(); ++i) enemies.spawn(glm::vec3(0.0f), glm::vec3(0.0f));
+    }
+    for (size_t i = 0; i < states.size(); ++i) {
+        const NetEnemy& n = states[i];
+        Enemy& e = enemies.enemies[i];
+        e.position = n.position;
+        e.color = glm::vec3(n.color[0], n.color[1], n.color[2]) / 255.0f;
+        e.health = n.health;
+        e.alive = (n.flags & ENEMY_ALIVE) != 0;
+        e.chasing = (n.flags & ENEMY_CHASING) != 0;
+    }
+    enemies.markAllChanged();
+}
+
+// Bring the item set in line with the server's mask
+void NetClient::applyItemsMask(uint8_t itemsMask, World& world) {
+    uint8_t present = 0;
+    for (const Cube& c : world.cubes) {
+        if (c.isItem && c.id >= 1 && c.id <= 8) present |= (uint8_t)(1 << (c.id - 1));
+    }
+    if (present == itemsMask) return;
+
+    // Items only ever come back all together, so anything missing means a regeneration
+    if (itemsMask & ~present) world.regenerateItems();
+    for (auto it = world.cubes.begin(); it != world.cubes.end();) {
+        if (it->isItem && !(itemsMask & (1 << (it->id - 1)))) it = world.cubes.erase(it);
+        else ++it;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "Socket.h"
+#include "Protocol.h"
+#include "SnapshotCodec.h"
+
+class EnemyManager;
+class World;
+
+// NetClient is the game's connection to a dedicated server
+// Commands go out with the last few repeated (lost packets cost nothing); each snapshot
+// is one packet and replaces the latest state here. It carries only the enemies near the
+// player (the view), delta coded against the view of a snapshot this client acknowledged,
+// so recent views are kept as baselines and the newest is acknowledged with every input.
+// Enemies outside the view are hidden.
+class NetClient {
+public:
+    NetClient();
+    ~NetClient();
+
+    // Blocking handshake; on success layout holds the server's world
+    bool connect(const NetAddress& server, float timeoutSeconds, WorldLayout& layout);
+
+    // Tell the server we are leaving and close the socket
+    void disconnect();
+
+    bool isConnected() const { return connected; }
+
+    // Log connection events (on by default; load test bots turn it off)
+    void setVerbose(bool on) { verbose = on; }
+
+    // True when the server has been silent for Protocol::TIMEOUT_SECONDS
+    bool hasTimedOut() const;
+
+    // Send the next command (its seq is assigned here) together with the previous ones
+    uint32_t sendCommand(PlayerCommand cmd);
+
+    // Receive everything waiting; true if newer state arrived
+    bool poll();
+
+    // Latest authoritative state
+    const NetPlayerState& getSelf() const { return self; }
+    const std::vector<NetRemotePlayer>& getRemotes() const { return remotes; }
+    const std::vector<NetEnemy>& getEnemies() const { return enemyStates; }
+    uint32_t getServerTick() const { return serverTick; }
+    uint32_t getViewTick() const { return completeTick; }   // Snapshot the enemies on screen come from
+    uint32_t getAckSeq() const { return ackSeq; }
+    uint8_t getItemsMask() const { return itemsMask; }
+    uint16_t getPlayerId() const { return playerId; }
+
+    // Traffic since connect; snapshots that never arrived (or came after a newer one) count as lost
+    struct Stats {
+        long long packetsIn = 0, bytesIn = 0, packetsOut = 0, bytesOut = 0;
+        int snapshots = 0, snapshotsLost = 0;
+    };
+    const Stats& getStats() const { return stats; }
+
+    // Copy the replicated enemies / item set into the local game objects for drawing
+    void applyEnemies(EnemyManager& enemies) const { applyEnemyStates(enemyStates, enemies); }
+    void applyItems(World& world) const { applyItemsMask(itemsMask, world); }
+
+    // The same for state decoded elsewhere (SpectatorClient)
+    static void applyEnemyStates(const std::vector<NetEnemy>& states, EnemyManager& enemies);
+    static void applyItemsMask(uint8_t mask, World& world);
+
+private:
+    UdpSocket socket;
+    NetAddress server;
+    bool connected = false;
+    bool verbose = true;
+    uint16_t playerId = 0;
+    std::chrono::steady_clock::time_point lastHeard;
+    Stats stats;
+
+    // Most recent commands, resent with every input packet
+    PlayerCommand recent[Protocol::INPUT_REDUNDANCY];
+    int recentCount = 0;
+    uint32_t nextSeq = 1;
+
+    float limit = 20.0f;            // Quantization range (the server's arena half size)
+
+    uint32_t serverTick = 0;
+    uint32_t ackSeq = 0;
+    uint8_t itemsMask = 0;
+    NetPlayerState self;
+    std::vector<NetRemotePlayer> remotes;
+    std::vector<NetEnemy> enemyStates;
+
+    // Enemy views of recent snapshots by (tick / SNAPSHOT_INTERVAL), kept as delta baselines
+    struct SnapshotRecord {
+        uint32_t tick = 0;
+        std::vector<ViewEnemy> enemies;
+    };
+    SnapshotRecord history[Protocol::SNAPSHOT_HISTORY];
+    uint32_t completeTick = 0;      // Newest decoded snapshot
+    std::vector<ViewEnemy> decoded; // Scratch for the view being read
+
+    const SnapshotRecord* findSnapshot(uint32_t tick) const;
+
+    void readSnapshot(PacketReader& r);
+};
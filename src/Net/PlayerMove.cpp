@@ -0,0 +1,32 @@
+#include "PlayerMove.h"
+
+// Weapons first, as in the single-player applyInput; they do not affect movement
+void PlayerMove::apply(Camera& camera, WeaponSystem& weapons, const PlayerCommand& cmd, const World& world) {
+    applyWeapons(weapons, cmd);
+    move(camera, cmd, world);
+}
+
+void PlayerMove::applyWeapons(WeaponSystem& weapons, const PlayerCommand& cmd) {
+    if (cmd.weaponSlot >= 0) weapons.switchWeapon(cmd.weaponSlot);
+    if (cmd.buttons & CMD_RELOAD) weapons.reloadCurrent();
+}
+
+// Same order as the single-player applyInput, followed by physics and collision
+void PlayerMove::move(Camera& camera, const PlayerCommand& cmd, const World& world) {
+    const float dt = Protocol::TICK_STEP;
+    camera.setAngles(cmd.yaw, cmd.pitch);
+
+    // Camera::jump() logs every jump; a server with many players should not
+    if ((cmd.buttons & CMD_JUMP) && camera.isOnGround) {
+        camera.velocityY = camera.JUMP_FORCE;
+        camera.isOnGround = false;
+    }
+
+    if (cmd.buttons & CMD_FORWARD) camera.processKeyboard(0, dt);
+    if (cmd.buttons & CMD_BACK) camera.processKeyboard(1, dt);
+    if (cmd.buttons & CMD_LEFT) camera.processKeyboard(2, dt);
+    if (cmd.buttons & CMD_RIGHT) camera.processKeyboard(3, dt);
+
+    camera.physics(dt);
+    world.resolveCollision(camera.position, 0.4f, 1.5f);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "Protocol.h"
+#include "../Camera.h"
+#include "../WeaponSystem.h"
+#include "../World.h"
+
+// PlayerMove advances one player by one PlayerCommand (exactly Protocol::TICK_STEP seconds)
+// The server runs it authoritatively and clients run the same code to predict, so the result
+// depends only on the previous state, the command and the static world
+namespace PlayerMove {
+    // Look, weapon switch / reload, walk, jump, gravity and collision
+    void apply(Camera& camera, WeaponSystem& weapons, const PlayerCommand& cmd, const World& world);
+
+    // The weapon part alone: switch, then reload
+    void applyWeapons(WeaponSystem& weapons, const PlayerCommand& cmd);
+
+    // The movement part alone (client prediction replays only this)
+    void move(Camera& camera, const PlayerCommand& cmd, const World& world);
+}
@@ -0,0 +1,77 @@
+#include "Protocol.h"
+
+void Protocol::writeHeader(PacketWriter& w, MessageType type) {
+    w.write(PROTOCOL_ID);
+    w.write((uint8_t)type);
+}
+
+// Reads and checks the header; false if the datagram is not ours
+bool Protocol::readHeader(PacketReader& r, MessageType& type) {
+    uint32_t id = r.read<uint32_t>();
+    uint8_t t = r.read<uint8_t>();
+    if (r.isBad() || id != PROTOCOL_ID || t > (uint8_t)MessageType::SPECTATE_CHALLENGE) return false;
+    type = (MessageType)t;
+    return true;
+}
+
+void Protocol::writeCommand(PacketWriter& w, const PlayerCommand& c) {
+    w.write(c.seq);
+    w.write(c.buttons);
+    w.write(c.weaponSlot);
+    w.write(c.yaw);
+    w.write(c.pitch);
+    w.write(c.viewTick);
+}
+
+PlayerCommand Protocol::readCommand(PacketReader& r) {
+    PlayerCommand c;
+    c.seq = r.read<uint32_t>();
+    c.buttons = r.read<uint8_t>();
+    c.weaponSlot = r.read<int8_t>();
+    c.yaw = r.read<float>();
+    c.pitch = r.read<float>();
+    c.viewTick = r.read<uint32_t>();
+    return c;
+}
+
+void Protocol::writeLayout(PacketWriter& w, const WorldLayout& layout) {
+    w.write(layout.halfSize);
+    w.write(layout.height);
+    w.write(layout.pillarDensity);
+    w.write(layout.seed);
+}
+
+WorldLayout Protocol::readLayout(PacketReader& r) {
+    WorldLayout layout;
+    layout.halfSize = r.read<float>();
+    layout.height = r.read<float>();
+    layout.pillarDensity = r.read<float>();
+    layout.seed = r.read<uint32_t>();
+    return layout;
+}
+
+void Protocol::writePlayerState(PacketWriter& w, const NetPlayerState& s) {
+    w.write(s.position);
+    w.write(s.velocityY);
+    w.write(s.onGround);
+    w.write(s.health);
+    w.write(s.score);
+    w.write(s.currentWeapon);
+    w.write(s.ammo);
+    w.write(s.mags);
+    w.write(s.partial);
+}
+
+NetPlayerState Protocol::readPlayerState(PacketReader& r) {
+    NetPlayerState s;
+    s.position = r.read<glm::vec3>();
+    s.velocityY = r.read<float>();
+    s.onGround = r.read<uint8_t>();
+    s.health = r.read<int16_t>();
+    s.score = r.read<int32_t>();
+    s.currentWeapon = r.read<int8_t>();
+    r.readBytes(s.ammo, sizeof(s.ammo));
+    r.readBytes(s.mags, sizeof(s.mags));
+    r.readBytes(s.partial, sizeof(s.partial));
+    return s;
+}
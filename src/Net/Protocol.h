@@ -0,0 +1,175 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+#include "../Chunk.h"
+
+// Wire protocol shared by the dedicated server, the game client and tools
+// Every datagram starts with PROTOCOL_ID and a MessageType byte; values are little-endian
+namespace Protocol {
+    const uint32_t PROTOCOL_ID = 0x544E4853;   // "SHNT"
+    const uint16_t DEFAULT_PORT = 27015;
+    const int MAX_PACKET = 1200;               // Stay under a typical path MTU
+    const int TICK_RATE = 60;                  // Server simulation steps per second
+    const float TICK_STEP = 1.0f / TICK_RATE;  // Every player command advances exactly one step
+    const int SNAPSHOT_INTERVAL = 3;           // Ticks between snapshots (20 Hz)
+    const int SNAPSHOT_HISTORY = 32;           // Snapshots kept on both ends as delta baselines
+    const int MAX_PLAYERS = 512;
+    const int PLAYER_ID_BITS = 9;
+    const int MAX_REMOTE_PLAYERS = 31;         // Nearest other players in each snapshot
+    const int INPUT_REDUNDANCY = 4;            // Recent commands repeated in every input packet
+    const float TIMEOUT_SECONDS = 5.0f;        // Silence before a peer is dropped
+    const uint16_t DEFAULT_RELAY_PORT = 27500; // Spectators connect to a relay here
+    const int MAX_RELAYS = 4;                  // Broadcast subscribers per server (loopback only)
+    const int BROADCAST_CHUNK = 64;            // Enemies (or players) per broadcast packet
+    const int BROADCAST_KEYFRAME_INTERVAL = 20;   // Broadcast frames between full copies of a chunk (1 s)
+}
+
+enum class MessageType : uint8_t {
+    CONNECT,       // Client -> server: join request
+    ACCEPT,        // Server -> client: player id, tick and world layout
+    REJECT,        // Server -> client: server full
+    INPUT,         // Client -> server: last complete snapshot and the last few player commands
+    SNAPSHOT,      // Server -> client: authoritative state, delta coded (one packet)
+    DISCONNECT,    // Either way: leaving
+    RELAY_CONNECT, // Relay -> server: subscribe to the broadcast (repeated as keep-alive)
+    RELAY_ACCEPT,  // Server -> relay: tick and world layout
+    BROADCAST,     // Server -> relay -> spectators: one chunk of a broadcast frame, the same for everyone
+    SPECTATE,      // Spectator -> relay: the relay's cookie for this address, 0 before it has one (repeated as keep-alive)
+    SPECTATE_ACCEPT, // Relay -> spectator: world layout and playback delay
+    SPECTATE_CHALLENGE // Relay -> spectator: cookie to echo in SPECTATE (proves the address is real)
+};
+
+// What one BROADCAST packet carries (after the tick)
+enum class BroadcastKind : uint8_t {
+    PLAYERS,       // Items mask, total, first, count, then count players in full
+    ENEMIES        // Base tick (0 = full), total, first, count, then count enemies against the base frame
+};
+
+// Buttons held during one command
+enum CommandButtons : uint8_t {
+    CMD_FORWARD = 1 << 0,
+    CMD_BACK    = 1 << 1,
+    CMD_LEFT    = 1 << 2,
+    CMD_RIGHT   = 1 << 3,
+    CMD_JUMP    = 1 << 4,
+    CMD_FIRE    = 1 << 5,   // One shot along yaw / pitch this step
+    CMD_RELOAD  = 1 << 6
+};
+
+// One fixed step of player input; the server applies each command exactly once, in seq order
+struct PlayerCommand {
+    uint32_t seq = 0;         // Increases by one per command
+    uint8_t buttons = 0;      // CommandButtons
+    int8_t weaponSlot = -1;   // Weapon to switch to (-1 = none)
+    float yaw = -90.0f;       // View angles are owned by the client (degrees)
+    float pitch = 0.0f;
+    uint32_t viewTick = 0;    // Newest snapshot the client was showing (lag compensated shots)
+};
+
+// Authoritative state of the player a snapshot is addressed to
+struct NetPlayerState {
+    glm::vec3 position = glm::vec3(0.0f);
+    float velocityY = 0.0f;
+    uint8_t onGround = 0;
+    int16_t health = 100;
+    int32_t score = 0;
+    int8_t currentWeapon = 2;
+    int16_t ammo[3] = {};
+    int16_t mags[3] = {};
+    int16_t partial[3] = {};
+};
+
+// Another player, as seen by everyone else
+struct NetRemotePlayer {
+    uint16_t id = 0;
+    glm::vec3 position = glm::vec3(0.0f);
+    float yaw = 0.0f, pitch = 0.0f;
+    int16_t health = 0;
+};
+
+// Enemy flags on the wire
+enum EnemyFlags : uint8_t {
+    ENEMY_ALIVE   = 1 << 0,
+    ENEMY_CHASING = 1 << 1,
+    ENEMY_DEAD    = 1 << 2    // Killed (drawn black, harmless)
+};
+
+// One enemy as the client sees it (decoded from a QuantizedEnemy)
+struct NetEnemy {
+    glm::vec3 position = glm::vec3(0.0f);
+    uint8_t color[3] = {};
+    uint8_t flags = 0;
+    int16_t health = 0;
+};
+
+// Byte-aligned packet writer over a fixed buffer; writes past the end are dropped and flagged
+class PacketWriter {
+public:
+    PacketWriter(void* buffer, int capacity) : data((uint8_t*)buffer), capacity(capacity), size(0), overflow(false) {}
+
+    template <class T>
+    void write(const T& value) { writeBytes(&value, sizeof(T)); }
+
+    void writeBytes(const void* src, int bytes) {
+        if (size + bytes > capacity) { overflow = true; return; }
+        std::memcpy(data + size, src, bytes);
+        size += bytes;
+    }
+
+    int getSize() const { return size; }
+    int getRemaining() const { return capacity - size; }
+    bool hasOverflowed() const { return overflow; }
+
+private:
+    uint8_t* data;
+    int capacity;
+    int size;
+    bool overflow;
+};
+
+// Byte-aligned packet reader; reads past the end return zeros and flag the packet as bad
+class PacketReader {
+public:
+    PacketReader(const void* buffer, int size) : data((const uint8_t*)buffer), size(size), pos(0), bad(false) {}
+
+    template <class T>
+    T read() {
+        T value{};
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    void readBytes(void* dst, int bytes) {
+        if (pos + bytes > size) { bad = true; std::memset(dst, 0, bytes); return; }
+        std::memcpy(dst, data + pos, bytes);
+        pos += bytes;
+    }
+
+    int getRemaining() const { return size - pos; }
+    const uint8_t* getCurrent() const { return data + pos; }   // Unread bytes (e.g. for a BitReader)
+    bool isBad() const { return bad; }
+
+private:
+    const uint8_t* data;
+    int size;
+    int pos;
+    bool bad;
+};
+
+// Message encoding helpers
+namespace Protocol {
+    void writeHeader(PacketWriter& w, MessageType type);
+
+    // Reads and checks the header; false if the datagram is not ours
+    bool readHeader(PacketReader& r, MessageType& type);
+
+    void writeCommand(PacketWriter& w, const PlayerCommand& c);
+    PlayerCommand readCommand(PacketReader& r);
+
+    void writeLayout(PacketWriter& w, const WorldLayout& layout);
+    WorldLayout readLayout(PacketReader& r);
+
+    void writePlayerState(PacketWriter& w, const NetPlayerState& s);
+    NetPlayerState readPlayerState(PacketReader& r);
+}
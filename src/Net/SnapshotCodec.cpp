@@ -0,0 +1,165 @@
+#include "SnapshotCodec.h"
+#include "../Enemy.h"
+#include <algorithm>
+#include <cmath>
+
+uint16_t SnapshotCodec::quantize(float v, float limit) {
+    float t = (v + limit) / (2.0f * limit);
+    return (uint16_t)std::lround(std::min(std::max(t, 0.0f), 1.0f) * 65535.0f);
+}
+
+float SnapshotCodec::dequantize(uint16_t q, float limit) {
+    return q / 65535.0f * 2.0f * limit - limit;
+}
+
+QuantizedEnemy SnapshotCodec::quantizeEnemy(const Enemy& e, float limit) {
+    QuantizedEnemy q;
+    for (int a = 0; a < 3; ++a) {
+        q.pos[a] = quantize(e.position[a], limit);
+        q.color[a] = (uint8_t)std::lround(std::min(std::max(e.color[a], 0.0f), 1.0f) * 255.0f);
+    }
+    q.health = (uint8_t)std::lround(std::min(std::max(e.health, 0.0f), 127.0f));
+    bool dead = e.color == glm::vec3(0.0f);
+    q.flags = (e.alive ? ENEMY_ALIVE : 0) | (e.chasing ? ENEMY_CHASING : 0) | (dead ? ENEMY_DEAD : 0);
+    return q;
+}
+
+NetEnemy SnapshotCodec::dequantizeEnemy(const QuantizedEnemy& q, float limit) {
+    NetEnemy n;
+    n.position = glm::vec3(dequantize(q.pos[0], limit), dequantize(q.pos[1], limit), dequantize(q.pos[2], limit));
+    for (int c = 0; c < 3; ++c) n.color[c] = q.color[c];
+    n.flags = q.flags;
+    n.health = q.health;
+    return n;
+}
+
+// changed? then: moved? (small? 3 x (nonzero? delta) : 3 positions), state? (health, flags), color? (rgb)
+void SnapshotCodec::writeEnemy(BitWriter& w, const QuantizedEnemy& base, const QuantizedEnemy& cur) {
+    bool moved = cur.pos[0] != base.pos[0] || cur.pos[1] != base.pos[1] || cur.pos[2] != base.pos[2];
+    bool state = cur.health != base.health || cur.flags != base.flags;
+    bool recolored = cur.color[0] != base.color[0] || cur.color[1] != base.color[1] || cur.color[2] != base.color[2];
+    w.writeBool(moved || state || recolored);
+    if (!(moved || state || recolored)) return;
+
+    w.writeBool(moved);
+    if (moved) {
+        const int range = 1 << (DELTA_BITS - 1);
+        int d[3];
+        bool small = true;
+        for (int a = 0; a < 3; ++a) {
+            d[a] = (int)cur.pos[a] - (int)base.pos[a];
+            small = small && d[a] >= -range && d[a] < range;
+        }
+        w.writeBool(small);
+        for (int a = 0; a < 3; ++a) {
+            if (!small) {
+                w.write(cur.pos[a], POSITION_BITS);
+                continue;
+            }
+            // Enemies move on the ground, so one axis is usually unchanged
+            w.writeBool(d[a] != 0);
+            if (d[a] != 0) w.writeSigned(d[a], DELTA_BITS);
+        }
+    }
+    w.writeBool(state);
+    if (state) {
+        w.write(cur.health, HEALTH_BITS);
+        w.write(cur.flags, FLAG_BITS);
+    }
+    w.writeBool(recolored);
+    if (recolored) {
+        for (int c = 0; c < 3; ++c) w.write(cur.color[c], COLOR_BITS);
+    }
+}
+
+QuantizedEnemy SnapshotCodec::readEnemy(BitReader& r, const QuantizedEnemy& base) {
+    QuantizedEnemy q = base;
+    if (!r.readBool()) return q;
+
+    if (r.readBool()) {
+        bool small = r.readBool();
+        for (int a = 0; a < 3; ++a) {
+            if (!small) q.pos[a] = (uint16_t)r.read(POSITION_BITS);
+            else if (r.readBool()) q.pos[a] = (uint16_t)(base.pos[a] + r.readSigned(DELTA_BITS));
+        }
+    }
+    if (r.readBool()) {
+        q.health = (uint8_t)r.read(HEALTH_BITS);
+        q.flags = (uint8_t)r.read(FLAG_BITS);
+    }
+    if (r.readBool()) {
+        for (int c = 0; c < 3; ++c) q.color[c] = (uint8_t)r.read(COLOR_BITS);
+    }
+    return q;
+}
+
+// Mirrors writeEnemy
+int SnapshotCodec::enemyBits(const QuantizedEnemy& base, const QuantizedEnemy& cur) {
+    bool moved = cur.pos[0] != base.pos[0] || cur.pos[1] != base.pos[1] || cur.pos[2] != base.pos[2];
+    bool state = cur.health != base.health || cur.flags != base.flags;
+    bool recolored = cur.color[0] != base.color[0] || cur.color[1] != base.color[1] || cur.color[2] != base.color[2];
+    if (!(moved || state || recolored)) return 1;
+
+    int bits = 4;
+    if (moved) {
+        const int range = 1 << (DELTA_BITS - 1);
+        int deltaBits = 1;
+        bool small = true;
+        for (int a = 0; a < 3; ++a) {
+            int d = (int)cur.pos[a] - (int)base.pos[a];
+            small = small && d >= -range && d < range;
+            deltaBits += 1 + (d != 0 ? DELTA_BITS : 0);
+        }
+        bits += small ? deltaBits : 1 + 3 * POSITION_BITS;
+    }
+    if (state) bits += HEALTH_BITS + FLAG_BITS;
+    if (recolored) bits += 3 * COLOR_BITS;
+    return bits;
+}
+
+int SnapshotCodec::indexBits(int total) {
+    int bits = 1;
+    while (bits < 16 && (1 << bits) < total) bits++;
+    return bits;
+}
+
+// base: stays? (enemy against its baseline); then joined count, (index, enemy in full) each
+bool SnapshotCodec::readView(BitReader& r, const ViewEnemy* base, int baseCount, int total, std::vector<ViewEnemy>& out) {
+    static const QuantizedEnemy zero;
+    out.clear();
+    for (int i = 0; i < baseCount; ++i) {
+        if (!r.readBool()) continue;
+        out.push_back({ base[i].index, readEnemy(r, base[i].q) });
+    }
+    int joined = (int)r.read(VIEW_JOIN_BITS);
+    int bits = indexBits(total);
+    for (int i = 0; i < joined; ++i) {
+        ViewEnemy v;
+        v.index = (uint16_t)r.read(bits);
+        v.q = readEnemy(r, zero);
+        if (v.index >= total) return false;
+        out.push_back(v);
+    }
+    return !r.isBad() && (int)out.size() <= MAX_VIEW_ENEMIES;
+}
+
+// id, position, yaw (wrapped to [0, 360)), pitch ([-90, 90]), health
+void SnapshotCodec::writeRemotePlayer(BitWriter& w, const NetRemotePlayer& p, float limit) {
+    w.write(p.id, Protocol::PLAYER_ID_BITS);
+    for (int a = 0; a < 3; ++a) w.write(quantize(p.position[a], limit), POSITION_BITS);
+    float yaw = std::fmod(p.yaw, 360.0f);
+    if (yaw < 0.0f) yaw += 360.0f;
+    w.write((uint32_t)std::lround(yaw / 360.0f * 65535.0f), 16);
+    w.write(quantize(p.pitch, 90.0f), 16);
+    w.write((uint32_t)std::min(std::max((int)p.health, 0), 127), HEALTH_BITS);
+}
+
+NetRemotePlayer SnapshotCodec::readRemotePlayer(BitReader& r, float limit) {
+    NetRemotePlayer p;
+    p.id = (uint16_t)r.read(Protocol::PLAYER_ID_BITS);
+    for (int a = 0; a < 3; ++a) p.position[a] = dequantize((uint16_t)r.read(POSITION_BITS), limit);
+    p.yaw = r.read(16) / 65535.0f * 360.0f;
+    p.pitch = dequantize((uint16_t)r.read(16), 90.0f);
+    p.health = (int16_t)r.read(HEALTH_BITS);
+    return p;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BitStream.h"
+#include "Protocol.h"
+
+class Enemy;
+
+// One enemy quantized to the arena; snapshots are encoded from, and decoded into, these
+struct QuantizedEnemy {
+    uint16_t pos[3] = {};    // Each axis mapped from [-limit, limit] to 0..65535
+    uint8_t color[3] = {};
+    uint8_t health = 0;      // 0..127
+    uint8_t flags = 0;       // EnemyFlags
+};
+
+// One enemy of a client's view: the enemies a snapshot carries and the client shows
+struct ViewEnemy {
+    uint16_t index = 0;      // Into the server's enemy array
+    QuantizedEnemy q;
+};
+
+// Quantization and delta coding of snapshot entities
+// A snapshot carries a client's view of the nearby enemies, written against the view of the
+// last snapshot it acknowledged: one bit per baseline enemy saying whether it stays, then
+// only the changed groups of those that stay (one bit when nothing changed), then the
+// enemies that join the view, by index and in full.
+namespace SnapshotCodec {
+    const int POSITION_BITS = 16;   // Per axis over [-limit, limit] (0.6 mm in the default 40 unit arena)
+    const int DELTA_BITS = 10;      // Per axis, for moves of up to +-511 quanta since the baseline
+    const int HEALTH_BITS = 7;
+    const int FLAG_BITS = 3;
+    const int COLOR_BITS = 8;       // Per channel
+    const int MAX_ENEMY_BITS = 4 + 3 * POSITION_BITS + HEALTH_BITS + FLAG_BITS + 3 * COLOR_BITS + 1;
+    const int VIEW_JOIN_BITS = 8;   // Enemies joining a view per snapshot
+    const int MAX_VIEW_ENEMIES = 255;
+    const int REMOTE_PLAYER_BITS = Protocol::PLAYER_ID_BITS + 3 * POSITION_BITS + 16 + 16 + HEALTH_BITS;
+
+    uint16_t quantize(float v, float limit);
+    float dequantize(uint16_t q, float limit);
+
+    QuantizedEnemy quantizeEnemy(const Enemy& e, float limit);
+    NetEnemy dequantizeEnemy(const QuantizedEnemy& q, float limit);
+
+    // One enemy against its baseline
+    void writeEnemy(BitWriter& w, const QuantizedEnemy& base, const QuantizedEnemy& cur);
+    QuantizedEnemy readEnemy(BitReader& r, const QuantizedEnemy& base);
+
+    // Exact size of writeEnemy(base, cur), for filling a packet without writing twice
+    int enemyBits(const QuantizedEnemy& base, const QuantizedEnemy& cur);
+
+    // Bits of an enemy index when there are total enemies
+    int indexBits(int total);
+
+    // Decode a view written against base (baseCount entries; empty for a full update) into out
+    // (cleared first); false if the data is bad or refers to enemies >= total
+    bool readView(BitReader& r, const ViewEnemy* base, int baseCount, int total, std::vector<ViewEnemy>& out);
+
+    void writeRemotePlayer(BitWriter& w, const NetRemotePlayer& p, float limit);
+    NetRemotePlayer readRemotePlayer(BitReader& r, float limit);
+}
@@ -0,0 +1,158 @@
+#include "Socket.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifndef SIO_UDP_CONNRESET
+#define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR, 12)
+#endif
+typedef int socklen_t;
+static const uintptr_t INVALID_HANDLE = (uintptr_t)INVALID_SOCKET;
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+static const int INVALID_HANDLE = -1;
+#endif
+
+// Parse "a.b.c.d:port" (or "a.b.c.d" with defaultPort)
+bool NetAddress::parse(const std::string& text, uint16_t defaultPort) {
+    unsigned int a, b, c, d, p = defaultPort;
+    int fields = std::sscanf(text.c_str(), "%u.%u.%u.%u:%u", &a, &b, &c, &d, &p);
+    if (fields < 4 || a > 255 || b > 255 || c > 255 || d > 255 || p > 65535) return false;
+    ip = (a << 24) | (b << 16) | (c << 8) | d;
+    port = (uint16_t)p;
+    return true;
+}
+
+// "a.b.c.d:port"
+std::string NetAddress::toString() const {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%u.%u.%u.%u:%u", ip >> 24, (ip >> 16) & 255, (ip >> 8) & 255, ip & 255, port);
+    return buf;
+}
+
+bool Net::startup() {
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        std::cerr << "ERROR::NET::WSASTARTUP_FAILED\n";
+        return false;
+    }
+#endif
+    return true;
+}
+
+void Net::cleanup() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+UdpSocket::UdpSocket() : handle(INVALID_HANDLE), port(0) {}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+// Bind to a port on all interfaces and switch to non-blocking mode
+bool UdpSocket::open(uint16_t bindPort) {
+    close();
+    handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_HANDLE) {
+        std::cerr << "ERROR::NET::SOCKET_CREATE_FAILED\n";
+        return false;
+    }
+
+    // Snapshots for many clients go out in bursts; give the OS room to queue them
+    int bufferBytes = 4 * 1024 * 1024;
+    setsockopt(handle, SOL_SOCKET, SO_SNDBUF, (const char*)&bufferBytes, sizeof(bufferBytes));
+    setsockopt(handle, SOL_SOCKET, SO_RCVBUF, (const char*)&bufferBytes, sizeof(bufferBytes));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(bindPort);
+    if (bind(handle, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+        std::cerr << "ERROR::NET::BIND_FAILED port " << bindPort << "\n";
+        close();
+        return false;
+    }
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(handle, FIONBIO, &nonBlocking);
+
+    // Windows reports an ICMP port unreachable (a peer that left) as WSAECONNRESET on the
+    // next recvfrom; UDP has no connection to reset, so turn that off
+    BOOL reportReset = FALSE;
+    DWORD returned = 0;
+    WSAIoctl(handle, SIO_UDP_CONNRESET, &reportReset, sizeof(reportReset), nullptr, 0, &returned, nullptr, nullptr);
+#else
+    fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    socklen_t len = sizeof(addr);
+    getsockname(handle, (sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle == INVALID_HANDLE) return;
+#ifdef _WIN32
+    closesocket(handle);
+#else
+    ::close(handle);
+#endif
+    handle = INVALID_HANDLE;
+    port = 0;
+}
+
+bool UdpSocket::isOpen() const {
+    return handle != INVALID_HANDLE;
+}
+
+// Send one datagram
+bool UdpSocket::sendTo(const NetAddress& to, const void* data, int bytes) {
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(to.ip);
+    addr.sin_port = htons(to.port);
+    int sent = sendto(handle, (const char*)data, bytes, 0, (const sockaddr*)&addr, sizeof(addr));
+    return sent == bytes;
+}
+
+// Receive one datagram, or -1 if none is waiting
+// Errors that belong to one datagram or one peer (a reset from a client that left, an
+// oversized datagram) skip it, so one bad peer cannot end a receive loop for everyone
+int UdpSocket::receive(NetAddress& from, void* data, int capacity) {
+    for (int attempt = 0; attempt < MAX_SKIPPED_ERRORS; ++attempt) {
+        sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        int got = recvfrom(handle, (char*)data, capacity, 0, (sockaddr*)&addr, &len);
+        if (got >= 0) {
+            from.ip = ntohl(addr.sin_addr.s_addr);
+            from.port = ntohs(addr.sin_port);
+            return got;
+        }
+#ifdef _WIN32
+        int error = WSAGetLastError();
+        if (error == WSAEWOULDBLOCK) return -1;
+        if (error != WSAECONNRESET && error != WSAEMSGSIZE && error != WSAEINTR) break;
+#else
+        int error = errno;
+        if (error == EAGAIN || error == EWOULDBLOCK) return -1;
+        if (error != ECONNREFUSED && error != EINTR) break;
+#endif
+    }
+    return -1;   // Broken socket, or a long run of errors: try again next time
+}
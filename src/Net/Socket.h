@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// IPv4 address and port in host byte order
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    // Parse "a.b.c.d:port" (or "a.b.c.d" with defaultPort); false if malformed
+    bool parse(const std::string& text, uint16_t defaultPort);
+
+    // "a.b.c.d:port"
+    std::string toString() const;
+
+    bool operator==(const NetAddress& o) const { return ip == o.ip && port == o.port; }
+    bool operator!=(const NetAddress& o) const { return !(*this == o); }
+};
+
+// Process-wide socket library setup (WSAStartup on Windows, nothing elsewhere)
+namespace Net {
+    bool startup();
+    void cleanup();
+}
+
+// UdpSocket is a non-blocking IPv4 datagram socket
+class UdpSocket {
+public:
+    UdpSocket();
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Bind to a port on all interfaces (0 = any free port)
+    bool open(uint16_t port);
+    void close();
+    bool isOpen() const;
+
+    // Send one datagram; false if the OS refused it (e.g. buffer full)
+    bool sendTo(const NetAddress& to, const void* data, int bytes);
+
+    // Receive one datagram; returns its size, or -1 if none is waiting
+    // Per-datagram errors (a reset from a peer that left, a datagram too large) are skipped
+    int receive(NetAddress& from, void* data, int capacity);
+
+    // Port the socket is bound to
+    uint16_t getPort() const { return port; }
+
+private:
+    static const int MAX_SKIPPED_ERRORS = 64;   // Per receive() call, before giving up until the next
+
+#ifdef _WIN32
+    uintptr_t handle;     // SOCKET
+#else
+    int handle;
+#endif
+    uint16_t port;
+};
@@ -0,0 +1,186 @@
+#include "SpectatorClient.h"
+#include "NetClient.h"
+#include <iostream>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+SpectatorClient::SpectatorClient() : lastHeard(Clock::now()), lastKeepAlive(Clock::now()) {}
+
+SpectatorClient::~SpectatorClient() {
+    disconnect();
+}
+
+// Blocking handshake: SPECTATE is resent every 250 ms until SPECTATE_ACCEPT, REJECT or the timeout
+// The relay first answers with a cookie (SPECTATE_CHALLENGE), which every later SPECTATE echoes
+bool SpectatorClient::connect(const NetAddress& address, float timeoutSeconds, WorldLayout& layout) {
+    if (!socket.open(0)) return false;
+    relay = address;
+    cookie = 0;
+
+    auto start = Clock::now();
+    auto lastSend = start - std::chrono::seconds(1);
+    uint8_t buffer[Protocol::MAX_PACKET];
+    while (std::chrono::duration<float>(Clock::now() - start).count() < timeoutSeconds) {
+        if (Clock::now() - lastSend > std::chrono::milliseconds(250)) {
+            PacketWriter w(buffer, sizeof(buffer));
+            Protocol::writeHeader(w, MessageType::SPECTATE);
+            w.write(cookie);
+            socket.sendTo(relay, buffer, w.getSize());
+            lastSend = Clock::now();
+        }
+
+        NetAddress from;
+        int bytes;
+        while ((bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+            if (from != relay) continue;
+            PacketReader r(buffer, bytes);
+            MessageType type;
+            if (!Protocol::readHeader(r, type)) continue;
+            if (type == MessageType::REJECT) {
+                std::cerr << "ERROR::NET::RELAY_FULL " << relay.toString() << "\n";
+                socket.close();
+                return false;
+            }
+            if (type == MessageType::SPECTATE_CHALLENGE) {
+                // Answer right away with the cookie
+                uint32_t challenge = r.read<uint32_t>();
+                if (!r.isBad() && challenge != cookie) {
+                    cookie = challenge;
+                    lastSend = start - std::chrono::seconds(1);
+                }
+                continue;
+            }
+            if (type != MessageType::SPECTATE_ACCEPT) continue;
+            layout = Protocol::readLayout(r);
+            delaySeconds = r.read<float>();
+            if (r.isBad()) continue;
+            limit = layout.halfSize;
+
+            connected = true;
+            lastHeard = lastKeepAlive = Clock::now();
+            if (verbose) std::cout << "Spectating through " << relay.toString() << " (" << delaySeconds << " s behind)\n";
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::cerr << "ERROR::NET::CONNECT_TIMEOUT " << relay.toString() << "\n";
+    socket.close();
+    return false;
+}
+
+void SpectatorClient::disconnect() {
+    if (!connected) return;
+    uint8_t buffer[16];
+    PacketWriter w(buffer, sizeof(buffer));
+    Protocol::writeHeader(w, MessageType::DISCONNECT);
+    socket.sendTo(relay, buffer, w.getSize());
+    socket.close();
+    connected = false;
+}
+
+bool SpectatorClient::hasTimedOut() const {
+    return connected && std::chrono::duration<float>(Clock::now() - lastHeard).count() > Protocol::TIMEOUT_SECONDS;
+}
+
+// Receive everything waiting; true if a newer frame arrived
+bool SpectatorClient::poll() {
+    if (!connected) return false;
+    uint8_t buffer[Protocol::MAX_PACKET];
+    auto now = Clock::now();
+    if (now - lastKeepAlive > std::chrono::seconds(1)) {
+        PacketWriter w(buffer, sizeof(buffer));
+        Protocol::writeHeader(w, MessageType::SPECTATE);
+        w.write(cookie);
+        socket.sendTo(relay, buffer, w.getSize());
+        lastKeepAlive = now;
+    }
+
+    uint32_t before = tick;
+    NetAddress from;
+    int bytes;
+    while ((bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+        if (from != relay) continue;
+        PacketReader r(buffer, bytes);
+        MessageType type;
+        if (!Protocol::readHeader(r, type)) continue;
+        lastHeard = Clock::now();
+        stats.packetsIn++;
+        stats.bytesIn += bytes;
+        if (type == MessageType::BROADCAST) {
+            uint32_t frameTick = r.read<uint32_t>();
+            if (frameTick > tick) {
+                tick = frameTick;
+                stats.frames++;
+            }
+            if (decoding) readBroadcast(r, frameTick);
+        } else if (type == MessageType::DISCONNECT) {
+            std::cout << "Relay closed the connection\n";
+            socket.close();
+            connected = false;
+            return false;
+        }
+    }
+    return tick != before;
+}
+
+// One chunk of the frame at frameTick
+void SpectatorClient::readBroadcast(PacketReader& r, uint32_t frameTick) {
+    static const QuantizedEnemy zero;
+    const int chunkSize = Protocol::BROADCAST_CHUNK;
+    BroadcastKind kind = r.read<BroadcastKind>();
+    if (kind == BroadcastKind::PLAYERS) {
+        uint8_t items = r.read<uint8_t>();
+        int total = r.read<uint16_t>();
+        int first = r.read<uint16_t>();
+        int count = r.read<uint8_t>();
+        if (r.isBad() || count > chunkSize || first + count > total || frameTick != tick) return;
+        BitReader bits(r.getCurrent(), r.getRemaining());
+        NetRemotePlayer incoming[Protocol::BROADCAST_CHUNK];
+        for (int i = 0; i < count; ++i) incoming[i] = SnapshotCodec::readRemotePlayer(bits, limit);
+        if (bits.isBad()) return;
+        itemsMask = items;
+        players.resize(total);
+        for (int i = 0; i < count; ++i) players[first + i] = incoming[i];
+        return;
+    }
+
+    uint32_t base = r.read<uint32_t>();
+    int total = r.read<uint16_t>();
+    int first = r.read<uint16_t>();
+    int count = r.read<uint8_t>();
+    if (r.isBad() || kind != BroadcastKind::ENEMIES || count > chunkSize || first + count > total || first % chunkSize != 0) return;
+    if ((int)quantized.size() != total) {
+        quantized.assign(total, zero);
+        chunkTicks.assign((total + chunkSize - 1) / chunkSize, 0);
+        enemyStates.assign(total, NetEnemy());
+    }
+
+    // Only on top of the frame it was coded against; older or repeated chunks are ignored
+    int chunk = first / chunkSize;
+    stats.chunks++;
+    if (frameTick <= chunkTicks[chunk]) return;
+    if (base != 0 && chunkTicks[chunk] != base) {
+        stats.chunksSkipped++;
+        return;
+    }
+
+    BitReader bits(r.getCurrent(), r.getRemaining());
+    QuantizedEnemy incoming[Protocol::BROADCAST_CHUNK];
+    for (int i = 0; i < count; ++i) incoming[i] = SnapshotCodec::readEnemy(bits, base != 0 ? quantized[first + i] : zero);
+    if (bits.isBad()) return;
+    for (int i = 0; i < count; ++i) {
+        quantized[first + i] = incoming[i];
+        enemyStates[first + i] = SnapshotCodec::dequantizeEnemy(incoming[i], limit);
+    }
+    chunkTicks[chunk] = frameTick;
+}
+
+void SpectatorClient::applyEnemies(EnemyManager& enemies) const {
+    NetClient::applyEnemyStates(enemyStates, enemies);
+}
+
+void SpectatorClient::applyItems(World& world) const {
+    NetClient::applyItemsMask(itemsMask, world);
+}
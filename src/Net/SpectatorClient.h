@@ -0,0 +1,81 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "Socket.h"
+#include "Protocol.h"
+#include "SnapshotCodec.h"
+
+class EnemyManager;
+class World;
+
+// SpectatorClient watches a match through a relay (see SpectatorRelay)
+// The relay plays the server's broadcast back some seconds late, the same packets for every
+// spectator: all players in full and all enemies in chunks, each chunk delta coded against the
+// previous frame and sent in full once a second. A delta chunk is only taken when this client
+// holds that chunk at the frame it was coded against; otherwise the chunk waits for its next
+// full copy. Nothing is acknowledged; the only traffic back is a keep-alive every second.
+class SpectatorClient {
+public:
+    SpectatorClient();
+    ~SpectatorClient();
+
+    // Blocking handshake; on success layout holds the match's world
+    bool connect(const NetAddress& relay, float timeoutSeconds, WorldLayout& layout);
+
+    // Tell the relay we are leaving and close the socket
+    void disconnect();
+
+    bool isConnected() const { return connected; }
+
+    // True when the relay has been silent for Protocol::TIMEOUT_SECONDS
+    bool hasTimedOut() const;
+
+    // Receive everything waiting (and keep the subscription alive); true if newer state arrived
+    bool poll();
+
+    // Decode the broadcast (on by default); load test spectators only count the traffic
+    void setDecoding(bool on) { decoding = on; }
+    void setVerbose(bool on) { verbose = on; }
+
+    // Latest state
+    const std::vector<NetRemotePlayer>& getPlayers() const { return players; }
+    const std::vector<NetEnemy>& getEnemies() const { return enemyStates; }
+    uint32_t getTick() const { return tick; }
+    float getDelay() const { return delaySeconds; }   // How far behind the match the relay plays
+
+    // Traffic since connect; a chunk is skipped when its base frame is missing
+    struct Stats {
+        long long packetsIn = 0, bytesIn = 0;
+        int frames = 0;
+        int chunks = 0, chunksSkipped = 0;
+    };
+    const Stats& getStats() const { return stats; }
+
+    // Copy the broadcast enemies / item set into the local game objects for drawing
+    void applyEnemies(EnemyManager& enemies) const;
+    void applyItems(World& world) const;
+
+private:
+    UdpSocket socket;
+    NetAddress relay;
+    bool connected = false;
+    bool decoding = true;
+    bool verbose = true;
+    std::chrono::steady_clock::time_point lastHeard;
+    std::chrono::steady_clock::time_point lastKeepAlive;
+    Stats stats;
+
+    float limit = 20.0f;            // Quantization range (the arena half size)
+    float delaySeconds = 0.0f;
+    uint32_t cookie = 0;            // From the relay's SPECTATE_CHALLENGE, echoed in every SPECTATE
+
+    uint32_t tick = 0;              // Newest frame seen
+    uint8_t itemsMask = 0;
+    std::vector<NetRemotePlayer> players;
+    std::vector<QuantizedEnemy> quantized;     // Delta bases, by enemy
+    std::vector<uint32_t> chunkTicks;          // Frame each enemy chunk was last decoded at (0 = never)
+    std::vector<NetEnemy> enemyStates;
+
+    void readBroadcast(PacketReader& r, uint32_t frameTick);
+};
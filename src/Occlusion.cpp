@@ -0,0 +1,295 @@
+#include "Occlusion.h"
+#include "World.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_SSE 1
+#endif
+
+// Clip-space w below which geometry is treated as crossing the near plane
+static const float NEAR_W = 0.1f;
+
+// Constructor: allocate the depth buffer once
+OcclusionCuller::OcclusionCuller() : depth(WIDTH * HEIGHT, 1.0f), viewProj(1.0f), eye(0.0f), pendingFlush(false) {
+    // Room for a full frame of occluders up front (12 triangles per box, near clipping can split each in two)
+    // so binning never reallocates mid-game
+    const int maxTris = MAX_OCCLUDERS * 24;
+    tris.reserve(maxTris);
+    for (auto& bin : bins) bin.reserve(maxTris);
+}
+
+// Reset the depth buffer to the far plane for a new frame
+void OcclusionCuller::beginFrame(const glm::mat4& VP, const glm::vec3& cameraPos) {
+    viewProj = VP;
+    eye = cameraPos;
+    std::fill(depth.begin(), depth.end(), 1.0f);
+    tris.clear();
+    for (auto& bin : bins) bin.clear();
+    pendingFlush = false;
+    stats = Stats();
+}
+
+// Choose occluders: tall static cubes (walls, pillars) ranked by size over distance
+void OcclusionCuller::addOccluders(const World& world, FrameArena& arena) {
+    struct Candidate { float score; AABB box; };
+    ArenaVector<Candidate> candidates(arena);
+
+    for (const auto& entry : world.chunks) {
+        const Chunk& chunk = *entry.second;
+        for (size_t i = 0; i < chunk.cubes.size(); ++i) {
+            const Cube& c = chunk.cubes[i];
+            if (c.isItem || c.size.y <= 1.0f) continue;  // Skip floor and ceiling slabs
+
+            const AABB& box = chunk.colliders[i];
+            glm::vec3 closest = glm::clamp(eye, box.min, box.max);
+            float dist2 = std::max(glm::dot(closest - eye, closest - eye), 1.0f);
+
+            // Area of the largest face approximates how much of the screen it can cover
+            float a = c.size.x * c.size.y, b = c.size.z * c.size.y, d = c.size.x * c.size.z;
+            float area = std::max(a, std::max(b, d));
+            candidates.push_back({area / dist2, box});
+        }
+    }
+
+    if ((int)candidates.size() > MAX_OCCLUDERS) {
+        std::nth_element(candidates.begin(), candidates.begin() + MAX_OCCLUDERS, candidates.end(),
+                         [](const Candidate& l, const Candidate& r) { return l.score > r.score; });
+        candidates.resize(MAX_OCCLUDERS);
+    }
+
+    for (const auto& c : candidates) {
+        rasterizeBox(c.box);
+    }
+    flushBins();
+}
+
+// Submit the camera-facing faces of a box as occluder triangles
+void OcclusionCuller::rasterizeBox(const AABB& box) {
+    glm::vec4 corners[8];
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 p((i & 1) ? box.max.x : box.min.x,
+                    (i & 2) ? box.max.y : box.min.y,
+                    (i & 4) ? box.max.z : box.min.z);
+        corners[i] = viewProj * glm::vec4(p, 1.0f);
+    }
+
+    // Faces as corner quads; a face can only be seen from its outer side
+    static const int faces[6][4] = {
+        {0, 2, 6, 4}, {1, 3, 7, 5},   // -X, +X
+        {0, 1, 5, 4}, {2, 3, 7, 6},   // -Y, +Y
+        {0, 1, 3, 2}, {4, 5, 7, 6}    // -Z, +Z
+    };
+    bool facing[6] = {
+        eye.x < box.min.x, eye.x > box.max.x,
+        eye.y < box.min.y, eye.y > box.max.y,
+        eye.z < box.min.z, eye.z > box.max.z
+    };
+
+    for (int f = 0; f < 6; ++f) {
+        if (!facing[f]) continue;
+        const int* q = faces[f];
+        addTriangle(corners[q[0]], corners[q[1]], corners[q[2]]);
+        addTriangle(corners[q[0]], corners[q[2]], corners[q[3]]);
+    }
+
+    stats.occluders++;
+    pendingFlush = true;
+}
+
+// Clip a clip-space triangle against w >= NEAR_W and project the pieces
+void OcclusionCuller::addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+    glm::vec4 in[3] = {a, b, c};
+    glm::vec4 out[4];
+    int count = 0;
+
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec4& cur = in[i];
+        const glm::vec4& next = in[(i + 1) % 3];
+        bool curIn = cur.w >= NEAR_W;
+        bool nextIn = next.w >= NEAR_W;
+
+        if (curIn) out[count++] = cur;
+        if (curIn != nextIn) {
+            float t = (NEAR_W - cur.w) / (next.w - cur.w);
+            out[count++] = cur + (next - cur) * t;
+        }
+    }
+    if (count < 3) return;
+
+    // Project to depth-buffer pixels (y up) with NDC depth
+    glm::vec3 s[4];
+    for (int i = 0; i < count; ++i) {
+        float invW = 1.0f / out[i].w;
+        s[i] = glm::vec3((out[i].x * invW * 0.5f + 0.5f) * WIDTH,
+                         (out[i].y * invW * 0.5f + 0.5f) * HEIGHT,
+                         out[i].z * invW);
+    }
+
+    setupTriangle(s[0], s[1], s[2]);
+    if (count == 4) setupTriangle(s[0], s[2], s[3]);
+}
+
+// Compute edge and depth equations and put the triangle into every tile it touches
+void OcclusionCuller::setupTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 v[3] = {a, b, c};
+    float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+    if (std::fabs(area) < 1e-6f) return;
+    if (area < 0.0f) {  // Accept either winding
+        std::swap(v[1], v[2]);
+        area = -area;
+    }
+
+    float minXf = std::min(v[0].x, std::min(v[1].x, v[2].x));
+    float maxXf = std::max(v[0].x, std::max(v[1].x, v[2].x));
+    float minYf = std::min(v[0].y, std::min(v[1].y, v[2].y));
+    float maxYf = std::max(v[0].y, std::max(v[1].y, v[2].y));
+
+    ScreenTri t;
+    t.minX = std::max(0, (int)std::floor(minXf));
+    t.maxX = std::min(WIDTH - 1, (int)std::ceil(maxXf));
+    t.minY = std::max(0, (int)std::floor(minYf));
+    t.maxY = std::min(HEIGHT - 1, (int)std::ceil(maxYf));
+    if (t.minX > t.maxX || t.minY > t.maxY) return;
+
+    // Edge i runs from v[i] to v[i+1]; inside is where all edges are >= 0
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec3& p0 = v[i];
+        const glm::vec3& p1 = v[(i + 1) % 3];
+        t.edgeA[i] = p0.y - p1.y;
+        t.edgeB[i] = p1.x - p0.x;
+        t.edgeC[i] = -(t.edgeA[i] * p0.x + t.edgeB[i] * p0.y);
+    }
+
+    // Barycentric weights: edge (v1,v2) weights v0, edge (v2,v0) weights v1, edge (v0,v1) weights v2
+    float inv = 1.0f / area;
+    t.zA = (t.edgeA[1] * v[0].z + t.edgeA[2] * v[1].z + t.edgeA[0] * v[2].z) * inv;
+    t.zB = (t.edgeB[1] * v[0].z + t.edgeB[2] * v[1].z + t.edgeB[0] * v[2].z) * inv;
+    t.zC = (t.edgeC[1] * v[0].z + t.edgeC[2] * v[1].z + t.edgeC[0] * v[2].z) * inv;
+
+    int index = (int)tris.size();
+    tris.push_back(t);
+    stats.triangles++;
+
+    for (int ty = t.minY / TILE_H; ty <= t.maxY / TILE_H; ++ty) {
+        for (int tx = t.minX / TILE_W; tx <= t.maxX / TILE_W; ++tx) {
+            bins[ty * TILES_X + tx].push_back(index);
+        }
+    }
+}
+
+// Rasterize every tile's bin, then clear the bins
+void OcclusionCuller::flushBins() {
+    for (int ty = 0; ty < TILES_Y; ++ty) {
+        for (int tx = 0; tx < TILES_X; ++tx) {
+            rasterizeTile(tx, ty);
+        }
+    }
+    for (auto& bin : bins) bin.clear();
+    tris.clear();
+    pendingFlush = false;
+}
+
+// Rasterize the triangles in one tile, keeping the nearest depth per pixel
+void OcclusionCuller::rasterizeTile(int tileX, int tileY) {
+    const std::vector<int>& bin = bins[tileY * TILES_X + tileX];
+    int tileMinX = tileX * TILE_W, tileMaxX = tileMinX + TILE_W - 1;
+    int tileMinY = tileY * TILE_H, tileMaxY = tileMinY + TILE_H - 1;
+
+    for (int index : bin) {
+        const ScreenTri& t = tris[index];
+        // Start on a 4-pixel boundary so SIMD rows stay inside the tile
+        int x0 = std::max(t.minX, tileMinX) & ~3;
+        int x1 = std::min(t.maxX, tileMaxX);
+        int y0 = std::max(t.minY, tileMinY);
+        int y1 = std::min(t.maxY, tileMaxY);
+
+        for (int y = y0; y <= y1; ++y) {
+            float py = y + 0.5f;
+            float* row = &depth[y * WIDTH];
+#ifdef OCCLUSION_SSE
+            __m128 step = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            __m128 zero = _mm_setzero_ps();
+            for (int x = x0; x <= x1; x += 4) {
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)x), step);
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int e = 0; e < 3; ++e) {
+                    __m128 val = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edgeA[e]), px),
+                                            _mm_set1_ps(t.edgeB[e] * py + t.edgeC[e]));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(val, zero));
+                }
+                if (_mm_movemask_ps(inside) == 0) continue;
+
+                __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.zA), px), _mm_set1_ps(t.zB * py + t.zC));
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(old, z);
+                __m128 result = _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old));
+                _mm_storeu_ps(row + x, result);
+            }
+#else
+            for (int x = x0; x <= x1; ++x) {
+                float px = x + 0.5f;
+                bool inside = true;
+                for (int e = 0; e < 3; ++e) {
+                    if (t.edgeA[e] * px + t.edgeB[e] * py + t.edgeC[e] < 0.0f) inside = false;
+                }
+                if (!inside) continue;
+                float z = t.zA * px + t.zB * py + t.zC;
+                if (z < row[x]) row[x] = z;
+            }
+#endif
+        }
+    }
+}
+
+// Conservative visibility test of a box against the occluder depth buffer
+bool OcclusionCuller::isVisible(const AABB& box) {
+    if (pendingFlush) flushBins();
+    stats.tested++;
+
+    float minX = 1e9f, maxX = -1e9f, minY = 1e9f, maxY = -1e9f, minZ = 1e9f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 p((i & 1) ? box.max.x : box.min.x,
+                    (i & 2) ? box.max.y : box.min.y,
+                    (i & 4) ? box.max.z : box.min.z);
+        glm::vec4 clip = viewProj * glm::vec4(p, 1.0f);
+        if (clip.w < NEAR_W) return true;  // Crosses the near plane: assume visible
+
+        float invW = 1.0f / clip.w;
+        float sx = (clip.x * invW * 0.5f + 0.5f) * WIDTH;
+        float sy = (clip.y * invW * 0.5f + 0.5f) * HEIGHT;
+        minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+        minZ = std::min(minZ, clip.z * invW);
+    }
+
+    int x0 = std::max(0, (int)std::floor(minX));
+    int x1 = std::min(WIDTH - 1, (int)std::ceil(maxX));
+    int y0 = std::max(0, (int)std::floor(minY));
+    int y1 = std::min(HEIGHT - 1, (int)std::ceil(maxY));
+
+    // Entirely off screen
+    if (x0 > x1 || y0 > y1) {
+        stats.culled++;
+        return false;
+    }
+
+    // Visible if any covered pixel has an occluder farther than the box's nearest point
+    for (int y = y0; y <= y1; ++y) {
+        const float* row = &depth[y * WIDTH];
+        int x = x0;
+#ifdef OCCLUSION_SSE
+        __m128 boxZ = _mm_set1_ps(minZ);
+        for (; x + 3 <= x1; x += 4) {
+            if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(row + x), boxZ))) return true;
+        }
+#endif
+        for (; x <= x1; ++x) {
+            if (row[x] > minZ) return true;
+        }
+    }
+
+    stats.culled++;
+    return false;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include "Chunk.h"
+#include "FrameArena.h"
+
+class World;
+
+// OcclusionCuller rasterizes large wall cubes into a small CPU depth buffer
+// and tests enemy / item bounding boxes against it before they are drawn.
+// Runs entirely on the CPU (no GPU readback), using SSE when available.
+class OcclusionCuller {
+public:
+    static const int WIDTH = 256;          // Depth buffer width in pixels
+    static const int HEIGHT = 160;         // Depth buffer height in pixels
+    static const int TILE_W = 32;          // Tile width used for binning
+    static const int TILE_H = 16;          // Tile height used for binning
+    static const int TILES_X = WIDTH / TILE_W;
+    static const int TILES_Y = HEIGHT / TILE_H;
+    static const int MAX_OCCLUDERS = 32;   // Occluder cubes rasterized per frame
+
+    // Per-frame counters for debugging and tuning
+    struct Stats {
+        int occluders = 0;        // Cubes rasterized as occluders
+        int triangles = 0;        // Triangles binned after clipping / culling
+        int tested = 0;           // Bounding boxes tested
+        int culled = 0;           // Bounding boxes found hidden
+    };
+
+    OcclusionCuller();
+
+    // Clear the depth buffer and store the camera for this frame
+    void beginFrame(const glm::mat4& VP, const glm::vec3& cameraPos);
+
+    // Pick the most useful wall cubes from the loaded chunks and rasterize them
+    // (the candidate list is built in the frame arena)
+    void addOccluders(const World& world, FrameArena& arena);
+
+    // Add one box as an occluder (rasterized before the next visibility test)
+    void rasterizeBox(const AABB& box);
+
+    // True if any part of the box may be visible (false = safe to skip drawing)
+    bool isVisible(const AABB& box);
+
+    // Counters for the current frame
+    const Stats& getStats() const { return stats; }
+
+private:
+    // Triangle in depth-buffer space with precomputed edge and depth equations
+    struct ScreenTri {
+        float edgeA[3], edgeB[3], edgeC[3];   // Edge functions A*x + B*y + C
+        float zA, zB, zC;                     // Depth plane z = zA*x + zB*y + zC
+        int minX, maxX, minY, maxY;           // Pixel bounds (inclusive)
+    };
+
+    std::vector<float> depth;                 // Nearest occluder depth (NDC z) per pixel
+    std::vector<ScreenTri> tris;              // Triangles set up this frame
+    std::vector<int> bins[TILES_X * TILES_Y]; // Triangle indices per tile
+    glm::mat4 viewProj;                       // Camera view-projection for this frame
+    glm::vec3 eye;                            // Camera position for this frame
+    bool pendingFlush;                        // Binned triangles not yet rasterized
+    Stats stats;
+
+    // Clip a triangle against the near plane, project it and bin it into tiles
+    void addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+    // Set up edge/depth equations for a projected triangle and bin it
+    void setupTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+    // Rasterize all triangles binned to one tile
+    void rasterizeTile(int tileX, int tileY);
+
+    // Rasterize the binned triangles of every tile
+    void flushBins();
+};
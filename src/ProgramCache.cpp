@@ -0,0 +1,199 @@
+#include "ProgramCache.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+// GL_KHR_parallel_shader_compile is not part of the GLAD loader
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+typedef void (*PFN_MaxShaderCompilerThreads)(GLuint count);
+
+// Header in front of every stored binary
+struct BinaryHeader {
+    char magic[4];                    // "SPB1"
+    unsigned long long driverHash;
+    unsigned long long sourceHash;
+    unsigned int format;              // Driver binary format
+    unsigned int length;              // Bytes of binary data that follow
+};
+
+// FNV-1a, 64 bit
+static unsigned long long hashString(const std::string& s, unsigned long long h = 14695981039346656037ull) {
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// GL string, or an empty string if the driver returns nothing
+static std::string glString(GLenum name) {
+    const GLubyte* s = glGetString(name);
+    return s ? (const char*)s : "";
+}
+
+// Read the driver string and enable parallel compile / binaries if available
+void ProgramCache::init(const std::string& dir) {
+    auto start = std::chrono::steady_clock::now();
+    directory = dir;
+    driverHash = hashString(glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION));
+
+    // Program binaries need GL 4.1 (or ARB_get_program_binary) and at least one format
+    GLint formats = 0;
+    if (glGetProgramBinary && glProgramBinary && glProgramParameteri)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    stats.binaries = formats > 0;
+    if (stats.binaries) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+    }
+
+    // Let the driver pick how many compiler threads to use
+    PFN_MaxShaderCompilerThreads maxThreads = nullptr;
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+        maxThreads = (PFN_MaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+        maxThreads = (PFN_MaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+    if (maxThreads) {
+        maxThreads(0xFFFFFFFFu);
+        stats.parallel = true;
+    }
+
+    stats.ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Path of the binary file for a program
+std::string ProgramCache::binaryPath(const std::string& name) const {
+    return directory + "/" + name + ".bin";
+}
+
+// Create a program from source, preferring a stored binary
+unsigned int ProgramCache::create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc) {
+    auto start = std::chrono::steady_clock::now();
+    stats.programs++;
+    unsigned long long sourceHash = hashString(fragmentSrc, hashString(vertexSrc));
+
+    unsigned int program = stats.binaries ? loadBinary(name, sourceHash) : 0;
+    if (program) {
+        stats.cacheHits++;
+    } else {
+        // Compile and link without querying status, so parallel compiles are not serialized
+        const char* vCode = vertexSrc.c_str();
+        const char* fCode = fragmentSrc.c_str();
+
+        Pending p;
+        p.name = name;
+        p.sourceHash = sourceHash;
+        p.vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(p.vertex, 1, &vCode, nullptr);
+        glCompileShader(p.vertex);
+        p.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(p.fragment, 1, &fCode, nullptr);
+        glCompileShader(p.fragment);
+
+        p.program = glCreateProgram();
+        if (stats.binaries) glProgramParameteri(p.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glAttachShader(p.program, p.vertex);
+        glAttachShader(p.program, p.fragment);
+        glLinkProgram(p.program);
+
+        pending.push_back(p);
+        program = p.program;
+        stats.compiled++;
+    }
+
+    stats.ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return program;
+}
+
+// Try to create the program from its stored binary; returns 0 on a miss
+unsigned int ProgramCache::loadBinary(const std::string& name, unsigned long long sourceHash) {
+    std::ifstream file(binaryPath(name), std::ios::binary);
+    if (!file) return 0;
+
+    BinaryHeader header;
+    if (!file.read((char*)&header, sizeof(header))) return 0;
+    if (std::memcmp(header.magic, "SPB1", 4) != 0 || header.driverHash != driverHash ||
+        header.sourceHash != sourceHash || header.length == 0) return 0;
+
+    std::vector<char> data(header.length);
+    if (!file.read(data.data(), data.size())) return 0;
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.format, data.data(), (GLsizei)data.size());
+
+    // Drivers may refuse a binary after an update even if the version string is unchanged
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        stats.rejected++;
+        return 0;
+    }
+    return program;
+}
+
+// Write the linked program's binary to disk
+void ProgramCache::storeBinary(const Pending& p) {
+    GLint length = 0;
+    glGetProgramiv(p.program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> data(length);
+    GLenum format = 0;
+    glGetProgramBinary(p.program, length, &length, &format, data.data());
+
+    BinaryHeader header;
+    std::memcpy(header.magic, "SPB1", 4);
+    header.driverHash = driverHash;
+    header.sourceHash = p.sourceHash;
+    header.format = format;
+    header.length = (unsigned int)length;
+
+    std::ofstream file(binaryPath(p.name), std::ios::binary | std::ios::trunc);
+    if (!file) return;
+    file.write((const char*)&header, sizeof(header));
+    file.write(data.data(), length);
+}
+
+// Wait for outstanding compiles, report errors and store the new binaries
+void ProgramCache::finish() {
+    auto start = std::chrono::steady_clock::now();
+    char infoLog[1024];
+
+    for (const Pending& p : pending) {
+        int success;
+        glGetShaderiv(p.vertex, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            glGetShaderInfoLog(p.vertex, 1024, nullptr, infoLog);
+            std::cerr << "Shader compile error (" << p.name << ", VERTEX):\n" << infoLog << std::endl;
+        }
+        glGetShaderiv(p.fragment, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            glGetShaderInfoLog(p.fragment, 1024, nullptr, infoLog);
+            std::cerr << "Shader compile error (" << p.name << ", FRAGMENT):\n" << infoLog << std::endl;
+        }
+
+        glGetProgramiv(p.program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glGetProgramInfoLog(p.program, 1024, nullptr, infoLog);
+            std::cerr << "Program link error (" << p.name << "):\n" << infoLog << std::endl;
+        } else if (stats.binaries) {
+            storeBinary(p);
+        }
+
+        glDetachShader(p.program, p.vertex);
+        glDetachShader(p.program, p.fragment);
+        glDeleteShader(p.vertex);
+        glDeleteShader(p.fragment);
+    }
+    pending.clear();
+
+    stats.ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[DEBUG] ProgramCache: " << stats.programs << " programs, " << stats.cacheHits << " from cache, "
+              << stats.compiled << " compiled (" << stats.rejected << " rejected binaries, parallel compile "
+              << (stats.parallel ? "on" : "off") << "), " << stats.ms << " ms\n";
+}
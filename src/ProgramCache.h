@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// ProgramCache creates every shader program in the game
+// Linked program binaries are stored on disk, keyed by a hash of the GLSL source
+// and the GL driver string; a missing or mismatching binary falls back to compiling.
+// Compiles are issued back to back and only checked in finish(), so drivers with
+// GL_KHR_parallel_shader_compile can build them on several threads
+class ProgramCache {
+public:
+    // Startup counters
+    struct Stats {
+        int programs = 0;        // Programs requested
+        int cacheHits = 0;       // Loaded from a stored binary
+        int compiled = 0;        // Compiled from source
+        int rejected = 0;        // Stored binaries the driver refused
+        bool parallel = false;   // Parallel shader compile enabled
+        bool binaries = false;   // Program binaries supported by the driver
+        float ms = 0.0f;         // Time spent creating and checking programs
+    };
+
+    // Read the driver string and enable parallel compile / binaries if available
+    // Call once the GL context is current
+    void init(const std::string& directory);
+
+    // Create a program from vertex / fragment source; name is used for the cache file and errors
+    // The returned ID is valid immediately, but compile errors are only reported by finish()
+    unsigned int create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+
+    // Wait for outstanding compiles, report errors and store the new binaries
+    void finish();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    // A program compiled from source that finish() still has to check
+    struct Pending {
+        std::string name;
+        unsigned int program;
+        unsigned int vertex;
+        unsigned int fragment;
+        unsigned long long sourceHash;
+    };
+
+    std::string directory;            // Where binaries are stored
+    unsigned long long driverHash = 0;  // Hash of GL vendor / renderer / version
+    std::vector<Pending> pending;
+    Stats stats;
+
+    // Path of the binary file for a program
+    std::string binaryPath(const std::string& name) const;
+
+    // Try to create the program from its stored binary; returns 0 on a miss
+    unsigned int loadBinary(const std::string& name, unsigned long long sourceHash);
+
+    // Write the linked program's binary to disk
+    void storeBinary(const Pending& p);
+};
@@ -0,0 +1,52 @@
+#include <csignal>
+#include <iostream>
+#include <string>
+#include "SpectatorRelay.h"
+
+static SpectatorRelay* activeRelay = nullptr;
+
+static void onSignal(int) {
+    if (activeRelay) activeRelay->stop();
+}
+
+// Spectator relay: subscribes to a match server on this machine and plays its broadcast
+// back, delayed, to every spectator that joins (game --spectate <ip>[:port])
+int main(int argc, char** argv) {
+    RelayConfig config;
+    std::string serverText = "127.0.0.1";
+    float seconds = 0.0f;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--server" && i + 1 < argc) serverText = argv[++i];
+        else if (arg == "--port" && i + 1 < argc) config.port = (uint16_t)std::stoi(argv[++i]);
+        else if (arg == "--delay" && i + 1 < argc) config.delaySeconds = std::stof(argv[++i]);
+        else if (arg == "--workers" && i + 1 < argc) config.workers = std::stoi(argv[++i]);
+        else if (arg == "--max-spectators" && i + 1 < argc) config.maxSpectators = std::stoi(argv[++i]);
+        else if (arg == "--max-per-address" && i + 1 < argc) config.maxPerAddress = std::stoi(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc) seconds = std::stof(argv[++i]);
+        else std::cerr << "Unknown option " << arg
+                       << " (--server, --port, --delay, --workers, --max-spectators, --max-per-address, --seconds)\n";
+    }
+    if (!config.server.parse(serverText, Protocol::DEFAULT_PORT)) {
+        std::cerr << "ERROR::RELAY::BAD_ADDRESS " << serverText << "\n";
+        return -1;
+    }
+
+    if (!Net::startup()) return -1;
+    int result = 0;
+    {
+        SpectatorRelay relay;
+        if (relay.start(config)) {
+            activeRelay = &relay;
+            std::signal(SIGINT, onSignal);
+            std::signal(SIGTERM, onSignal);
+            relay.run(seconds);
+            activeRelay = nullptr;
+            std::cout << "Relay stopped\n";
+        } else {
+            result = -1;
+        }
+    }
+    Net::cleanup();
+    return result;
+}
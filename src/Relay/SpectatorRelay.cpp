@@ -0,0 +1,366 @@
+#include "SpectatorRelay.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t addressKey(const NetAddress& a) {
+    return ((uint64_t)a.ip << 16) | a.port;
+}
+
+SpectatorRelay::SpectatorRelay() : lastFromServer(Clock::now()), lastKeepAlive(Clock::now()), lastReport(Clock::now()) {
+    std::random_device seed;
+    cookieSecret = ((uint64_t)seed() << 32) ^ seed();
+}
+
+SpectatorRelay::~SpectatorRelay() {
+    running = false;
+    for (auto& w : workers) {
+        { std::lock_guard<std::mutex> lock(w->mutex); }
+        w->wake.notify_all();
+        if (w->thread.joinable()) w->thread.join();
+    }
+    if (socket.isOpen()) {
+        // Let the server stop broadcasting and the spectators stop waiting
+        uint8_t buffer[16];
+        PacketWriter w(buffer, sizeof(buffer));
+        Protocol::writeHeader(w, MessageType::DISCONNECT);
+        socket.sendTo(config.server, buffer, w.getSize());
+        for (const auto& s : spectators) socket.sendTo(s.second.address, buffer, w.getSize());
+    }
+    socket.close();
+}
+
+// Open the spectator port, subscribe to the server (RELAY_CONNECT every 250 ms until it
+// answers) and start the workers
+bool SpectatorRelay::start(const RelayConfig& cfg) {
+    config = cfg;
+    config.workers = std::max(config.workers, 1);
+    if (!socket.open(config.port)) return false;
+
+    bool accepted = false;
+    auto begin = Clock::now();
+    auto lastSend = begin - std::chrono::seconds(1);
+    uint8_t buffer[Protocol::MAX_PACKET];
+    while (!accepted && Clock::now() - begin < std::chrono::seconds(5)) {
+        if (Clock::now() - lastSend > std::chrono::milliseconds(250)) {
+            PacketWriter w(buffer, sizeof(buffer));
+            Protocol::writeHeader(w, MessageType::RELAY_CONNECT);
+            socket.sendTo(config.server, buffer, w.getSize());
+            lastSend = Clock::now();
+        }
+        NetAddress from;
+        int bytes;
+        while (!accepted && (bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+            if (from != config.server) continue;
+            PacketReader r(buffer, bytes);
+            MessageType type;
+            if (!Protocol::readHeader(r, type)) continue;
+            if (type == MessageType::REJECT) {
+                std::cerr << "ERROR::RELAY::REJECTED by " << config.server.toString()
+                          << " (relays must run on the server's machine, up to " << Protocol::MAX_RELAYS << ")\n";
+                socket.close();
+                return false;
+            }
+            if (type != MessageType::RELAY_ACCEPT) continue;
+            r.read<uint32_t>();
+            layout = Protocol::readLayout(r);
+            accepted = !r.isBad();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (!accepted) {
+        std::cerr << "ERROR::RELAY::CONNECT_TIMEOUT " << config.server.toString() << "\n";
+        socket.close();
+        return false;
+    }
+
+    running = true;
+    for (int i = 0; i < config.workers; ++i) {
+        workers.emplace_back(new Worker());
+        Worker* w = workers.back().get();
+        w->thread = std::thread([this, w] { runWorker(*w); });
+    }
+    lastFromServer = lastKeepAlive = lastReport = Clock::now();
+    std::cout << "Relay on UDP port " << socket.getPort() << " for " << config.server.toString() << ": "
+              << config.delaySeconds << " s delay, " << config.workers << " workers, up to " << config.maxSpectators
+              << " spectators\n";
+    return true;
+}
+
+// Receive, delay and hand out frames until stop() or seconds have passed
+void SpectatorRelay::run(float seconds) {
+    auto begin = Clock::now();
+    while (running) {
+        auto now = Clock::now();
+        if (seconds > 0.0f && std::chrono::duration<float>(now - begin).count() >= seconds) break;
+
+        receivePackets();
+        playBack();
+
+        // The match is gone: tell the spectators instead of leaving them on a silent relay
+        if (std::chrono::duration<float>(now - lastFromServer).count() > Protocol::TIMEOUT_SECONDS) {
+            std::cerr << "ERROR::RELAY::SERVER_TIMEOUT " << config.server.toString() << "\n";
+            dropSpectators();
+            break;
+        }
+
+        // Stay subscribed, and drop spectators that went silent
+        if (now - lastKeepAlive > std::chrono::seconds(1)) {
+            uint8_t buffer[16];
+            PacketWriter w(buffer, sizeof(buffer));
+            Protocol::writeHeader(w, MessageType::RELAY_CONNECT);
+            socket.sendTo(config.server, buffer, w.getSize());
+            lastKeepAlive = now;
+
+            std::vector<NetAddress> silent;
+            for (const auto& s : spectators) {
+                if (std::chrono::duration<float>(now - s.second.lastHeard).count() > Protocol::TIMEOUT_SECONDS)
+                    silent.push_back(s.second.address);
+            }
+            for (const NetAddress& a : silent) removeSpectator(a);
+        }
+
+        if (std::chrono::duration<float>(now - lastReport).count() > 2.0f) report();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    running = false;
+}
+
+// Broadcast packets are gathered into the frame of their tick; the frame is complete when
+// the next one starts or a few milliseconds after its first packet (they come back to back)
+void SpectatorRelay::receivePackets() {
+    auto seal = [this] {
+        delayedBytes += (long long)building->data.size();
+        delayed.push_back(std::move(building));
+        building.reset();
+        framesIn++;
+    };
+
+    uint8_t buffer[Protocol::MAX_PACKET];
+    NetAddress from;
+    int bytes;
+    while ((bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+        PacketReader r(buffer, bytes);
+        MessageType type;
+        if (!Protocol::readHeader(r, type)) continue;
+        if (from == config.server) {
+            lastFromServer = Clock::now();
+            if (type != MessageType::BROADCAST) continue;
+            packetsIn++;
+            bytesIn += bytes;
+            uint32_t tick = r.read<uint32_t>();
+            if (building && building->tick != tick) seal();
+            if (!building) {
+                building = std::make_shared<BroadcastFrame>();
+                building->tick = tick;
+                building->received = Clock::now();
+            }
+            building->data.insert(building->data.end(), buffer, buffer + bytes);
+            building->sizes.push_back((uint16_t)bytes);
+        } else if (type == MessageType::SPECTATE) {
+            uint32_t cookie = r.read<uint32_t>();
+            if (!r.isBad()) handleSpectate(from, cookie);
+        } else if (type == MessageType::DISCONNECT) {
+            removeSpectator(from);
+        }
+    }
+    if (building && Clock::now() - building->received > std::chrono::milliseconds(5)) seal();
+}
+
+// Mix the address into the secret (splitmix64 finalizer); never 0, which means "no cookie yet"
+uint32_t SpectatorRelay::cookieFor(const NetAddress& address) const {
+    uint64_t h = cookieSecret ^ (addressKey(address) * 0x9E3779B97F4A7C15ull);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return (uint32_t)h | 1u;
+}
+
+void SpectatorRelay::handleSpectate(const NetAddress& from, uint32_t cookie) {
+    uint8_t buffer[64];
+    PacketWriter w(buffer, sizeof(buffer));
+
+    // No echo of our cookie yet: send it and forget the request. The reply is no larger than
+    // the request, and only the real owner of the address sees it.
+    uint32_t expected = cookieFor(from);
+    if (cookie != expected) {
+        Protocol::writeHeader(w, MessageType::SPECTATE_CHALLENGE);
+        w.write(expected);
+        socket.sendTo(from, buffer, w.getSize());
+        return;
+    }
+
+    auto it = spectators.find(addressKey(from));
+    if (it == spectators.end()) {
+        int& fromIp = perAddress[from.ip];
+        if ((int)spectators.size() >= config.maxSpectators || fromIp >= config.maxPerAddress) {
+            if (fromIp == 0) perAddress.erase(from.ip);
+            Protocol::writeHeader(w, MessageType::REJECT);
+            socket.sendTo(from, buffer, w.getSize());
+            return;
+        }
+        // To the worker with the fewest spectators
+        Spectator s;
+        s.address = from;
+        size_t fewest = 0;
+        for (int i = 0; i < (int)workers.size(); ++i) {
+            std::lock_guard<std::mutex> lock(workers[i]->mutex);
+            if (i == 0 || workers[i]->spectators.size() < fewest) {
+                fewest = workers[i]->spectators.size();
+                s.worker = i;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(workers[s.worker]->mutex);
+            workers[s.worker]->spectators.push_back(from);
+            workers[s.worker]->changed = true;
+        }
+        it = spectators.emplace(addressKey(from), s).first;
+        fromIp++;
+        if (config.verbose && spectators.size() <= 8) std::cout << "Spectator " << from.toString() << " joined\n";
+    }
+    it->second.lastHeard = Clock::now();
+
+    // Answered every time, so a lost accept is simply retried
+    Protocol::writeHeader(w, MessageType::SPECTATE_ACCEPT);
+    Protocol::writeLayout(w, layout);
+    w.write(config.delaySeconds);
+    socket.sendTo(from, buffer, w.getSize());
+}
+
+void SpectatorRelay::removeSpectator(const NetAddress& address) {
+    auto it = spectators.find(addressKey(address));
+    if (it == spectators.end()) return;
+    Worker& w = *workers[it->second.worker];
+    {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        auto pos = std::find(w.spectators.begin(), w.spectators.end(), address);
+        if (pos != w.spectators.end()) {
+            *pos = w.spectators.back();
+            w.spectators.pop_back();
+            w.changed = true;
+        }
+    }
+    auto ip = perAddress.find(address.ip);
+    if (ip != perAddress.end() && --ip->second <= 0) perAddress.erase(ip);
+    spectators.erase(it);
+}
+
+// Send DISCONNECT to every spectator and forget them all
+void SpectatorRelay::dropSpectators() {
+    uint8_t buffer[16];
+    PacketWriter w(buffer, sizeof(buffer));
+    Protocol::writeHeader(w, MessageType::DISCONNECT);
+    std::vector<NetAddress> all;
+    for (const auto& s : spectators) all.push_back(s.second.address);
+    for (const NetAddress& a : all) {
+        socket.sendTo(a, buffer, w.getSize());
+        removeSpectator(a);
+    }
+}
+
+// Frames whose delay is over go to every worker; the delay queue's reference goes with them
+void SpectatorRelay::playBack() {
+    auto delay = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.delaySeconds));
+    auto now = Clock::now();
+    while (!delayed.empty() && now - delayed.front()->received >= delay) {
+        const std::shared_ptr<const BroadcastFrame>& frame = delayed.front();
+        for (auto& w : workers) {
+            {
+                std::lock_guard<std::mutex> lock(w->mutex);
+                if ((int)w->inbox.size() >= MAX_INBOX) {
+                    w->inbox.pop_front();
+                    w->dropped++;
+                }
+                w->inbox.push_back(frame);
+            }
+            w->wake.notify_one();
+        }
+        delayedBytes -= (long long)frame->data.size();
+        delayed.pop_front();
+    }
+}
+
+// Send each frame's packets, as they are, to every spectator of this worker
+void SpectatorRelay::runWorker(Worker& w) {
+    std::vector<NetAddress> targets;
+    while (true) {
+        std::shared_ptr<const BroadcastFrame> frame;
+        {
+            std::unique_lock<std::mutex> lock(w.mutex);
+            w.wake.wait(lock, [&] { return !w.inbox.empty() || !running; });
+            if (!running) break;
+            frame = std::move(w.inbox.front());
+            w.inbox.pop_front();
+            if (w.changed) {
+                targets = w.spectators;
+                w.changed = false;
+            }
+        }
+
+        auto start = Clock::now();
+        long long packets = 0, bytes = 0, failed = 0;
+        const uint8_t* data = frame->data.data();
+        for (uint16_t size : frame->sizes) {
+            for (const NetAddress& to : targets) {
+                if (socket.sendTo(to, data, size)) {
+                    packets++;
+                    bytes += size;
+                } else {
+                    failed++;
+                }
+            }
+            data += size;
+        }
+        frame.reset();   // The last worker to get here frees the frame
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.busyMs += ms;
+        w.packets += packets;
+        w.bytes += bytes;
+        w.failed += failed;
+    }
+}
+
+// Debug output every 2 seconds
+void SpectatorRelay::report() {
+    auto now = Clock::now();
+    float seconds = std::chrono::duration<float>(now - lastReport).count();
+    double busyMs = 0;
+    long long packets = 0, bytes = 0, failed = 0;
+    int dropped = 0;
+    for (auto& w : workers) {
+        std::lock_guard<std::mutex> lock(w->mutex);
+        busyMs += w->busyMs;
+        packets += w->packets;
+        bytes += w->bytes;
+        failed += w->failed;
+        dropped += w->dropped;
+        w->busyMs = 0;
+        w->packets = w->bytes = w->failed = 0;
+        w->dropped = 0;
+    }
+
+    if (config.verbose) {
+        float busy = (float)(busyMs / (seconds * 1000.0));   // Cores' worth of fan-out
+        float delayed_s = delayed.empty() ? 0.0f : std::chrono::duration<float>(now - delayed.front()->received).count();
+        std::cout << "[DEBUG] Relay: " << spectators.size() << " spectators | in " << packetsIn / seconds << " pkt/s "
+                  << bytesIn / seconds / 1024.0f << " KB/s, " << framesIn / seconds << " frames/s, holding "
+                  << delayed.size() << " frames (" << delayed_s << " s, " << delayedBytes / 1024 << " KB) | out "
+                  << packets / seconds << " pkt/s " << bytes / seconds / (1024.0f * 1024.0f) << " MB/s";
+        if (failed > 0) std::cout << ", " << failed << " sends failed";
+        if (dropped > 0) std::cout << ", " << dropped << " frames dropped by slow workers";
+        std::cout << " | fan-out " << busy * 100.0f << "% of a core";
+        if (packets > 0) std::cout << ", " << busyMs * 1000.0 / packets << " us per packet";
+        // Every spectator gets every packet the server sent, so a core keeps up with this many
+        if (busy > 0.01f && packetsIn > 0)
+            std::cout << " (" << (int)(packets / busy / packetsIn) << " spectators per core at full rate)";
+        std::cout << "\n";
+    }
+    packetsIn = bytesIn = 0;
+    framesIn = 0;
+    lastReport = now;
+}
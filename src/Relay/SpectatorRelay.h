@@ -0,0 +1,128 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../Net/Socket.h"
+#include "../Net/Protocol.h"
+
+// Settings for a spectator relay
+struct RelayConfig {
+    NetAddress server;                // Match server; it only accepts relays on its own machine
+    uint16_t port = Protocol::DEFAULT_RELAY_PORT;
+    float delaySeconds = 10.0f;       // Playback delay, so spectators cannot feed players live positions
+    int workers = 1;                  // Fan-out threads
+    int maxSpectators = 20000;
+    int maxPerAddress = 4;            // Spectators behind one IP address
+    bool verbose = true;              // Join / leave lines and the 2 second report
+};
+
+// One frame of the server's broadcast, stored once. The delay queue and every fan-out worker
+// share it (refcounted); it is freed when the last worker has sent it.
+struct BroadcastFrame {
+    uint32_t tick = 0;
+    std::chrono::steady_clock::time_point received;
+    std::vector<uint8_t> data;        // The frame's packets back to back
+    std::vector<uint16_t> sizes;
+};
+
+// SpectatorRelay fans one match broadcast out to many spectators
+// It subscribes to a GameServer on the same machine, which encodes one broadcast frame per
+// snapshot (every player and every enemy, delta coded against the previous frame). Packets
+// are gathered into a BroadcastFrame as they arrive and held for delaySeconds. Then every
+// worker gets a reference to the frame and sends its packets, unchanged, to each of its
+// spectators: nothing is encoded per spectator, so a spectator costs one send per packet.
+// Spectators join with SPECTATE, repeat it every second to stay, and are dropped after
+// Protocol::TIMEOUT_SECONDS of silence. A SPECTATE only counts when it echoes the cookie the
+// relay sent to that address (SPECTATE_CHALLENGE, no bigger than the request), so a spoofed
+// source address never gets the stream: the relay cannot be used to flood someone else.
+class SpectatorRelay {
+public:
+    static const int MAX_INBOX = 20;  // Frames a worker may fall behind before the oldest is dropped
+
+    SpectatorRelay();
+    ~SpectatorRelay();
+
+    // Open the spectator port, subscribe to the server and start the workers;
+    // false if the server did not accept the relay
+    bool start(const RelayConfig& config);
+
+    // Receive, delay and hand out frames until stop(), seconds have passed (0 = until stop())
+    // or the server is gone; then the spectators get DISCONNECT
+    void run(float seconds = 0.0f);
+
+    // Ask run() to return (any thread)
+    void stop() { running = false; }
+
+    int getSpectatorCount() const { return (int)spectators.size(); }
+    uint16_t getPort() const { return socket.getPort(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Spectator {
+        NetAddress address;
+        Clock::time_point lastHeard;
+        int worker = 0;
+    };
+
+    // A fan-out thread and the spectators it serves
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::shared_ptr<const BroadcastFrame>> inbox;
+        std::vector<NetAddress> spectators;
+        bool changed = false;                 // Spectators changed since the thread copied them
+
+        // Over the report window, under mutex
+        double busyMs = 0;
+        long long packets = 0, bytes = 0, failed = 0;
+        int dropped = 0;                      // Frames skipped because the worker fell behind
+    };
+
+    RelayConfig config;
+    UdpSocket socket;                         // Shared: received on here, sent on by the workers
+    WorldLayout layout;
+    std::atomic<bool> running{false};
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unordered_map<uint64_t, Spectator> spectators;   // By address
+    std::unordered_map<uint32_t, int> perAddress;         // Spectators by IP
+    uint64_t cookieSecret = 0;                            // Random per relay run
+
+    std::shared_ptr<BroadcastFrame> building;              // Frame whose packets are arriving
+    std::deque<std::shared_ptr<const BroadcastFrame>> delayed;
+    long long delayedBytes = 0;
+    Clock::time_point lastFromServer;         // run() gives up after Protocol::TIMEOUT_SECONDS without it
+    Clock::time_point lastKeepAlive;
+
+    // Report window
+    Clock::time_point lastReport;
+    long long packetsIn = 0, bytesIn = 0;
+    int framesIn = 0;
+
+    // Datagrams from the server and from spectators
+    void receivePackets();
+    void handleSpectate(const NetAddress& from, uint32_t cookie);
+
+    // Cookie for an address: derived from the secret, so nothing is stored before the echo
+    uint32_t cookieFor(const NetAddress& address) const;
+    void removeSpectator(const NetAddress& address);
+
+    // The server went away (Protocol::TIMEOUT_SECONDS of silence)
+    void dropSpectators();
+
+    // Frames whose delay is over go to every worker
+    void playBack();
+
+    void runWorker(Worker& worker);
+
+    // Debug output every 2 seconds
+    void report();
+};
@@ -0,0 +1,372 @@
+#include "RenderQueue.h"
+#include <glad/glad.h>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+// Static timer for debug output
+static auto lastQueueDebug = std::chrono::steady_clock::now();
+
+// Key layout (high to low): pass 4 | program 8 | VAO 8 | depth 24 | sequence 20
+static const int PASS_SHIFT = 60;
+static const int PROGRAM_SHIFT = 52;
+static const int VAO_SHIFT = 44;
+static const int DEPTH_SHIFT = 20;
+static const unsigned long long DEPTH_MAX = (1ull << 24) - 1;
+static const unsigned long long SEQUENCE_MAX = (1ull << 20) - 1;
+
+// Constructor
+RenderQueue::RenderQueue()
+    : eye(0.0f), farPlane(100.0f), streamsCreated(false), frameOffset(0), uboAlignment(256) {
+    frame.view = frame.projection = frame.viewProj = glm::mat4(1.0f);
+    frame.time = glm::vec4(0.0f);
+}
+
+// Create the stream buffers (first execute on the GL thread)
+void RenderQueue::createBuffers() {
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlignment);
+    if (uboAlignment <= 0) uboAlignment = 256;
+
+    uniformStream.create(GL_UNIFORM_BUFFER, UNIFORM_STREAM_BYTES);
+    vertexStream.create(GL_ARRAY_BUFFER, VERTEX_STREAM_BYTES);
+    streamsCreated = true;
+}
+
+// Look up and cache the uniform locations used by packets of this program
+void RenderQueue::registerProgram(unsigned int program, const char* transformName, const char* colorName) {
+    ProgramInfo info;
+    info.id = program;
+
+    // Uniform blocks get fixed binding points; the buffers are bound once per frame / batch
+    unsigned int frameBlock = glGetUniformBlockIndex(program, "FrameData");
+    unsigned int objectBlock = glGetUniformBlockIndex(program, "ObjectBlock");
+    if (frameBlock != GL_INVALID_INDEX) glUniformBlockBinding(program, frameBlock, FRAME_BINDING);
+    if (objectBlock != GL_INVALID_INDEX) glUniformBlockBinding(program, objectBlock, OBJECT_BINDING);
+    info.objectBlock = objectBlock != GL_INVALID_INDEX;
+
+    info.transformLoc = transformName ? glGetUniformLocation(program, transformName) : -1;
+    info.colorLoc = colorName ? glGetUniformLocation(program, colorName) : -1;
+    info.hasTransform = false;
+    info.hasColor = false;
+
+    for (auto& p : programs) {
+        if (p.id == program) {
+            p = info;
+            return;
+        }
+    }
+    programs.push_back(info);
+}
+
+// Start a new frame of recording
+void RenderQueue::beginFrame(const glm::vec3& eyePos, float far) {
+    packets.clear();
+    eye = eyePos;
+    farPlane = far;
+}
+
+// Camera data for the FrameData uniform block
+void RenderQueue::setFrameConstants(const glm::mat4& view, const glm::mat4& projection, float time) {
+    frame.view = view;
+    frame.projection = projection;
+    frame.viewProj = projection * view;
+    frame.time = glm::vec4(time, 0.0f, 0.0f, 0.0f);
+}
+
+// Registered program info, or nullptr
+RenderQueue::ProgramInfo* RenderQueue::findProgram(unsigned int program) {
+    for (auto& p : programs) {
+        if (p.id == program) return &p;
+    }
+    return nullptr;
+}
+
+// Index of a registered program (unregistered programs sort last)
+int RenderQueue::programSlot(unsigned int program) {
+    for (size_t i = 0; i < programs.size(); ++i) {
+        if (programs[i].id == program) return (int)i;
+    }
+    return 255;
+}
+
+// Index of a VAO, assigned the first time it is seen
+int RenderQueue::vaoSlot(unsigned int vao) {
+    for (size_t i = 0; i < vaos.size(); ++i) {
+        if (vaos[i] == vao) return (int)i;
+    }
+    vaos.push_back(vao);
+    return (int)vaos.size() - 1;
+}
+
+// Pack pass, state and depth into a key; the sequence number keeps submission order on ties
+unsigned long long RenderQueue::makeKey(RenderPass pass, unsigned int program, unsigned int vao, float depth) {
+    unsigned long long d = (unsigned long long)(glm::clamp(depth, 0.0f, 1.0f) * DEPTH_MAX);
+    unsigned long long seq = packets.size() & SEQUENCE_MAX;
+    return ((unsigned long long)pass << PASS_SHIFT) |
+           ((unsigned long long)(programSlot(program) & 0xFF) << PROGRAM_SHIFT) |
+           ((unsigned long long)(vaoSlot(vao) & 0xFF) << VAO_SHIFT) |
+           (d << DEPTH_SHIFT) | seq;
+}
+
+// Record a static mesh draw; opaque geometry is sorted front to back
+void RenderQueue::drawMesh(RenderPass pass, unsigned int program, unsigned int vao, unsigned int mode, int count,
+                           bool indexed, const glm::mat4& transform, const glm::vec3& color, const glm::vec3& worldPos) {
+    DrawPacket p;
+    p.key = makeKey(pass, program, vao, glm::distance(eye, worldPos) / farPlane);
+    p.program = program;
+    p.vao = vao;
+    p.mode = mode;
+    p.count = count;
+    p.indexed = indexed;
+    p.transform = transform;
+    p.color = color;
+    p.vertexFloats = 0;
+    packets.push_back(p);
+}
+
+// Record a draw with inline vertices; these keep submission order within their pass
+void RenderQueue::drawDynamic(RenderPass pass, unsigned int program, unsigned int vao, unsigned int mode,
+                              const float* vertices, int floatCount, int vertexCount,
+                              const glm::mat4& transform, const glm::vec3& color) {
+    DrawPacket p;
+    p.key = makeKey(pass, program, vao, 0.0f);
+    p.program = program;
+    p.vao = vao;
+    p.mode = mode;
+    p.count = vertexCount;
+    p.indexed = false;
+    p.transform = transform;
+    p.color = color;
+    p.vertexFloats = floatCount < 8 ? floatCount : 8;
+    std::memcpy(p.vertices, vertices, sizeof(float) * p.vertexFloats);
+    packets.push_back(p);
+}
+
+// LSD radix sort over 8-bit digits; digits shared by every key are skipped
+void RenderQueue::sortPackets() {
+    size_t n = packets.size();
+    sortKeys.resize(n);
+    tempKeys.resize(n);
+    order.resize(n);
+    tempOrder.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        sortKeys[i] = packets[i].key;
+        order[i] = (unsigned int)i;
+    }
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        unsigned int counts[256] = {0};
+        for (size_t i = 0; i < n; ++i) counts[(sortKeys[i] >> shift) & 0xFF]++;
+        if (n == 0 || counts[(sortKeys[0] >> shift) & 0xFF] == n) continue;
+
+        unsigned int offset = 0;
+        for (int d = 0; d < 256; ++d) {
+            unsigned int c = counts[d];
+            counts[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            unsigned int dst = counts[(sortKeys[i] >> shift) & 0xFF]++;
+            tempKeys[dst] = sortKeys[i];
+            tempOrder[dst] = order[i];
+        }
+        sortKeys.swap(tempKeys);
+        order.swap(tempOrder);
+    }
+}
+
+// Packets that can share one instanced draw with the packet before them
+bool RenderQueue::canBatch(const DrawPacket& a, const DrawPacket& b) const {
+    return (a.key >> PASS_SHIFT) == (b.key >> PASS_SHIFT) && a.program == b.program && a.vao == b.vao &&
+           a.mode == b.mode && a.count == b.count && a.indexed == b.indexed &&
+           a.vertexFloats == 0 && b.vertexFloats == 0;
+}
+
+// Write frame constants, object data and inline vertices into the streams
+// Everything is sized first, so a stream can grow before anything is written to it
+void RenderQueue::streamFrameData() {
+    const int blockBytes = OBJECTS_PER_BLOCK * (int)sizeof(ObjectData);
+    int uniformBytes = (int)sizeof(FrameConstants) + uboAlignment;
+    int vertexBytes = 0;
+    for (const Batch& batch : batches) {
+        if (batch.objects) uniformBytes += batch.count * (int)sizeof(ObjectData) + uboAlignment;
+        vertexBytes += packets[order[batch.first]].vertexFloats * (int)sizeof(float) + (int)sizeof(float);
+    }
+    // glBindBufferRange always covers a whole ObjectBlock, even for the last batch
+    uniformBytes += blockBytes;
+
+    uniformStream.beginFrame(uniformBytes);
+    vertexStream.beginFrame(vertexBytes);
+
+    void* dst = uniformStream.allocate(sizeof(FrameConstants), uboAlignment, frameOffset);
+    std::memcpy(dst, &frame, sizeof(FrameConstants));
+
+    for (Batch& batch : batches) {
+        if (batch.objects) {
+            ObjectData* objects = (ObjectData*)uniformStream.allocate(batch.count * sizeof(ObjectData),
+                                                                      uboAlignment, batch.objectOffset);
+            for (int k = 0; k < batch.count; ++k) {
+                const DrawPacket& p = packets[order[batch.first + k]];
+                objects[k].model = p.transform;
+                objects[k].color = glm::vec4(p.color, 1.0f);
+            }
+        }
+
+        const DrawPacket& p = packets[order[batch.first]];
+        if (p.vertexFloats > 0) {
+            dst = vertexStream.allocate(p.vertexFloats * sizeof(float), sizeof(float), batch.vertexOffset);
+            std::memcpy(dst, p.vertices, p.vertexFloats * sizeof(float));
+        }
+    }
+
+    uniformStream.flush();
+    vertexStream.flush();
+    stats.streamBytes = uniformStream.getStats().bytes + vertexStream.getStats().bytes;
+    stats.streamStalls = uniformStream.getStats().stalls + vertexStream.getStats().stalls;
+}
+
+// Sort and issue all packets with redundant state changes filtered out
+void RenderQueue::execute() {
+    prepare();
+    executePasses(PASS_OPAQUE, PASS_OVERLAY);
+    finish();
+}
+
+// Sort packets, build draws and stream their data
+void RenderQueue::prepare() {
+    if (!streamsCreated) createBuffers();
+    sortPackets();
+
+    stats = Stats();
+    stats.packets = (int)packets.size();
+    for (auto& p : programs) {
+        p.hasTransform = false;
+        p.hasColor = false;
+    }
+
+    // Group sorted packets into draws; runs of object-block packets share one instanced draw
+    batches.clear();
+    size_t n = order.size();
+    for (size_t i = 0; i < n;) {
+        const DrawPacket& first = packets[order[i]];
+        ProgramInfo* info = findProgram(first.program);
+
+        Batch batch;
+        batch.first = i;
+        batch.count = 1;
+        batch.objects = info && info->objectBlock;
+        batch.objectOffset = 0;
+        batch.vertexOffset = 0;
+        if (batch.objects) {
+            while (i + batch.count < n && batch.count < OBJECTS_PER_BLOCK &&
+                   canBatch(first, packets[order[i + batch.count]])) batch.count++;
+        }
+        batches.push_back(batch);
+        i += batch.count;
+    }
+    streamFrameData();
+}
+
+// Issue the prepared draws of passes firstPass..lastPass
+void RenderQueue::executePasses(RenderPass firstPass, RenderPass lastPass) {
+    // Camera data: one range bound for all draws
+    glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_BINDING, uniformStream.getBuffer(), frameOffset, sizeof(FrameConstants));
+
+    // Unknown state at the start: the first bind of each kind is always issued
+    unsigned int curProgram = ~0u, curVAO = ~0u, curBuffer = ~0u;
+    int curPass = -1;
+    ProgramInfo* info = nullptr;
+
+    for (const Batch& batch : batches) {
+        const DrawPacket& p = packets[order[batch.first]];
+
+        int pass = (int)(p.key >> PASS_SHIFT);
+        if (pass < firstPass || pass > lastPass) continue;
+        if (pass != curPass) {
+            if (pass <= PASS_LINES) glEnable(GL_DEPTH_TEST);
+            else glDisable(GL_DEPTH_TEST);
+            glLineWidth(pass == PASS_LINES ? 3.0f : 1.0f);
+            curPass = pass;
+        }
+
+        if (p.program != curProgram) {
+            glUseProgram(p.program);
+            curProgram = p.program;
+            stats.programBinds++;
+            info = findProgram(p.program);
+        }
+
+        if (p.vao != curVAO) {
+            glBindVertexArray(p.vao);
+            curVAO = p.vao;
+            stats.vaoBinds++;
+        }
+
+        if (p.vertexFloats > 0) {
+            // Point the dynamic VAO at this packet's vertices in the stream
+            if (vertexStream.getBuffer() != curBuffer) {
+                glBindBuffer(GL_ARRAY_BUFFER, vertexStream.getBuffer());
+                curBuffer = vertexStream.getBuffer();
+                stats.bufferBinds++;
+            }
+            int components = p.vertexFloats / p.count;
+            glVertexAttribPointer(0, components, GL_FLOAT, GL_FALSE, components * sizeof(float),
+                                  (void*)(size_t)batch.vertexOffset);
+        }
+
+        if (batch.objects) {
+            // Instance i of this draw reads uObjects[i] from its range of the uniform stream
+            glBindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BINDING, uniformStream.getBuffer(), batch.objectOffset,
+                              OBJECTS_PER_BLOCK * sizeof(ObjectData));
+            if (p.indexed) glDrawElementsInstanced(p.mode, p.count, GL_UNSIGNED_INT, 0, batch.count);
+            else glDrawArraysInstanced(p.mode, 0, p.count, batch.count);
+            stats.instances += batch.count;
+            stats.drawCalls++;
+            continue;
+        }
+
+        // Upload uniforms only when they differ from what the program already holds
+        if (info && info->transformLoc >= 0 &&
+            (!info->hasTransform || std::memcmp(&info->lastTransform, &p.transform, sizeof(glm::mat4)) != 0)) {
+            glUniformMatrix4fv(info->transformLoc, 1, GL_FALSE, &p.transform[0][0]);
+            info->lastTransform = p.transform;
+            info->hasTransform = true;
+            stats.uniformUploads++;
+        }
+        if (info && info->colorLoc >= 0 && (!info->hasColor || info->lastColor != p.color)) {
+            glUniform3fv(info->colorLoc, 1, &p.color[0]);
+            info->lastColor = p.color;
+            info->hasColor = true;
+            stats.uniformUploads++;
+        }
+
+        if (p.indexed) glDrawElements(p.mode, p.count, GL_UNSIGNED_INT, 0);
+        else glDrawArrays(p.mode, 0, p.count);
+        stats.drawCalls++;
+    }
+
+    // Leave state the way the immediate-mode GUI code expects it
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glLineWidth(1.0f);
+    glEnable(GL_DEPTH_TEST);
+}
+
+// Fence the streamed data and clear the queue
+void RenderQueue::finish() {
+    // The regions written this frame are reused once the GPU has passed this point
+    uniformStream.endFrame();
+    vertexStream.endFrame();
+    packets.clear();
+
+    // Debug output every 2 seconds
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - lastQueueDebug).count() > 2.0f) {
+        std::cout << "[DEBUG] RenderQueue: " << stats.packets << " packets, " << stats.drawCalls << " draws ("
+                  << stats.instances << " instances), " << stats.programBinds << " program / "
+                  << stats.vaoBinds << " VAO / " << stats.bufferBinds << " buffer binds, "
+                  << stats.streamBytes << " bytes streamed (" << stats.streamStalls << " stalls, "
+                  << (uniformStream.isPersistent() ? "persistent" : "orphaning") << ")\n";
+        lastQueueDebug = now;
+    }
+}
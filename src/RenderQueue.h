@@ -0,0 +1,173 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include "StreamBuffer.h"
+
+// Render passes, executed in this order
+enum RenderPass {
+    PASS_OPAQUE = 0,   // World and enemy cubes (depth test on)
+    PASS_LINES = 1,    // Tracer lines (depth test on, wide lines)
+    PASS_HUD = 2,      // HUD bars and text (depth test off)
+    PASS_OVERLAY = 3   // Crosshair (depth test off)
+};
+
+// One recorded draw call
+// Subsystems fill these instead of calling OpenGL directly
+struct DrawPacket {
+    unsigned long long key;   // Sort key: pass | program | VAO | depth | sequence
+    unsigned int program;     // Shader program
+    unsigned int vao;         // Vertex array object
+    unsigned int mode;        // GL primitive type
+    int count;                // Index or vertex count
+    bool indexed;             // glDrawElements instead of glDrawArrays
+    glm::mat4 transform;      // Model matrix (object-block programs) or transform uniform value
+    glm::vec3 color;          // Object color or color uniform value
+    float vertices[8];        // Inline dynamic vertices (HUD quad or tracer line)
+    int vertexFloats;         // Number of floats used in vertices
+};
+
+// Per-frame camera constants, laid out as the std140 FrameData uniform block
+struct FrameConstants {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProj;
+    glm::vec4 time;           // x = seconds since start
+};
+
+// Per-object entry of the ObjectBlock uniform block (std140)
+struct ObjectData {
+    glm::mat4 model;
+    glm::vec4 color;
+};
+
+// RenderQueue collects draw packets during the frame, sorts them by key
+// (radix sort) and executes them once, skipping redundant GL state changes
+//
+// Programs with FrameData / ObjectBlock uniform blocks (basic.vert) get camera data
+// and their model matrix and color from a streamed uniform buffer;
+// consecutive packets with the same mesh become one instanced draw.
+// All per-frame data (uniform blocks, inline vertices) goes through fenced StreamBuffers
+class RenderQueue {
+public:
+    // Uniform block binding points
+    static const int FRAME_BINDING = 0;
+    static const int OBJECT_BINDING = 1;
+
+    // Size of the uObjects array in basic.vert (instances per draw)
+    static const int OBJECTS_PER_BLOCK = 128;
+
+    // Initial size of one frame region of the uniform / vertex streams (they grow if a frame needs more)
+    static const int UNIFORM_STREAM_BYTES = 256 * 1024;
+    static const int VERTEX_STREAM_BYTES = 64 * 1024;
+
+    // Per-frame counters of GL work actually issued
+    struct Stats {
+        int packets = 0;
+        int drawCalls = 0;
+        int instances = 0;        // Objects drawn with per-object uniform data
+        int programBinds = 0;
+        int vaoBinds = 0;
+        int bufferBinds = 0;
+        int uniformUploads = 0;
+        int streamBytes = 0;      // Bytes written to the stream buffers
+        int streamStalls = 0;     // Waits on a stream buffer fence
+    };
+
+    RenderQueue();
+
+    // Register a program and the names of its transform / color uniforms (nullptr = none)
+    // Programs with an ObjectBlock uniform block take transform and color from the object ring instead
+    // Must be called on the GL thread before packets use the program
+    void registerProgram(unsigned int program, const char* transformName, const char* colorName);
+
+    // Start recording a new frame; eye is used to compute packet depth
+    void beginFrame(const glm::vec3& eye, float farPlane);
+
+    // Camera data for the FrameData uniform block, uploaded once in execute()
+    void setFrameConstants(const glm::mat4& view, const glm::mat4& projection, float time);
+
+    // Record a draw from a static VAO
+    void drawMesh(RenderPass pass, unsigned int program, unsigned int vao, unsigned int mode, int count,
+                  bool indexed, const glm::mat4& transform, const glm::vec3& color, const glm::vec3& worldPos);
+
+    // Record a draw with inline vertices, streamed into the vertex buffer at execute time
+    // vao must be dedicated to dynamic draws: its attribute 0 is pointed at the stream on every draw
+    void drawDynamic(RenderPass pass, unsigned int program, unsigned int vao, unsigned int mode,
+                     const float* vertices, int floatCount, int vertexCount,
+                     const glm::mat4& transform, const glm::vec3& color);
+
+    // Sort all recorded packets and issue them; clears the queue afterwards
+    void execute();
+
+    // execute() in steps, so render targets can change between passes:
+    // prepare() once, executePasses() for each pass range, then finish()
+    void prepare();
+    void executePasses(RenderPass firstPass, RenderPass lastPass);
+    void finish();
+
+    // Counters from the last execute()
+    const Stats& getStats() const { return stats; }
+
+private:
+    // Run of sorted packets issued with one draw call
+    struct Batch {
+        size_t first;         // Index into order
+        int count;            // Packets (instances) in the run
+        bool objects;         // Uses per-object uniform data
+        int objectOffset;     // Offset of that data in the uniform stream
+        int vertexOffset;     // Offset of inline vertices in the vertex stream
+    };
+
+    // Cached uniform locations of a registered program and the last values uploaded
+    struct ProgramInfo {
+        unsigned int id;
+        bool objectBlock;     // Transform / color come from the object ring
+        int transformLoc;
+        int colorLoc;
+        bool hasTransform;
+        bool hasColor;
+        glm::mat4 lastTransform;
+        glm::vec3 lastColor;
+    };
+
+    std::vector<DrawPacket> packets;             // Packets recorded this frame
+    std::vector<ProgramInfo> programs;           // Registered programs (index = key slot)
+    std::vector<unsigned int> vaos;              // VAOs seen so far (index = key slot)
+    std::vector<unsigned long long> sortKeys;    // Radix sort scratch buffers
+    std::vector<unsigned long long> tempKeys;
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> tempOrder;
+    std::vector<Batch> batches;                  // Draw calls of the frame, in execution order
+    glm::vec3 eye;
+    float farPlane;
+    FrameConstants frame;
+    Stats stats;
+
+    StreamBuffer uniformStream;                  // FrameData and ObjectBlock ranges
+    StreamBuffer vertexStream;                   // Inline vertices
+    bool streamsCreated;
+    int frameOffset;                             // FrameData range in the uniform stream
+    int uboAlignment;                            // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+
+    // Create the stream buffers (first execute on the GL thread)
+    void createBuffers();
+
+    // Write frame constants, object data and inline vertices into the streams
+    void streamFrameData();
+
+    // Packets that can share one instanced draw with the packet before them
+    bool canBatch(const DrawPacket& a, const DrawPacket& b) const;
+
+    // Build the 64-bit sort key for a packet
+    unsigned long long makeKey(RenderPass pass, unsigned int program, unsigned int vao, float depth);
+
+    // Registered program info, or nullptr
+    ProgramInfo* findProgram(unsigned int program);
+
+    // Small index of a program / VAO for the sort key
+    int programSlot(unsigned int program);
+    int vaoSlot(unsigned int vao);
+
+    // LSD radix sort of packet indices by key, 8 bits per pass
+    void sortPackets();
+};
@@ -0,0 +1,764 @@
+#include "GameServer.h"
+#include "../TickClock.h"
+#include "../Shooter.h"
+#include "../Item.h"
+#include "../Net/PlayerMove.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+GameServer::GameServer() : lastReport(Clock::now()) {}
+
+GameServer::~GameServer() {
+    socket.close();
+}
+
+// Bind the socket and build the world and enemies
+bool GameServer::start(const ServerConfig& cfg) {
+    config = cfg;
+    config.maxPlayers = std::max(1, std::min(config.maxPlayers, Protocol::MAX_PLAYERS));
+    if (!socket.open(config.port)) return false;
+
+    // The whole arena stays loaded: every player can be anywhere
+    // Built inline: a hosted match never pages chunks, so it keeps no streamer threads
+    world.streaming = false;
+    world.layout.halfSize = config.worldSize / 2;
+    if (config.worldSize > 40.0f) world.layout.pillarDensity = 1.0f;
+    world.viewDistance = -chunkCoord(-world.layout.halfSize - 0.5f);
+    world.generate();
+
+    // Enemies at random spots across the arena
+    enemies.seedRandom(config.seed);
+    enemies.worldLimit = world.layout.halfSize;
+    float limit = world.layout.halfSize - 1.0f;
+    for (int i = 0; i < config.enemyCount; ++i) {
+        glm::vec3 pos(-limit + (enemies.random() % int(limit * 200)) / 100.0f, 1.8f,
+                      -limit + (enemies.random() % int(limit * 200)) / 100.0f);
+        glm::vec3 col(0.2f + (enemies.random() % 80) / 100.0f, 0.2f + (enemies.random() % 80) / 100.0f, 0.2f + (enemies.random() % 80) / 100.0f);
+        enemies.spawn(pos, col);
+    }
+    enemyDeadTicks.assign(enemies.enemies.size(), 0);
+    enemyHistory.reset(MAX_REWIND_TICKS + 1);
+    grid.reset(world.layout.halfSize, GRID_CELL, INTEREST_RADIUS);
+    grid.update(enemies.enemies);
+
+    players.resize(config.maxPlayers);
+    for (int i = 0; i < config.maxPlayers; ++i) {
+        players[i].id = (uint16_t)i;
+        players[i].priority.assign(enemies.enemies.size(), 0.0f);
+    }
+    nearestPlayers.reserve(config.maxPlayers);
+    inView.assign(enemies.enemies.size(), 0);
+    nearby.reserve(MAX_CANDIDATES * 2);
+    candidates.reserve(MAX_CANDIDATES * 2 + SnapshotCodec::MAX_VIEW_ENEMIES);
+    keep.reserve(SnapshotCodec::MAX_VIEW_ENEMIES);
+    positions.reserve(config.maxPlayers);
+    health.reserve(config.maxPlayers);
+    playerOfSlot.reserve(config.maxPlayers);
+
+    std::cout << "Server listening on UDP port " << socket.getPort() << ": " << config.maxPlayers << " players, "
+              << enemies.getEnemyCount() << " enemies, " << world.chunks.size() << " chunks\n";
+    return true;
+}
+
+// Fixed-rate loop until stop() or maxTicks ticks
+void GameServer::run(int maxTicks) {
+    running = true;
+    auto step = TickClock::fromSeconds(Protocol::TICK_STEP);
+    auto next = Clock::now();
+    int ticks = 0;
+    while (running && (maxTicks <= 0 || ticks < maxTicks)) {
+        tick();
+        ticks++;
+
+        TickClock::advance(next, step);
+        TickClock::waitUntil(next);
+    }
+    running = false;
+}
+
+// One authoritative step: receive, simulate, replicate
+void GameServer::tick() {
+    auto start = Clock::now();
+    tickNumber++;
+
+    auto t = Clock::now();
+    receivePackets();
+    stats.recvMs += msSince(t);
+
+    t = Clock::now();
+    simulatePlayers();
+    stats.playersMs += msSince(t);
+
+    t = Clock::now();
+    simulateEnemies();
+    enemyHistory.record(tickNumber, enemies.enemies);
+    grid.update(enemies.enemies);
+    stats.gridMoves += grid.getMoves();
+    stats.enemiesMs += msSince(t);
+
+    t = Clock::now();
+    if (tickNumber % Protocol::SNAPSHOT_INTERVAL == 0) sendSnapshots();
+    stats.snapshotMs += msSince(t);
+
+    t = Clock::now();
+    if (tickNumber % Protocol::SNAPSHOT_INTERVAL == 0) sendBroadcast();
+    stats.broadcastMs += msSince(t);
+
+    double ms = msSince(start);
+    stats.totalMs += ms;
+    stats.maxMs = std::max(stats.maxMs, ms);
+    stats.ticks++;
+    if (ms > Protocol::TICK_STEP * 1000.0) stats.overruns++;
+
+    if (std::chrono::duration<float>(Clock::now() - lastReport).count() > 2.0f) report();
+}
+
+int GameServer::getPlayerCount() const {
+    int count = 0;
+    for (const Player& p : players) count += p.active ? 1 : 0;
+    return count;
+}
+
+GameServer::Player* GameServer::findPlayer(const NetAddress& address) {
+    for (Player& p : players) {
+        if (p.active && p.address == address) return &p;
+    }
+    return nullptr;
+}
+
+// Receive and dispatch every waiting datagram (bounded per tick)
+void GameServer::receivePackets() {
+    uint8_t buffer[Protocol::MAX_PACKET];
+    NetAddress from;
+    for (int i = 0; i < MAX_PACKETS_PER_TICK; ++i) {
+        int bytes = socket.receive(from, buffer, sizeof(buffer));
+        if (bytes < 0) break;
+        stats.packetsIn++;
+        stats.bytesIn += bytes;
+
+        PacketReader r(buffer, bytes);
+        MessageType type;
+        if (!Protocol::readHeader(r, type)) continue;
+        if (type == MessageType::CONNECT) handleConnect(from);
+        else if (type == MessageType::INPUT) handleInput(from, r);
+        else if (type == MessageType::DISCONNECT) handleDisconnect(from);
+        else if (type == MessageType::RELAY_CONNECT) handleRelayConnect(from);
+    }
+
+    // Drop players that went silent
+    for (Player& p : players) {
+        if (p.active && tickNumber - p.lastHeardTick > Protocol::TIMEOUT_SECONDS * Protocol::TICK_RATE) {
+            if (config.verbose) std::cout << "Player " << (int)p.id << " timed out (" << p.address.toString() << ")\n";
+            p.active = false;
+        }
+    }
+    for (size_t i = 0; i < relays.size();) {
+        if (tickNumber - relays[i].lastHeardTick > Protocol::TIMEOUT_SECONDS * Protocol::TICK_RATE) {
+            if (config.verbose) std::cout << "Relay " << relays[i].address.toString() << " timed out\n";
+            relays.erase(relays.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void GameServer::handleConnect(const NetAddress& from) {
+    Player* p = findPlayer(from);
+    if (!p) {
+        for (Player& slot : players) {
+            if (!slot.active && admitting) { p = &slot; break; }
+        }
+        if (!p) {
+            uint8_t buffer[16];
+            PacketWriter w(buffer, sizeof(buffer));
+            Protocol::writeHeader(w, MessageType::REJECT);
+            send(from, buffer, w.getSize());
+            return;
+        }
+        p->active = true;
+        p->address = from;
+        p->score = 0;
+        p->lastSeq = 0;
+        p->ackSnapshot = 0;
+        p->queued = 0;
+        for (EnemyView& v : p->views) v.tick = 0;
+        std::fill(p->priority.begin(), p->priority.end(), 0.0f);
+        spawnPlayer(*p);
+        if (config.verbose) std::cout << "Player " << (int)p->id << " joined from " << from.toString() << " (" << getPlayerCount() << " connected)\n";
+    }
+    p->lastHeardTick = tickNumber;
+
+    // Sent again for every CONNECT, so a lost ACCEPT is simply retried by the client
+    uint8_t buffer[64];
+    PacketWriter w(buffer, sizeof(buffer));
+    Protocol::writeHeader(w, MessageType::ACCEPT);
+    w.write(p->id);
+    w.write(tickNumber);
+    Protocol::writeLayout(w, world.layout);
+    send(from, buffer, w.getSize());
+}
+
+// Queue new commands in seq order; repeats of already applied or queued commands are ignored
+void GameServer::handleInput(const NetAddress& from, PacketReader& r) {
+    Player* p = findPlayer(from);
+    if (!p) return;
+    p->lastHeardTick = tickNumber;
+
+    p->ackSnapshot = std::max(p->ackSnapshot, r.read<uint32_t>());
+    int count = std::min<int>(r.read<uint8_t>(), Protocol::INPUT_REDUNDANCY);
+    for (int i = 0; i < count; ++i) {
+        PlayerCommand cmd = Protocol::readCommand(r);
+        if (r.isBad() || cmd.seq <= p->lastSeq) continue;
+
+        // Untrusted: a NaN or infinite angle would stick in the player's position and reach
+        // every snapshot. Movement is button bits, so each axis is already within [-1, 1]
+        if (!std::isfinite(cmd.yaw) || !std::isfinite(cmd.pitch)) continue;
+        cmd.yaw = std::fmod(cmd.yaw + 180.0f, 360.0f);
+        cmd.yaw = (cmd.yaw < 0.0f ? cmd.yaw + 360.0f : cmd.yaw) - 180.0f;
+        if (cmd.yaw >= 180.0f) cmd.yaw = -180.0f;
+        cmd.pitch = std::max(-89.0f, std::min(cmd.pitch, 89.0f));
+        cmd.buttons &= CMD_FORWARD | CMD_BACK | CMD_LEFT | CMD_RIGHT | CMD_JUMP | CMD_FIRE | CMD_RELOAD;
+
+        int at = p->queued;
+        bool duplicate = false;
+        for (int q = 0; q < p->queued; ++q) {
+            if (p->queue[q].seq == cmd.seq) { duplicate = true; break; }
+            if (p->queue[q].seq > cmd.seq) { at = q; break; }
+        }
+        if (duplicate) continue;
+        if (p->queued == COMMAND_QUEUE) {
+            // Full: the oldest command is dropped (its seq is skipped)
+            std::copy(p->queue + 1, p->queue + COMMAND_QUEUE, p->queue);
+            p->queued--;
+            if (at > 0) at--;
+        }
+        std::copy_backward(p->queue + at, p->queue + p->queued, p->queue + p->queued + 1);
+        p->queue[at] = cmd;
+        p->queued++;
+    }
+}
+
+void GameServer::handleDisconnect(const NetAddress& from) {
+    Player* p = findPlayer(from);
+    if (!p) {
+        for (size_t i = 0; i < relays.size(); ++i) {
+            if (relays[i].address == from) {
+                relays.erase(relays.begin() + i);
+                break;
+            }
+        }
+        return;
+    }
+    p->active = false;
+    if (config.verbose) std::cout << "Player " << (int)p->id << " left (" << getPlayerCount() << " connected)\n";
+}
+
+// Relays must run on this machine: the broadcast is live and complete, it is the relay
+// that holds it back before spectators see it
+void GameServer::handleRelayConnect(const NetAddress& from) {
+    Relay* relay = nullptr;
+    for (Relay& r : relays) {
+        if (r.address == from) relay = &r;
+    }
+    if (!relay && (from.ip >> 24) == 127 && (int)relays.size() < Protocol::MAX_RELAYS) {
+        relays.push_back({ from, tickNumber });
+        relay = &relays.back();
+        broadcastBaseTick = 0;    // The new relay needs every chunk in full
+        if (config.verbose) std::cout << "Relay " << from.toString() << " subscribed to the broadcast\n";
+    }
+
+    uint8_t buffer[64];
+    PacketWriter w(buffer, sizeof(buffer));
+    if (!relay) {
+        Protocol::writeHeader(w, MessageType::REJECT);
+        send(from, buffer, w.getSize());
+        return;
+    }
+    relay->lastHeardTick = tickNumber;
+    Protocol::writeHeader(w, MessageType::RELAY_ACCEPT);
+    w.write(tickNumber);
+    Protocol::writeLayout(w, world.layout);
+    send(from, buffer, w.getSize());
+}
+
+// Apply queued commands: one per tick, a second one when the client is running ahead
+void GameServer::simulatePlayers() {
+    for (Player& p : players) {
+        if (!p.active) continue;
+        int apply = p.queued > 2 ? MAX_COMMANDS_PER_TICK : std::min(p.queued, 1);
+        for (int i = 0; i < apply; ++i) {
+            const PlayerCommand& cmd = p.queue[i];
+            if (p.lastSeq != 0 && cmd.seq > p.lastSeq + 1) stats.commandsLost += cmd.seq - p.lastSeq - 1;
+            PlayerMove::apply(p.camera, p.weapons, cmd, world);
+            if (cmd.buttons & CMD_FIRE) fireShot(p, cmd.viewTick);
+            p.lastSeq = cmd.seq;
+        }
+        std::copy(p.queue + apply, p.queue + p.queued, p.queue);
+        p.queued -= apply;
+    }
+}
+
+// One shot along the player's view; same rules as the single-player Shooter::fire,
+// but scored and charged to this player instead of the globals.
+// Enemies are tested at their boxes of the snapshot the client was showing (at most
+// MAX_REWIND_TICKS back), read in place from the history ring.
+void GameServer::fireShot(Player& p, uint32_t viewTick) {
+    auto t = Clock::now();
+    uint32_t usedTick = tickNumber;
+    RewindFrame frame = enemyHistory.getBoxes(viewTick, (int)enemies.enemies.size(), usedTick);
+    ShotHit hit = Shooter::trace(p.camera.position, p.camera.front, world, enemies, &frame);
+    stats.shotMs += msSince(t);
+    stats.shots++;
+    stats.rewoundTicks += enemyHistory.getNewestTick() - usedTick;
+
+    if (hit.item != -1) {
+        Item::pickUp(world, world.cubes[hit.item].id);
+        p.score += 5;
+        p.weapons.setmagz();
+        return;
+    }
+
+    AmmoReserve& reserve = p.weapons.getCurrentReserve();
+    if (reserve.currentAmmo <= 0) return;
+    reserve.currentAmmo--;
+
+    if (hit.enemy != -1) {
+        Enemy& e = enemies.enemies[hit.enemy];
+        p.score += 10;
+        e.health -= p.weapons.getCurrentBullet()->getDamage();
+        enemies.markChanged(hit.enemy);
+        if (e.health <= 0 && e.color != glm::vec3(0.0f)) {
+            p.score += 50;
+            e.color = glm::vec3(0.0f);
+        }
+    }
+}
+
+// Enemy AI against every connected player, melee damage, respawns
+void GameServer::simulateEnemies() {
+    positions.clear();
+    health.clear();
+    playerOfSlot.clear();
+    for (Player& p : players) {
+        if (!p.active) continue;
+        positions.push_back(p.camera.position);
+        health.push_back(p.health);
+        playerOfSlot.push_back(p.id);
+    }
+
+    enemies.update(Protocol::TICK_STEP, positions.data(), (int)positions.size());
+    enemies.attackPlayers(positions.data(), health.data(), (int)positions.size(), Protocol::TICK_STEP);
+
+    for (size_t i = 0; i < playerOfSlot.size(); ++i) {
+        Player& p = players[playerOfSlot[i]];
+        p.health = health[i];
+        if (p.health <= 0) {
+            if (config.verbose) std::cout << "Player " << (int)p.id << " died with " << p.score << " points\n";
+            p.score = 0;
+            spawnPlayer(p);
+        }
+    }
+
+    // Killed enemies come back after a while somewhere else
+    float limit = world.layout.halfSize - 1.0f;
+    for (size_t i = 0; i < enemies.enemies.size(); ++i) {
+        Enemy& e = enemies.enemies[i];
+        if (e.color != glm::vec3(0.0f)) continue;
+        if (++enemyDeadTicks[i] < ENEMY_RESPAWN_TICKS) continue;
+        glm::vec3 pos(-limit + (enemies.random() % int(limit * 200)) / 100.0f, 1.8f,
+                      -limit + (enemies.random() % int(limit * 200)) / 100.0f);
+        glm::vec3 col(0.2f + (enemies.random() % 80) / 100.0f, 0.2f + (enemies.random() % 80) / 100.0f, 0.2f + (enemies.random() % 80) / 100.0f);
+        e = Enemy(pos, col);
+        enemyDeadTicks[i] = 0;
+        enemyHistory.respawned((int)i);
+        enemies.markChanged((int)i);
+    }
+
+    // Items return once all of them have been collected
+    if (itemsMask() == 0 && ++itemsGoneTicks >= ITEM_RESPAWN_TICKS) {
+        world.regenerateItems();
+        itemsGoneTicks = 0;
+    }
+}
+
+// Place a player at its spawn point on a ring around the centre, full health and fresh weapons
+void GameServer::spawnPlayer(Player& p) {
+    float angle = p.id * 6.2831853f / config.maxPlayers;
+    float radius = world.layout.halfSize * 0.5f;
+    p.camera.position = glm::vec3(std::cos(angle) * radius, 2.0f, std::sin(angle) * radius);
+    p.camera.velocityY = 0.0f;
+    p.camera.isOnGround = false;
+    p.camera.boundsLimit = world.boundsLimit();
+    p.camera.setAngles(glm::degrees(angle) + 180.0f, 0.0f);   // Facing the centre
+    world.resolveCollision(p.camera.position, 0.4f, 1.5f);
+    p.weapons = WeaponSystem();
+    p.health = 100;
+}
+
+NetRemotePlayer GameServer::remotePlayer(const Player& p) const {
+    NetRemotePlayer r;
+    r.id = p.id;
+    r.position = p.camera.position;
+    r.yaw = p.camera.yaw;
+    r.pitch = p.camera.pitch;
+    r.health = (int16_t)p.health;
+    return r;
+}
+
+NetPlayerState GameServer::playerState(const Player& p) const {
+    NetPlayerState s;
+    s.position = p.camera.position;
+    s.velocityY = p.camera.velocityY;
+    s.onGround = p.camera.isOnGround ? 1 : 0;
+    s.health = (int16_t)p.health;
+    s.score = p.score;
+    s.currentWeapon = (int8_t)p.weapons.currentWeapon;
+    for (int w = 0; w < 3; ++w) {
+        s.ammo[w] = (int16_t)p.weapons.weapons[w].currentAmmo;
+        s.mags[w] = (int16_t)p.weapons.weapons[w].reservedMags;
+        s.partial[w] = (int16_t)p.weapons.weapons[w].partialAmmo;
+    }
+    return s;
+}
+
+// Bit (id - 1) set for every item still in the world
+uint8_t GameServer::itemsMask() const {
+    uint8_t mask = 0;
+    for (const Cube& c : world.cubes) {
+        if (c.isItem && c.id >= 1 && c.id <= 8) mask |= (uint8_t)(1 << (c.id - 1));
+    }
+    return mask;
+}
+
+void GameServer::sendSnapshots() {
+    uint8_t buffer[Protocol::MAX_PACKET];
+    for (Player& p : players) {
+        if (!p.active) continue;
+        send(p.address, buffer, buildSnapshot(p, buffer));
+    }
+}
+
+// Broadcast frame: packets of up to BROADCAST_CHUNK players (in full), then of BROADCAST_CHUNK
+// enemies against the previous frame. Each enemy chunk goes out in full every
+// BROADCAST_KEYFRAME_INTERVAL frames, staggered by chunk, so a spectator that joined or lost
+// a packet has the whole picture again within a second. Encoded once, whatever the audience.
+void GameServer::sendBroadcast() {
+    if (relays.empty()) {
+        broadcastBaseTick = 0;
+        return;
+    }
+    static const QuantizedEnemy zero;
+    uint8_t buffer[Protocol::MAX_PACKET];
+    uint8_t bitBuffer[Protocol::MAX_PACKET];
+    float limit = world.layout.halfSize;
+    auto toRelays = [&](int bytes) {
+        for (const Relay& r : relays) send(r.address, buffer, bytes);
+        stats.broadcastBytes += bytes;
+    };
+
+    // Players; one packet even when there are none (the tick and items still go out)
+    int total = getPlayerCount();
+    size_t slot = 0;
+    for (int first = 0; first == 0 || first < total; first += Protocol::BROADCAST_CHUNK) {
+        int count = std::min(total - first, Protocol::BROADCAST_CHUNK);
+        PacketWriter w(buffer, sizeof(buffer));
+        Protocol::writeHeader(w, MessageType::BROADCAST);
+        w.write(tickNumber);
+        w.write(BroadcastKind::PLAYERS);
+        w.write(itemsMask());
+        w.write((uint16_t)total);
+        w.write((uint16_t)first);
+        w.write((uint8_t)count);
+        BitWriter bits(bitBuffer, sizeof(bitBuffer));
+        for (int written = 0; written < count; ++slot) {
+            if (!players[slot].active) continue;
+            SnapshotCodec::writeRemotePlayer(bits, remotePlayer(players[slot]), limit);
+            written++;
+        }
+        w.writeBytes(bitBuffer, bits.getByteCount());
+        toRelays(w.getSize());
+    }
+
+    // Enemies
+    int enemyCount = (int)enemies.enemies.size();
+    if ((int)broadcastBase.size() != enemyCount) {
+        broadcastBase.assign(enemyCount, zero);
+        broadcastBaseTick = 0;
+    }
+    for (int first = 0, chunk = 0; first < enemyCount; first += Protocol::BROADCAST_CHUNK, ++chunk) {
+        int count = std::min(enemyCount - first, Protocol::BROADCAST_CHUNK);
+        bool full = broadcastBaseTick == 0 || (broadcastFrames + chunk) % Protocol::BROADCAST_KEYFRAME_INTERVAL == 0;
+        PacketWriter w(buffer, sizeof(buffer));
+        Protocol::writeHeader(w, MessageType::BROADCAST);
+        w.write(tickNumber);
+        w.write(BroadcastKind::ENEMIES);
+        w.write(full ? 0u : broadcastBaseTick);
+        w.write((uint16_t)enemyCount);
+        w.write((uint16_t)first);
+        w.write((uint8_t)count);
+        BitWriter bits(bitBuffer, sizeof(bitBuffer));
+        for (int i = first; i < first + count; ++i) {
+            QuantizedEnemy q = SnapshotCodec::quantizeEnemy(enemies.enemies[i], limit);
+            SnapshotCodec::writeEnemy(bits, full ? zero : broadcastBase[i], q);
+            broadcastBase[i] = q;
+        }
+        w.writeBytes(bitBuffer, bits.getByteCount());
+        toRelays(w.getSize());
+    }
+    broadcastBaseTick = tickNumber;
+    broadcastFrames++;
+}
+
+// Snapshot packet: tick, baseline, ack, items, own state, enemy total, remote player count,
+// then bit-packed remote players and the enemy view
+int GameServer::buildSnapshot(Player& p, uint8_t* buffer) {
+    uint8_t bitBuffer[Protocol::MAX_PACKET];
+    float limit = world.layout.halfSize;
+
+    // Delta against the client's last acknowledged view while it is still in the ring, else in full
+    const int window = Protocol::SNAPSHOT_HISTORY * Protocol::SNAPSHOT_INTERVAL;
+    const EnemyView& acked = p.views[(p.ackSnapshot / Protocol::SNAPSHOT_INTERVAL) % Protocol::SNAPSHOT_HISTORY];
+    bool usable = p.ackSnapshot != 0 && acked.tick == p.ackSnapshot && tickNumber - p.ackSnapshot < (uint32_t)window;
+    const EnemyView* base = usable ? &acked : nullptr;
+    EnemyView& view = p.views[(tickNumber / Protocol::SNAPSHOT_INTERVAL) % Protocol::SNAPSHOT_HISTORY];
+
+    PacketWriter w(buffer, Protocol::MAX_PACKET);
+    Protocol::writeHeader(w, MessageType::SNAPSHOT);
+    w.write(tickNumber);
+    w.write(base ? p.ackSnapshot : 0u);
+    w.write(p.lastSeq);
+    w.write(itemsMask());
+    Protocol::writePlayerState(w, playerState(p));
+    w.write((uint16_t)enemies.enemies.size());
+
+    // The nearest other players (all of them in smaller matches)
+    nearestPlayers.clear();
+    for (const Player& o : players) {
+        if (o.active && &o != &p) nearestPlayers.push_back({ glm::distance(o.camera.position, p.camera.position), o.id });
+    }
+    if ((int)nearestPlayers.size() > Protocol::MAX_REMOTE_PLAYERS) {
+        std::nth_element(nearestPlayers.begin(), nearestPlayers.begin() + (Protocol::MAX_REMOTE_PLAYERS - 1), nearestPlayers.end());
+        nearestPlayers.resize(Protocol::MAX_REMOTE_PLAYERS);
+    }
+
+    BitWriter bits(bitBuffer, sizeof(bitBuffer));
+    int remotes = 0;
+    for (const auto& nearest : nearestPlayers) {
+        SnapshotCodec::writeRemotePlayer(bits, remotePlayer(players[nearest.second]), limit);
+        remotes++;
+    }
+
+    // Whatever is left of the packet (after the count byte and the remote players) goes to enemies
+    int budgetBits = (Protocol::MAX_PACKET - w.getSize() - 1) * 8 - bits.getBitCount();
+    view.tick = tickNumber;
+    writeView(p, base, view, bits, budgetBits);
+
+    w.write((uint8_t)remotes);
+    w.writeBytes(bitBuffer, bits.getByteCount());
+    stats.snapshots++;
+    stats.viewEnemies += (long long)view.enemies.size();
+    return w.getSize();
+}
+
+// Interest management for one client. Baseline enemies stay in the view while within
+// DROP_RADIUS; enemies the grid finds within INTEREST_RADIUS may join. Changed and joining
+// enemies are sent best score first until the budget is spent: those within RELEVANT_RADIUS
+// (nearest first), then the rest by priority. Priority grows every snapshot an enemy waits,
+// faster when it is closer and twice as fast in front of the player, and resets once sent.
+void GameServer::writeView(Player& p, const EnemyView* base, EnemyView& out, BitWriter& w, int budgetBits) {
+    static const QuantizedEnemy zero;
+    float limit = world.layout.halfSize;
+    int total = (int)enemies.enemies.size();
+    int baseCount = base ? (int)base->enemies.size() : 0;
+    glm::vec2 eye(p.camera.position.x, p.camera.position.z);
+    glm::vec2 front(p.camera.front.x, p.camera.front.z);
+    if (glm::dot(front, front) > 1e-8f) front = glm::normalize(front);
+
+    auto score = [&](int index, glm::vec2 to, float distance) {
+        if (distance <= RELEVANT_RADIUS) return 1e6f - distance;
+        float weight = std::max(1.0f - (distance - RELEVANT_RADIUS) / (INTEREST_RADIUS - RELEVANT_RADIUS), 0.1f);
+        if (glm::dot(to / distance, front) > 0.5f) weight *= 2.0f;
+        return p.priority[index] += weight;
+    };
+
+    // One bit per baseline enemy (stays?), one more for each that stays unchanged, the join count
+    int bits = SnapshotCodec::VIEW_JOIN_BITS + baseCount;
+    int viewSize = 0;
+    candidates.clear();
+    keep.assign(baseCount, -1);
+    for (int i = 0; i < baseCount; ++i) {
+        const ViewEnemy& v = base->enemies[i];
+        if (v.index >= total) continue;
+        const Enemy& e = enemies.enemies[v.index];
+        glm::vec2 to = glm::vec2(e.position.x, e.position.z) - eye;
+        float distance = glm::length(to);
+        if (distance > DROP_RADIUS) continue;
+        keep[i] = 0;
+        inView[v.index] = 1;
+        bits += 1;
+        viewSize++;
+        QuantizedEnemy q = SnapshotCodec::quantizeEnemy(e, limit);
+        if (SnapshotCodec::enemyBits(v.q, q) == 1) {
+            p.priority[v.index] = 0.0f;    // Client is up to date
+            continue;
+        }
+        candidates.push_back({ v.index, i, score(v.index, to, distance), q });
+    }
+
+    grid.query(p.camera.position, INTEREST_RADIUS, MAX_CANDIDATES, nearby);
+    for (int index : nearby) {
+        if (inView[index]) continue;
+        const Enemy& e = enemies.enemies[index];
+        glm::vec2 to = glm::vec2(e.position.x, e.position.z) - eye;
+        float distance = glm::length(to);
+        if (distance > INTEREST_RADIUS) continue;
+        candidates.push_back({ index, -1, score(index, to, distance), SnapshotCodec::quantizeEnemy(e, limit) });
+    }
+    stats.candidates += (long long)candidates.size();
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+    int joinBits = SnapshotCodec::indexBits(total);
+    int joined = 0;
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        Candidate& cand = candidates[c];
+        int cost;
+        if (cand.base >= 0) {
+            cost = SnapshotCodec::enemyBits(base->enemies[cand.base].q, cand.q) - 1;
+        } else {
+            if (viewSize == SnapshotCodec::MAX_VIEW_ENEMIES || joined == (1 << SnapshotCodec::VIEW_JOIN_BITS) - 1) continue;
+            cost = joinBits + SnapshotCodec::enemyBits(zero, cand.q);
+        }
+        if (bits + cost > budgetBits) continue;
+        bits += cost;
+        p.priority[cand.index] = 0.0f;
+        if (cand.base >= 0) {
+            keep[cand.base] = (int)c + 1;
+        } else {
+            cand.base = -2;                // Marks a joining enemy that was picked
+            joined++;
+            viewSize++;
+        }
+    }
+
+    out.enemies.clear();
+    for (int i = 0; i < baseCount; ++i) {
+        w.writeBool(keep[i] >= 0);
+        if (keep[i] < 0) continue;
+        const ViewEnemy& v = base->enemies[i];
+        const QuantizedEnemy& q = keep[i] > 0 ? candidates[keep[i] - 1].q : v.q;
+        SnapshotCodec::writeEnemy(w, v.q, q);
+        out.enemies.push_back({ v.index, q });
+        inView[v.index] = 0;
+    }
+    w.write((uint32_t)joined, SnapshotCodec::VIEW_JOIN_BITS);
+    for (const Candidate& cand : candidates) {
+        if (cand.base != -2) continue;
+        w.write((uint32_t)cand.index, joinBits);
+        SnapshotCodec::writeEnemy(w, zero, cand.q);
+        out.enemies.push_back({ (uint16_t)cand.index, cand.q });
+    }
+}
+
+void GameServer::send(const NetAddress& to, const void* data, int bytes) {
+    socket.sendTo(to, data, bytes);
+    stats.packetsOut++;
+    stats.bytesOut += bytes;
+}
+
+// Debug output every 2 seconds
+void GameServer::report() {
+    auto now = Clock::now();
+    float seconds = std::chrono::duration<float>(now - lastReport).count();
+    int n = std::max(stats.ticks, 1);
+    if (config.verbose) {
+        std::cout << "[DEBUG] Server tick " << tickNumber << ": avg " << stats.totalMs / n << " ms, max " << stats.maxMs
+                  << " ms, over budget " << stats.overruns << "/" << stats.ticks
+                  << " (recv " << stats.recvMs / n << ", players " << stats.playersMs / n << ", enemies " << stats.enemiesMs / n
+                  << ", snapshots " << stats.snapshotMs / n << " ms) | " << getPlayerCount() << " players, "
+                  << enemies.getEnemyCount() << " enemies | in " << stats.packetsIn / seconds << " pkt/s "
+                  << stats.bytesIn / seconds / 1024.0f << " KB/s, out " << stats.packetsOut / seconds << " pkt/s "
+                  << stats.bytesOut / seconds / 1024.0f << " KB/s";
+        if (stats.snapshots > 0) {
+            std::cout << " | view " << (float)stats.viewEnemies / stats.snapshots << " enemies of "
+                      << (float)stats.candidates / stats.snapshots << " candidates, grid moves " << (float)stats.gridMoves / n << "/tick";
+        }
+        if (stats.commandsLost > 0) std::cout << " | " << stats.commandsLost << " commands lost";
+        if (stats.shots > 0) {
+            std::cout << " | " << stats.shots << " shots, " << stats.shotMs * 1000.0 / stats.shots << " us each, rewound "
+                      << (double)stats.rewoundTicks / stats.shots << " ticks";
+        }
+        if (!relays.empty()) {
+            std::cout << " | broadcast to " << relays.size() << " relays: " << stats.broadcastBytes / seconds / 1024.0f
+                      << " KB/s, " << stats.broadcastMs * Protocol::SNAPSHOT_INTERVAL / n << " ms per frame";
+        }
+        std::cout << "\n";
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        load.players = getPlayerCount();
+        load.ticks = stats.ticks;
+        load.overruns = stats.overruns;
+        load.avgTickMs = (float)(stats.totalMs / n);
+        load.maxTickMs = (float)stats.maxMs;
+        load.packetsInPerSec = stats.packetsIn / seconds;
+        load.packetsOutPerSec = stats.packetsOut / seconds;
+        load.kbInPerSec = stats.bytesIn / seconds / 1024.0f;
+        load.kbOutPerSec = stats.bytesOut / seconds / 1024.0f;
+        load.commandsLost = stats.commandsLost;
+    }
+    stats = TickStats();
+    lastReport = now;
+}
+
+GameServer::Load GameServer::getLoad() const {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    return load;
+}
+
+// Snapshot benchmark: no sockets; every player slot is a client standing at its spawn point
+// that acknowledges each snapshot. Sizes are whole packets.
+void GameServer::benchmarkSnapshots(int snapshots) {
+    for (Player& p : players) {
+        p.active = true;
+        p.ackSnapshot = 0;
+        spawnPlayer(p);
+    }
+    stats = TickStats();
+    uint8_t buffer[Protocol::MAX_PACKET];
+    double encodeMs = 0;
+    long long bytes = 0;
+    for (int s = 0; s < snapshots; ++s) {
+        for (int t = 0; t < Protocol::SNAPSHOT_INTERVAL; ++t) {
+            tickNumber++;
+            simulateEnemies();
+            grid.update(enemies.enemies);
+        }
+
+        auto t = Clock::now();
+        for (Player& p : players) {
+            bytes += buildSnapshot(p, buffer);
+            p.ackSnapshot = tickNumber;
+        }
+        encodeMs += msSince(t);
+    }
+
+    int clients = (int)players.size();
+    int packets = std::max(stats.snapshots, 1);
+    std::cout << "=== SNAPSHOTS: " << enemies.getEnemyCount() << " enemies, " << clients << " clients, " << snapshots
+              << " snapshots ===\n"
+              << "Bytes per client per tick " << (float)bytes / packets / Protocol::SNAPSHOT_INTERVAL
+              << ", enemies per view " << (float)stats.viewEnemies / packets
+              << " (" << (float)stats.candidates / packets << " candidates)\n"
+              << "Encode " << encodeMs * 1000.0 / packets << " us per client snapshot, "
+              << encodeMs / snapshots << " ms per snapshot for all clients\n";
+    for (Player& p : players) p.active = false;
+}
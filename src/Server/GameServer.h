@@ -0,0 +1,226 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "../Camera.h"
+#include "../World.h"
+#include "../Enemy.h"
+#include "../WeaponSystem.h"
+#include "../Net/Socket.h"
+#include "../Net/Protocol.h"
+#include "../Net/SnapshotCodec.h"
+#include "InterestGrid.h"
+
+// Settings for one dedicated server match
+struct ServerConfig {
+    uint16_t port = Protocol::DEFAULT_PORT;
+    int maxPlayers = 32;              // Up to Protocol::MAX_PLAYERS
+    int enemyCount = 7;
+    float worldSize = 40.0f;          // Arena edge length (same meaning as the game's --world-size)
+    unsigned int seed = 1234;         // rand() seed for enemy spawns and patrols
+    bool verbose = true;              // Join / leave / death lines and the 2 second report
+};
+
+// Enemies one snapshot left a client with; the baseline for the next snapshot's view
+struct EnemyView {
+    uint32_t tick = 0;
+    std::vector<ViewEnemy> enemies;
+};
+
+// GameServer runs one authoritative match: the World, the EnemyManager, item pickups and
+// Shooter hit detection for up to maxPlayers clients over UDP.
+// Clients send PlayerCommands; the server applies each exactly once at a fixed step and
+// sends every client a one-packet snapshot of its own state, the other players and the
+// enemies that matter to it (interest management): every enemy within RELEVANT_RADIUS, and
+// as many within INTEREST_RADIUS as fit, picked by priority that builds up while they wait
+// (faster in front of the player). The enemies are delta coded against the view of the
+// last snapshot that client acknowledged.
+// Shots are lag compensated: they hit enemies where the shooter saw them, up to
+// MAX_REWIND_TICKS ago, using the enemy hit boxes kept in an EnemyHistory.
+// Spectators are served by relays on the same machine (see SpectatorRelay): every snapshot
+// tick the server encodes one broadcast frame, every player and every enemy, and sends the
+// same packets to each subscribed relay.
+class GameServer {
+public:
+    static const int COMMAND_QUEUE = 16;          // Commands buffered per player
+    static const int MAX_COMMANDS_PER_TICK = 2;   // Catch-up limit after a late burst
+    static const int MAX_PACKETS_PER_TICK = 4096; // Receive budget per tick
+    static const int ENEMY_RESPAWN_TICKS = 10 * Protocol::TICK_RATE;
+    static const int ITEM_RESPAWN_TICKS = 30 * Protocol::TICK_RATE;
+    static const int MAX_REWIND_TICKS = 15;       // Lag compensation window (250 ms)
+    static constexpr float RELEVANT_RADIUS = 24.0f;   // Enemies always kept up to date
+    static constexpr float INTEREST_RADIUS = 48.0f;   // Enemies sent by priority
+    static constexpr float DROP_RADIUS = 52.0f;       // Enemies leave a view beyond this (hysteresis)
+    static constexpr float GRID_CELL = 8.0f;
+    static const int MAX_CANDIDATES = 256;        // Nearby enemies considered per client and snapshot
+
+    GameServer();
+    ~GameServer();
+
+    // Bind the socket and build the world and enemies
+    bool start(const ServerConfig& config);
+
+    // Fixed-rate loop until stop() or maxTicks ticks (0 = run forever)
+    void run(int maxTicks = 0);
+
+    // Ask run() to return after the current tick (any thread)
+    void stop() { running = false; }
+
+    // One authoritative step: receive, simulate, replicate
+    void tick();
+
+    int getPlayerCount() const;
+    uint32_t getTick() const { return tickNumber; }
+    uint16_t getPort() const { return socket.getPort(); }
+
+    // Whether new players may join (a match host closes a match while its core is saturated);
+    // players already in the match are unaffected
+    void setAdmitting(bool on) { admitting = on; }
+    bool isAdmitting() const { return admitting; }
+
+    // Load over the last 2 second report window
+    struct Load {
+        int players = 0;
+        int ticks = 0, overruns = 0;
+        float avgTickMs = 0.0f, maxTickMs = 0.0f;
+        float packetsInPerSec = 0.0f, packetsOutPerSec = 0.0f;
+        float kbInPerSec = 0.0f, kbOutPerSec = 0.0f;
+        long long commandsLost = 0;               // Commands that never arrived (seq gaps)
+    };
+
+    // For load tests hosting the server in-process (any thread)
+    Load getLoad() const;
+
+    // Snapshot benchmark: maxPlayers simulated clients at their spawn points, each acknowledging
+    // every snapshot; prints bytes per client per tick, enemies per view and encode time
+    void benchmarkSnapshots(int snapshots);
+
+private:
+    struct Player {
+        bool active = false;
+        uint16_t id = 0;
+        NetAddress address;
+        Camera camera;
+        WeaponSystem weapons;
+        int health = 100;
+        int score = 0;
+        uint32_t lastSeq = 0;                     // Last command applied
+        uint32_t ackSnapshot = 0;                 // Last snapshot the client acknowledged (delta baseline)
+        PlayerCommand queue[COMMAND_QUEUE];       // Received, not yet applied, in seq order
+        int queued = 0;
+        uint32_t lastHeardTick = 0;
+        EnemyView views[Protocol::SNAPSHOT_HISTORY];   // Enemies each recent snapshot left the client with
+        std::vector<float> priority;              // Per enemy, built up while it waits to be sent
+    };
+
+    // Per-phase tick timing, summed over a report window
+    struct TickStats {
+        double recvMs = 0, playersMs = 0, enemiesMs = 0, snapshotMs = 0;
+        double totalMs = 0, maxMs = 0;
+        int ticks = 0, overruns = 0;
+        int shots = 0;
+        long long rewoundTicks = 0;
+        double shotMs = 0;
+        int snapshots = 0;
+        long long viewEnemies = 0, candidates = 0, gridMoves = 0;
+        long long commandsLost = 0;
+        double broadcastMs = 0;
+        long long broadcastBytes = 0;
+        long long packetsIn = 0, packetsOut = 0, bytesIn = 0, bytesOut = 0;
+    };
+
+    // A relay subscribed to the spectator broadcast
+    struct Relay {
+        NetAddress address;
+        uint32_t lastHeardTick = 0;
+    };
+
+    ServerConfig config;
+    UdpSocket socket;
+    World world;
+    EnemyManager enemies;
+    std::vector<Player> players;
+    EnemyHistory enemyHistory;                    // Hit boxes of the last MAX_REWIND_TICKS + 1 ticks
+    std::vector<int> enemyDeadTicks;              // Ticks each enemy has been dead (for respawn)
+    int itemsGoneTicks = 0;                       // Ticks since the last item was picked up
+    uint32_t tickNumber = 0;
+    std::atomic<bool> running{false};
+    std::atomic<bool> admitting{true};
+
+    // Spatial grid for interest management, updated after the enemy AI each tick
+    InterestGrid grid;
+
+    // Spectator broadcast: one stream for all relays, enemies delta coded against the previous frame
+    std::vector<Relay> relays;
+    std::vector<QuantizedEnemy> broadcastBase;    // Enemies as the last broadcast frame left them
+    uint32_t broadcastBaseTick = 0;               // 0: the next frame goes out in full
+    uint32_t broadcastFrames = 0;
+
+    // An enemy that may go into a view: from the baseline view (base >= 0) or newly nearby
+    struct Candidate {
+        int index;
+        int base;                                 // Position in the baseline view, -1 if joining
+        float score;                              // Higher is sent first
+        QuantizedEnemy q;
+    };
+
+    // Scratch arrays handed to the enemy AI each tick
+    std::vector<glm::vec3> positions;
+    std::vector<int> health;
+    std::vector<int> playerOfSlot;
+
+    // Scratch for building views
+    std::vector<int> nearby;
+    std::vector<Candidate> candidates;
+    std::vector<int> keep;                        // Per baseline view entry: -1 leaves, 0 unchanged, else candidate + 1
+    std::vector<uint8_t> inView;                  // Per enemy, set while it is in the baseline view
+    std::vector<std::pair<float, int>> nearestPlayers;   // Distance and slot of the other players
+
+    TickStats stats;
+    std::chrono::steady_clock::time_point lastReport;
+    Load load;                                    // Published by report()
+    mutable std::mutex loadMutex;
+
+    // Receive and dispatch every waiting datagram (bounded per tick)
+    void receivePackets();
+    void handleConnect(const NetAddress& from);
+    void handleInput(const NetAddress& from, PacketReader& r);
+    void handleDisconnect(const NetAddress& from);
+    void handleRelayConnect(const NetAddress& from);
+
+    Player* findPlayer(const NetAddress& address);
+
+    // Apply queued commands to every player
+    void simulatePlayers();
+
+    // One shot from a player along its view direction, against the enemies of viewTick
+    void fireShot(Player& p, uint32_t viewTick);
+
+    // Enemy AI, melee damage, respawns
+    void simulateEnemies();
+
+    // Send every active client its snapshot
+    void sendSnapshots();
+
+    // One broadcast frame to every relay: all players, then all enemies in chunks
+    void sendBroadcast();
+
+    // One client's snapshot packet into buffer (MAX_PACKET bytes); returns its size
+    int buildSnapshot(Player& p, uint8_t* buffer);
+
+    // Pick this client's enemies within budgetBits and write them against its baseline view;
+    // out becomes the view the client will hold
+    void writeView(Player& p, const EnemyView* base, EnemyView& out, BitWriter& w, int budgetBits);
+
+    void spawnPlayer(Player& p);
+    NetPlayerState playerState(const Player& p) const;
+    NetRemotePlayer remotePlayer(const Player& p) const;
+    uint8_t itemsMask() const;
+
+    // Debug output every 2 seconds
+    void report();
+
+    void send(const NetAddress& to, const void* data, int bytes);
+};
@@ -0,0 +1,85 @@
+#include "InterestGrid.h"
+#include "../Enemy.h"
+#include <algorithm>
+#include <cmath>
+
+// Cover [-halfSize, halfSize] with cells of cellSize; queries reach up to maxRadius
+void InterestGrid::reset(float half, float size, float maxRadius) {
+    halfSize = half;
+    cellSize = size;
+    cellsPerSide = std::max(1, (int)std::ceil(2.0f * halfSize / cellSize));
+    cells.assign((size_t)cellsPerSide * cellsPerSide, std::vector<int>());
+    cellOf.clear();
+    slotOf.clear();
+
+    // A cell dx, dz away is at least (|d| - 1) cells from any point of the centre cell
+    int reach = std::min((int)std::ceil(maxRadius / cellSize) + 1, cellsPerSide);
+    offsets.clear();
+    for (int dz = -reach; dz <= reach; ++dz) {
+        for (int dx = -reach; dx <= reach; ++dx) {
+            float gx = std::max(std::abs(dx) - 1, 0) * cellSize;
+            float gz = std::max(std::abs(dz) - 1, 0) * cellSize;
+            float distance = std::sqrt(gx * gx + gz * gz);
+            if (distance <= maxRadius) offsets.push_back({ dx, dz, distance });
+        }
+    }
+    std::sort(offsets.begin(), offsets.end(), [](const Offset& a, const Offset& b) { return a.distance < b.distance; });
+}
+
+int InterestGrid::cellAt(const glm::vec3& position) const {
+    int x = std::min(std::max((int)((position.x + halfSize) / cellSize), 0), cellsPerSide - 1);
+    int z = std::min(std::max((int)((position.z + halfSize) / cellSize), 0), cellsPerSide - 1);
+    return z * cellsPerSide + x;
+}
+
+// Swap-remove from its cell
+void InterestGrid::remove(int enemy) {
+    std::vector<int>& cell = cells[cellOf[enemy]];
+    int slot = slotOf[enemy];
+    cell[slot] = cell.back();
+    slotOf[cell[slot]] = slot;
+    cell.pop_back();
+}
+
+void InterestGrid::insert(int enemy, int cell) {
+    cellOf[enemy] = cell;
+    slotOf[enemy] = (int)cells[cell].size();
+    cells[cell].push_back(enemy);
+}
+
+// Move enemies whose cell changed
+void InterestGrid::update(const std::vector<Enemy>& enemies) {
+    moves = 0;
+    int count = (int)enemies.size();
+    if ((int)cellOf.size() != count) {
+        for (std::vector<int>& cell : cells) cell.clear();
+        cellOf.assign(count, 0);
+        slotOf.assign(count, 0);
+        for (int i = 0; i < count; ++i) insert(i, cellAt(enemies[i].position));
+        moves = count;
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        int cell = cellAt(enemies[i].position);
+        if (cell == cellOf[i]) continue;
+        remove(i);
+        insert(i, cell);
+        moves++;
+    }
+}
+
+// Nearest cells first until at least maxResults enemies are found
+void InterestGrid::query(const glm::vec3& center, float radius, int maxResults, std::vector<int>& out) const {
+    out.clear();
+    int home = cellAt(center);
+    int cx = home % cellsPerSide;
+    int cz = home / cellsPerSide;
+    for (const Offset& o : offsets) {
+        if (o.distance > radius || (int)out.size() >= maxResults) break;
+        int x = cx + o.dx;
+        int z = cz + o.dz;
+        if (x < 0 || z < 0 || x >= cellsPerSide || z >= cellsPerSide) continue;
+        const std::vector<int>& cell = cells[z * cellsPerSide + x];
+        out.insert(out.end(), cell.begin(), cell.end());
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+class Enemy;
+
+// InterestGrid buckets enemies into square cells on the XZ plane so the server can find the
+// enemies near a player without looking at all of them.
+// update() runs every tick and only touches enemies that crossed into another cell;
+// query() visits cells nearest first and stops once it has enough enemies, so its cost
+// does not depend on how many enemies the arena holds.
+class InterestGrid {
+public:
+    // Cover [-halfSize, halfSize] with cells of cellSize; queries reach up to maxRadius
+    void reset(float halfSize, float cellSize, float maxRadius);
+
+    // Move enemies whose cell changed (all of them the first time or when the count changes)
+    void update(const std::vector<Enemy>& enemies);
+
+    // Indices of enemies in cells within radius of center, nearest cells first, until at
+    // least maxResults are found; out is cleared first
+    void query(const glm::vec3& center, float radius, int maxResults, std::vector<int>& out) const;
+
+    // Enemies that changed cell in the last update
+    int getMoves() const { return moves; }
+
+private:
+    struct Offset {
+        int dx, dz;
+        float distance;                     // From the centre cell to the nearest point of this one
+    };
+
+    float halfSize = 0.0f;
+    float cellSize = 1.0f;
+    int cellsPerSide = 1;
+    int moves = 0;
+    std::vector<std::vector<int>> cells;    // Enemy indices per cell
+    std::vector<int> cellOf;                // Cell of each enemy
+    std::vector<int> slotOf;                // Position of each enemy in its cell
+    std::vector<Offset> offsets;            // Cells around a centre cell by distance
+
+    int cellAt(const glm::vec3& position) const;
+    void remove(int enemy);
+    void insert(int enemy, int cell);
+};
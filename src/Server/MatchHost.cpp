@@ -0,0 +1,283 @@
+#include "MatchHost.h"
+#include "../TickClock.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+// CPU time the calling thread has used, in ms
+static double threadCpuMs() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 10000.0;   // 100 ns units
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0.0;
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+// Keep the calling thread on one core; false where that is not supported
+static bool pinToCore(int core) {
+#ifdef _WIN32
+    if (core >= (int)sizeof(DWORD_PTR) * 8) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+MatchHost::MatchHost() {}
+
+MatchHost::~MatchHost() {
+    stop();
+    for (auto& s : shards) {
+        if (s->thread.joinable()) s->thread.join();
+    }
+}
+
+// Start the shard threads
+bool MatchHost::start(const MatchHostConfig& cfg) {
+    config = cfg;
+    int count = config.shards > 0 ? config.shards : (int)std::thread::hardware_concurrency();
+    count = std::max(count, 1);
+    running = true;
+    for (int i = 0; i < count; ++i) {
+        shards.emplace_back(new Shard());
+        shards.back()->index = i;
+    }
+    for (auto& s : shards) {
+        Shard* shard = s.get();
+        shard->thread = std::thread([this, shard] { runShard(*shard); });
+    }
+    if (config.verbose) {
+        std::cout << "Match host: " << count << " shards" << (config.pinThreads ? " pinned to cores" : "")
+                  << ", saturated above " << config.maxShardLoad * 100.0f << "% load\n";
+    }
+    return true;
+}
+
+// Start a match and hand it to the least loaded shard
+int MatchHost::createMatch(const ServerConfig& matchConfig) {
+    if (shards.empty()) return -1;
+    std::lock_guard<std::mutex> admit(admitMutex);
+
+    // Lowest committed load, counting matches the shard has not picked up yet
+    float cost = config.newMatchMs / (float)(Protocol::TICK_STEP * 1000.0);
+    Shard* best = nullptr;
+    float bestLoad = 0.0f;
+    for (auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        if (s->load.saturated) continue;
+        float projected = s->load.committedLoad + s->pending.size() * cost;
+        if (!best || projected < bestLoad) {
+            best = s.get();
+            bestLoad = projected;
+        }
+    }
+    if (!best || bestLoad + cost > config.maxShardLoad) {
+        refused++;
+        if (config.verbose) std::cout << "Match refused: every shard is saturated\n";
+        return -1;
+    }
+
+    std::unique_ptr<Match> match(new Match());
+    match->id = nextId++;
+    match->server.reset(new GameServer());
+    if (!match->server->start(matchConfig)) return -1;
+    int id = match->id;
+    uint16_t port = match->server->getPort();
+    {
+        std::lock_guard<std::mutex> lock(best->mutex);
+        best->pending.push_back(std::move(match));
+    }
+    if (config.verbose) std::cout << "Match " << id << " on shard " << best->index << " (port " << port << ")\n";
+    return id;
+}
+
+// Report every 2 seconds until stop() or seconds have passed
+void MatchHost::run(float seconds) {
+    auto start = Clock::now();
+    auto lastReport = start;
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto now = Clock::now();
+        if (seconds > 0.0f && std::chrono::duration<float>(now - start).count() >= seconds) break;
+        if (std::chrono::duration<float>(now - lastReport).count() > 2.0f) {
+            if (config.verbose) report();
+            lastReport = now;
+        }
+    }
+}
+
+// Stop the shards (any thread); they are joined on destruction
+void MatchHost::stop() {
+    running = false;
+}
+
+// A shard's thread: tick every match when it is due, publish the load every 2 seconds
+void MatchHost::runShard(Shard& shard) {
+    if (config.pinThreads && !pinToCore(shard.index)) {
+        std::cerr << "ERROR::MATCH_HOST::PIN_FAILED shard " << shard.index << "\n";
+    }
+    auto step = TickClock::fromSeconds(Protocol::TICK_STEP);
+    float cost = config.newMatchMs / (float)(Protocol::TICK_STEP * 1000.0);
+    auto windowStart = Clock::now();
+
+    while (running) {
+        // Take over new matches; their ticks are spread over the tick period so they do not queue up
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto& m : shard.pending) {
+                double phase = std::fmod(shard.matches.size() * 0.618034, 1.0);
+                m->next = Clock::now() + std::chrono::duration_cast<Clock::duration>(step * phase);
+                m->server->setAdmitting(!shard.load.saturated);
+                shard.matches.push_back(std::move(m));
+                shard.load.committedLoad += cost;
+            }
+            shard.pending.clear();
+        }
+
+        auto poll = Clock::now() + std::chrono::milliseconds(5);   // Look for new matches at least this often
+        auto due = Clock::time_point::max();                       // Next match tick
+        for (auto& m : shard.matches) {
+            auto now = Clock::now();
+            if (now >= m->next) {
+                if (TickClock::isLate(m->next, now, step)) m->late++;
+                double cpu = threadCpuMs();
+                m->server->tick();
+                double ms = msSince(now);
+                m->cpuMs += threadCpuMs() - cpu;
+                m->busyMs += ms;
+                m->maxMs = std::max(m->maxMs, ms);
+                m->ticks++;
+                TickClock::advance(m->next, step);
+            }
+            due = std::min(due, m->next);
+        }
+
+        double windowMs = msSince(windowStart);
+        if (windowMs > 2000.0) {
+            publish(shard, windowMs);
+            windowStart = Clock::now();
+        }
+
+        // Only a match tick is worth spinning for; the poll for new matches just sleeps
+        if (due <= poll) TickClock::waitUntil(due);
+        else TickClock::waitUntil(poll, Clock::duration::zero());
+    }
+}
+
+// End a report window: publish loads and open or close the shard's matches to players
+void MatchHost::publish(Shard& shard, double windowMs) {
+    float cost = config.newMatchMs / (float)(Protocol::TICK_STEP * 1000.0);
+    ShardLoad load;
+    std::vector<MatchLoad> loads;
+    loads.reserve(shard.matches.size());
+    for (auto& m : shard.matches) {
+        MatchLoad l;
+        l.id = m->id;
+        l.shard = shard.index;
+        l.port = m->server->getPort();
+        l.players = m->server->getPlayerCount();
+        l.cpuPercent = (float)(m->cpuMs / windowMs * 100.0);
+        l.avgTickMs = (float)(m->busyMs / std::max(m->ticks, 1));
+        l.maxTickMs = (float)m->maxMs;
+        l.ticks = m->ticks;
+        l.lateTicks = m->late;
+        loads.push_back(l);
+
+        load.matches++;
+        load.load += (float)(m->busyMs / windowMs);
+        load.committedLoad += std::max((float)(m->busyMs / windowMs), cost);
+        load.lateTicks += m->late;
+        m->busyMs = m->cpuMs = m->maxMs = 0;
+        m->ticks = m->late = 0;
+    }
+
+    // Close the matches to new players past the limit, open them again once well below it
+    bool wasSaturated = shard.load.saturated;
+    load.saturated = wasSaturated ? load.load >= config.maxShardLoad * REOPEN_LOAD : load.load > config.maxShardLoad;
+    if (load.saturated != wasSaturated && config.verbose) {
+        std::cout << "Shard " << shard.index << (load.saturated ? " saturated" : " has room again") << " at "
+                  << load.load * 100.0f << "% load: " << (load.saturated ? "closed" : "open") << " to new players\n";
+    }
+    for (size_t i = 0; i < shard.matches.size(); ++i) {
+        shard.matches[i]->server->setAdmitting(!load.saturated);
+        loads[i].admitting = !load.saturated;
+    }
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.load = load;
+    shard.matchLoads.swap(loads);
+}
+
+// Print the per-shard and per-match load of the last window
+void MatchHost::report() const {
+    int matches = 0, players = 0;
+    for (const auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        matches += s->load.matches;
+        for (const MatchLoad& m : s->matchLoads) players += m.players;
+    }
+    std::cout << "[DEBUG] Host: " << matches << " matches on " << shards.size() << " shards, " << players << " players, "
+              << refused << " matches refused\n";
+    for (const auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        std::cout << "[DEBUG]   Shard " << s->index << ": " << s->load.matches << " matches, load " << s->load.load * 100.0f
+                  << "% (committed " << s->load.committedLoad * 100.0f << "%), " << s->load.lateTicks << " late ticks"
+                  << (s->load.saturated ? ", saturated" : "") << "\n";
+        for (const MatchLoad& m : s->matchLoads) {
+            std::cout << "[DEBUG]     Match " << m.id << " (port " << m.port << "): " << m.players << " players, "
+                      << m.cpuPercent << "% CPU, tick avg " << m.avgTickMs << " ms, max " << m.maxTickMs << " ms"
+                      << (m.lateTicks > 0 ? ", late " + std::to_string(m.lateTicks) : "") << "\n";
+        }
+    }
+}
+
+std::vector<MatchHost::ShardLoad> MatchHost::getShardLoads() const {
+    std::vector<ShardLoad> loads;
+    for (const auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        loads.push_back(s->load);
+    }
+    return loads;
+}
+
+std::vector<MatchHost::MatchLoad> MatchHost::getMatchLoads() const {
+    std::vector<MatchLoad> loads;
+    for (const auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        loads.insert(loads.end(), s->matchLoads.begin(), s->matchLoads.end());
+    }
+    return loads;
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameServer.h"
+
+// Settings for a process hosting many matches
+struct MatchHostConfig {
+    int shards = 0;                   // Worker threads (0 = one per hardware thread)
+    bool pinThreads = true;           // Pin shard i to core i
+    float maxShardLoad = 0.75f;       // Busy fraction of a shard's time above which it is saturated
+    float newMatchMs = 1.0f;          // Expected tick cost of a match (with its players); less is never assumed
+    bool verbose = true;              // Match start / refusal lines and the 2 second report
+};
+
+// MatchHost runs many independent matches in one process
+// Each match is a whole GameServer (its own World, EnemyManager, socket and tick) that only
+// one shard ever touches. A shard is a worker thread pinned to its own core; it ticks each of
+// its matches at 60 Hz, their ticks spread over the tick period, and times every tick (wall
+// and thread CPU time). That gives each match's CPU use and each shard's busy fraction.
+// Admission control: each match commits its measured cost, but at least newMatchMs per tick
+// (an idle match is cheap until its players join). A new match goes to the shard with the
+// lowest committed load and is refused when it would take every shard past maxShardLoad.
+// A shard whose measured load is past it anyway stops letting players into its matches until
+// the load falls below REOPEN_LOAD of the limit.
+class MatchHost {
+public:
+    static constexpr float REOPEN_LOAD = 0.9f;    // Fraction of maxShardLoad to admit players again
+
+    // One match over the last report window
+    struct MatchLoad {
+        int id = 0;
+        int shard = 0;
+        uint16_t port = 0;
+        int players = 0;
+        float cpuPercent = 0.0f;              // Thread CPU time spent in its ticks, of one core
+        float avgTickMs = 0.0f, maxTickMs = 0.0f;
+        int ticks = 0;
+        int lateTicks = 0;                    // Started more than a tick after they were due
+        bool admitting = true;
+    };
+
+    // One shard over the last report window
+    struct ShardLoad {
+        int matches = 0;
+        float load = 0.0f;                    // Fraction of the window spent ticking matches
+        float committedLoad = 0.0f;           // Every match at its load, but at least newMatchMs per tick
+        int lateTicks = 0;
+        bool saturated = false;
+    };
+
+    MatchHost();
+    ~MatchHost();
+
+    // Start the shard threads
+    bool start(const MatchHostConfig& config);
+
+    // Start a match and hand it to the least loaded shard (any thread); returns its id,
+    // or -1 when every shard is saturated or the server failed to start
+    int createMatch(const ServerConfig& config);
+
+    // Report every 2 seconds until stop() or seconds have passed (0 = until stop())
+    void run(float seconds = 0.0f);
+
+    // Ask run() and the shards to finish (any thread); the shards are joined, and the matches
+    // closed, when the host is destroyed
+    void stop();
+
+    // Print the per-shard and per-match load of the last window
+    void report() const;
+
+    std::vector<ShardLoad> getShardLoads() const;
+    std::vector<MatchLoad> getMatchLoads() const;
+    int getShardCount() const { return (int)shards.size(); }
+    int getRefusedCount() const { return refused; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Match {
+        int id = 0;
+        std::unique_ptr<GameServer> server;
+        Clock::time_point next;               // When the next tick is due
+        double busyMs = 0, cpuMs = 0, maxMs = 0;
+        int ticks = 0, late = 0;
+    };
+
+    struct Shard {
+        int index = 0;
+        std::thread thread;
+        std::vector<std::unique_ptr<Match>> matches;   // Owned by the shard thread
+
+        // Shared with other threads, under mutex
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<Match>> pending;   // Created, not picked up yet
+        ShardLoad load;
+        std::vector<MatchLoad> matchLoads;
+    };
+
+    MatchHostConfig config;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<bool> running{false};
+    std::atomic<int> nextId{1};
+    std::atomic<int> refused{0};
+    std::mutex admitMutex;                    // One createMatch decision at a time
+
+    // A shard's thread: tick every match when it is due, publish the load every 2 seconds
+    void runShard(Shard& shard);
+
+    // End a report window: publish loads and open or close the shard's matches to players
+    void publish(Shard& shard, double windowMs);
+};
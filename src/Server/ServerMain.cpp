@@ -0,0 +1,93 @@
+#include <csignal>
+#include <iostream>
+#include <string>
+#include "GameServer.h"
+#include "MatchHost.h"
+
+static GameServer* activeServer = nullptr;
+static MatchHost* activeHost = nullptr;
+
+static void onSignal(int) {
+    if (activeServer) activeServer->stop();
+    if (activeHost) activeHost->stop();
+}
+
+// --matches: many matches in one process, match i on port + i with seed + i
+static int runHost(const ServerConfig& config, const MatchHostConfig& hostConfig, int matches, int maxTicks) {
+    MatchHost host;
+    host.start(hostConfig);
+    for (int i = 0; i < matches; ++i) {
+        ServerConfig match = config;
+        if (config.port != 0) match.port = (uint16_t)(config.port + i);
+        match.seed = config.seed + i;
+        match.verbose = false;
+        host.createMatch(match);
+    }
+
+    activeHost = &host;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    host.run(maxTicks > 0 ? (float)maxTicks / Protocol::TICK_RATE : 0.0f);
+    activeHost = nullptr;
+
+    std::cout << "Match host stopped, " << host.getRefusedCount() << " of " << matches << " matches refused\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    ServerConfig config;
+    int maxTicks = 0;
+    int benchSnapshots = 0;
+    int matches = 1;
+    MatchHostConfig hostConfig;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) config.port = (uint16_t)std::stoi(argv[++i]);
+        else if (arg == "--enemies" && i + 1 < argc) config.enemyCount = std::stoi(argv[++i]);
+        else if (arg == "--world-size" && i + 1 < argc) config.worldSize = std::stof(argv[++i]);
+        else if (arg == "--max-players" && i + 1 < argc) config.maxPlayers = std::stoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) config.seed = (unsigned int)std::stoul(argv[++i]);
+        else if (arg == "--ticks" && i + 1 < argc) maxTicks = std::stoi(argv[++i]);
+        else if (arg == "--bench-snapshots" && i + 1 < argc) benchSnapshots = std::stoi(argv[++i]);
+        else if (arg == "--matches" && i + 1 < argc) matches = std::stoi(argv[++i]);
+        else if (arg == "--shards" && i + 1 < argc) hostConfig.shards = std::stoi(argv[++i]);
+        else if (arg == "--max-shard-load" && i + 1 < argc) hostConfig.maxShardLoad = std::stof(argv[++i]) / 100.0f;
+        else if (arg == "--match-cost" && i + 1 < argc) hostConfig.newMatchMs = std::stof(argv[++i]);
+        else if (arg == "--no-pin") hostConfig.pinThreads = false;
+        else std::cerr << "Unknown option " << arg
+                       << " (--port, --enemies, --world-size, --max-players, --seed, --ticks, --bench-snapshots,"
+                       << " --matches, --shards, --max-shard-load, --match-cost, --no-pin)\n";
+    }
+
+    // Snapshot benchmark: simulated clients only, any free port
+    if (benchSnapshots > 0) config.port = 0;
+
+    if (!Net::startup()) return -1;
+    if (matches > 1 && benchSnapshots == 0) {
+        int result = runHost(config, hostConfig, matches, maxTicks);
+        Net::cleanup();
+        return result;
+    }
+
+    GameServer server;
+    if (!server.start(config)) {
+        Net::cleanup();
+        return -1;
+    }
+
+    if (benchSnapshots > 0) {
+        server.benchmarkSnapshots(benchSnapshots);
+        Net::cleanup();
+        return 0;
+    }
+
+    activeServer = &server;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    server.run(maxTicks);
+    activeServer = nullptr;
+
+    std::cout << "Server stopped after " << server.getTick() << " ticks\n";
+    Net::cleanup();
+    return 0;
+}
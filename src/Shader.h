@@ -3,7 +3,7 @@
 #include <glm/glm.hpp>
 
 // Shader class manages OpenGL shader programs
-// Handles compilation, linking, and uniform setting
+// Loads sources from disk; compilation and linking go through ProgramCache
 class Shader {
 public:
     unsigned int ID;  // OpenGL shader program ID
@@ -15,12 +15,9 @@ public:
     void use() const;
     
     // Set a 4x4 matrix uniform in the shader
-    void setMat4(const std::string& name, const glm::mat4& mat) const;
+    void setMat4(const char* name, const glm::mat4& mat) const;
     
 private:
     // Read shader source code from file
     std::string readFile(const char* path);
-    
-    // Check for shader compilation errors
-    void checkCompileErrors(unsigned int shader, const std::string& type);
 };
\ No newline at end of file
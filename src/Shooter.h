@@ -4,9 +4,23 @@
 #include "Enemy.h"
 #include "Item.h"
 
+// What a shot ray hits: the nearest item (items are checked first) and the nearest enemy
+struct ShotHit {
+    int item = -1;            // Index into world.cubes, -1 if no item is on the ray
+    float itemDist = 1e9f;
+    int enemy = -1;           // Index into enemies.enemies, -1 if no enemy is on the ray
+    float enemyDist = 1e9f;
+};
+
 class Shooter {
 public:
     static void fire(const Camera& cam, World& world, EnemyManager& enemies);
+    // Fire along an explicit ray (e.g. the view direction at the time of a buffered click)
+    static void fire(const glm::vec3& origin, const glm::vec3& dir, World& world, EnemyManager& enemies);
+    // Hit detection only, no game effects (shared with the dedicated server)
+    // rewind: test enemies at stored hit boxes instead of where they are now (lag compensation)
+    static ShotHit trace(const glm::vec3& origin, const glm::vec3& dir, const World& world, EnemyManager& enemies,
+                         const RewindFrame* rewind = nullptr);
 private:
     static bool rayAABB(const glm::vec3& orig, const glm::vec3& dir, const Cube& cube, float& t);
 };
@@ -0,0 +1,58 @@
+#include "Shooter.h"
+#include <algorithm>
+
+// Hit detection only, shared with the dedicated server; the single-player effects of a
+// shot (ammo, score, tracers) are in Shooter.cpp
+
+bool Shooter::rayAABB(const glm::vec3& orig, const glm::vec3& dir,
+                      const Cube& cube, float& t) {
+    glm::vec3 min = cube.pos - cube.size * 0.5f;
+    glm::vec3 max = cube.pos + cube.size * 0.5f;
+
+    float tmin = (min.x - orig.x) / dir.x;
+    float tmax = (max.x - orig.x) / dir.x;
+    if (tmin > tmax) std::swap(tmin, tmax);
+
+    float ty_min = (min.y - orig.y) / dir.y;
+    float ty_max = (max.y - orig.y) / dir.y;
+    if (ty_min > ty_max) std::swap(ty_min, ty_max);
+
+    if (tmin > ty_max || ty_min > tmax) return false;
+    if (ty_min > tmin) tmin = ty_min;
+    if (ty_max < tmax) tmax = ty_max;
+
+    float tz_min = (min.z - orig.z) / dir.z;
+    float tz_max = (max.z - orig.z) / dir.z;
+    if (tz_min > tz_max) std::swap(tz_min, tz_max);
+
+    if (tmin > tz_max || tz_min > tmax) return false;
+    if (tz_min > tmin) tmin = tz_min;
+
+    t = tmin;
+    return tmin > 0;
+}
+
+// Nearest item and nearest enemy along the ray
+ShotHit Shooter::trace(const glm::vec3& origin, const glm::vec3& dir, const World& world, EnemyManager& enemies,
+                       const RewindFrame* rewind) {
+    ShotHit hit;
+    for (size_t i = 0; i < world.cubes.size(); ++i) {
+        const Cube& cube = world.cubes[i];
+        if (!cube.isItem) continue;
+        float t;
+        if (rayAABB(origin, dir, cube, t) && t < hit.itemDist) {
+            hit.itemDist = t;
+            hit.item = (int)i;
+        }
+    }
+
+    int enemyID;
+    float enemyDist;
+    bool hitEnemy = rewind && rewind->boxes ? enemies.hitTest(origin, dir, *rewind, enemyID, enemyDist)
+                                            : enemies.hitTest(origin, dir, enemyID, enemyDist);
+    if (hitEnemy) {
+        hit.enemy = enemyID;
+        hit.enemyDist = enemyDist;
+    }
+    return hit;
+}
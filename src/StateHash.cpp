@@ -0,0 +1,326 @@
+#include "StateHash.h"
+#include "Camera.h"
+#include "Enemy.h"
+#include "World.h"
+#include "WeaponSystem.h"
+#include "GameSnapshot.h"
+#include "tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+extern int playerHealth;
+extern int score;
+extern int currentAmmo;
+extern int reserveMags;
+extern int partialMagAmmo;
+extern WeaponSystem ws;
+
+// Field layout of each subsystem's elements
+struct FieldInfo {
+    const char* name;
+    bool isFloat;
+};
+
+static const FieldInfo ENEMY_FIELDS[] = {
+    { "position.x", true }, { "position.y", true }, { "position.z", true },
+    { "color.r", true }, { "color.g", true }, { "color.b", true },
+    { "health", true }, { "alive", false },
+    { "patrolTarget.x", true }, { "patrolTarget.y", true }, { "patrolTarget.z", true },
+    { "patrolTimer", true }, { "speed", true }, { "chasing", false }, { "attackTimer", true }
+};
+static const FieldInfo CAMERA_FIELDS[] = {
+    { "position.x", true }, { "position.y", true }, { "position.z", true },
+    { "yaw", true }, { "pitch", true }, { "velocityY", true }, { "onGround", false },
+    { "playerHealth", false }, { "score", false }
+};
+static const FieldInfo WEAPON_FIELDS[] = {
+    { "currentWeapon", false }, { "currentAmmo", false }, { "reserveMags", false }, { "partialMagAmmo", false },
+    { "weapon0.currentAmmo", false }, { "weapon0.reservedMags", false }, { "weapon0.partialAmmo", false },
+    { "weapon1.currentAmmo", false }, { "weapon1.reservedMags", false }, { "weapon1.partialAmmo", false },
+    { "weapon2.currentAmmo", false }, { "weapon2.reservedMags", false }, { "weapon2.partialAmmo", false }
+};
+static const FieldInfo ITEM_FIELDS[] = {
+    { "pos.x", true }, { "pos.y", true }, { "pos.z", true },
+    { "size.x", true }, { "size.y", true }, { "size.z", true },
+    { "color.r", true }, { "color.g", true }, { "color.b", true },
+    { "isItem", false }, { "id", false }
+};
+
+struct PartInfo {
+    const char* name;
+    const FieldInfo* fields;
+    int fieldCount;
+};
+
+static const PartInfo PARTS[StateHash::COUNT] = {
+    { "enemies", ENEMY_FIELDS, (int)(sizeof(ENEMY_FIELDS) / sizeof(FieldInfo)) },
+    { "camera", CAMERA_FIELDS, (int)(sizeof(CAMERA_FIELDS) / sizeof(FieldInfo)) },
+    { "weapons", WEAPON_FIELDS, (int)(sizeof(WEAPON_FIELDS) / sizeof(FieldInfo)) },
+    { "items", ITEM_FIELDS, (int)(sizeof(ITEM_FIELDS) / sizeof(FieldInfo)) }
+};
+static const int MAX_FIELDS = 16;
+
+static uint32_t bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float toFloat(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static void enemyFields(const Enemy& e, uint32_t* f) {
+    f[0] = bits(e.position.x); f[1] = bits(e.position.y); f[2] = bits(e.position.z);
+    f[3] = bits(e.color.r); f[4] = bits(e.color.g); f[5] = bits(e.color.b);
+    f[6] = bits(e.health); f[7] = e.alive;
+    f[8] = bits(e.patrolTarget.x); f[9] = bits(e.patrolTarget.y); f[10] = bits(e.patrolTarget.z);
+    f[11] = bits(e.patrolTimer); f[12] = bits(e.speed); f[13] = e.chasing; f[14] = bits(e.attackTimer);
+}
+
+static void itemFields(const Cube& c, uint32_t* f) {
+    f[0] = bits(c.pos.x); f[1] = bits(c.pos.y); f[2] = bits(c.pos.z);
+    f[3] = bits(c.size.x); f[4] = bits(c.size.y); f[5] = bits(c.size.z);
+    f[6] = bits(c.color.r); f[7] = bits(c.color.g); f[8] = bits(c.color.b);
+    f[9] = c.isItem; f[10] = (uint32_t)c.id;
+}
+
+// FNV-1a over the fields, seeded with the subsystem and index, then a final avalanche
+static uint64_t hashElement(int subsystem, int index, const uint32_t* fields, int count) {
+    uint64_t h = 0xcbf29ce484222325ull ^ ((uint64_t)subsystem << 56) ^ ((uint64_t)(index + 1) * 0x9E3779B97F4A7C15ull);
+    for (int i = 0; i < count; ++i) h = (h ^ fields[i]) * 0x100000001B3ull;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Set element i of a subsystem; rehashes only if its fields changed
+void StateHash::set(Subsystem subsystem, int index, const uint32_t* fields) {
+    Part& p = parts[subsystem];
+    int count = PARTS[subsystem].fieldCount;
+    bool added = index >= (int)p.hashes.size();
+    if (added) {
+        p.fields.resize((size_t)(index + 1) * count);
+        p.hashes.resize(index + 1, 0);
+    }
+    stats.visited++;
+    uint32_t* stored = &p.fields[(size_t)index * count];
+    if (!added && std::memcmp(stored, fields, count * sizeof(uint32_t)) == 0) return;
+
+    uint64_t h = hashElement(subsystem, index, fields, count);
+    p.sum += h - p.hashes[index];
+    p.hashes[index] = h;
+    std::memcpy(stored, fields, count * sizeof(uint32_t));
+    stats.rehashed++;
+}
+
+// Drop the elements from count on
+void StateHash::truncate(Subsystem subsystem, int count) {
+    Part& p = parts[subsystem];
+    if (count >= (int)p.hashes.size()) return;
+    for (size_t i = count; i < p.hashes.size(); ++i) p.sum -= p.hashes[i];
+    p.hashes.resize(count);
+    p.fields.resize((size_t)count * PARTS[subsystem].fieldCount);
+}
+
+// Bring the hash up to date with the live game
+void StateHash::update(const Camera& camera, EnemyManager& enemies, const World& world) {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t f[MAX_FIELDS];
+
+    // Enemies: only those marked changed since the last update, plus any not hashed yet
+    int enemyCount = (int)enemies.enemies.size();
+    truncate(ENEMIES, enemyCount);
+    for (int i = (int)parts[ENEMIES].hashes.size(); i < enemyCount; ++i) {
+        enemyFields(enemies.enemies[i], f);
+        set(ENEMIES, i, f);
+    }
+    for (int i : enemies.getChanged()) {
+        if (i >= enemyCount) continue;
+        enemyFields(enemies.enemies[i], f);
+        set(ENEMIES, i, f);
+    }
+    enemies.clearChanged();
+
+    uint32_t c[] = { bits(camera.position.x), bits(camera.position.y), bits(camera.position.z),
+                     bits(camera.yaw), bits(camera.pitch), bits(camera.velocityY), camera.isOnGround,
+                     (uint32_t)playerHealth, (uint32_t)score };
+    set(CAMERA, 0, c);
+
+    uint32_t w[] = { (uint32_t)ws.currentWeapon, (uint32_t)currentAmmo, (uint32_t)reserveMags, (uint32_t)partialMagAmmo,
+                     (uint32_t)ws.weapons[0].currentAmmo, (uint32_t)ws.weapons[0].reservedMags, (uint32_t)ws.weapons[0].partialAmmo,
+                     (uint32_t)ws.weapons[1].currentAmmo, (uint32_t)ws.weapons[1].reservedMags, (uint32_t)ws.weapons[1].partialAmmo,
+                     (uint32_t)ws.weapons[2].currentAmmo, (uint32_t)ws.weapons[2].reservedMags, (uint32_t)ws.weapons[2].partialAmmo };
+    set(WEAPONS, 0, w);
+
+    for (size_t i = 0; i < world.cubes.size(); ++i) {
+        itemFields(world.cubes[i], f);
+        set(ITEMS, (int)i, f);
+    }
+    truncate(ITEMS, (int)world.cubes.size());
+
+    for (const Part& p : parts) stats.elements += (long long)p.hashes.size();
+    stats.updates++;
+    stats.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Set from a GameSnapshot image (the arrays are read in place, as GameSnapshot::restore does)
+bool StateHash::updateFromSnapshot(const std::vector<unsigned char>& image) {
+    SnapshotHeader h;
+    if (image.size() < sizeof(h)) return false;
+    std::memcpy(&h, image.data(), sizeof(h));
+    if (std::memcmp(h.magic, "GSNP", 4) != 0 || h.version != GameSnapshot::VERSION || h.bytes != image.size() ||
+        h.bytes != sizeof(h) + h.enemyCount * sizeof(Enemy) + h.itemCount * sizeof(Cube) + h.tracerCount * sizeof(Tracer))
+        return false;
+    uint32_t f[MAX_FIELDS];
+
+    const unsigned char* p = image.data() + sizeof(h);
+    Enemy e(glm::vec3(0.0f), glm::vec3(0.0f));
+    for (uint32_t i = 0; i < h.enemyCount; ++i, p += sizeof(Enemy)) {
+        std::memcpy(&e, p, sizeof(Enemy));
+        enemyFields(e, f);
+        set(ENEMIES, (int)i, f);
+    }
+    truncate(ENEMIES, (int)h.enemyCount);
+
+    uint32_t c[] = { bits(h.position[0]), bits(h.position[1]), bits(h.position[2]),
+                     bits(h.yaw), bits(h.pitch), bits(h.velocityY), h.onGround != 0,
+                     (uint32_t)h.playerHealth, (uint32_t)h.score };
+    set(CAMERA, 0, c);
+
+    uint32_t w[] = { (uint32_t)h.currentWeapon, (uint32_t)h.currentAmmo, (uint32_t)h.reserveMags, (uint32_t)h.partialMagAmmo,
+                     (uint32_t)h.weaponAmmo[0], (uint32_t)h.reservedMags[0], (uint32_t)h.partialAmmo[0],
+                     (uint32_t)h.weaponAmmo[1], (uint32_t)h.reservedMags[1], (uint32_t)h.partialAmmo[1],
+                     (uint32_t)h.weaponAmmo[2], (uint32_t)h.reservedMags[2], (uint32_t)h.partialAmmo[2] };
+    set(WEAPONS, 0, w);
+
+    Cube cube;
+    for (uint32_t i = 0; i < h.itemCount; ++i, p += sizeof(Cube)) {
+        std::memcpy(&cube, p, sizeof(Cube));
+        itemFields(cube, f);
+        set(ITEMS, (int)i, f);
+    }
+    truncate(ITEMS, (int)h.itemCount);
+    return true;
+}
+
+// Fold each subsystem's sum (and element count) into 32 bits
+StateDigest StateHash::getDigest() const {
+    StateDigest d;
+    for (int s = 0; s < COUNT; ++s) {
+        uint64_t v = parts[s].sum ^ ((uint64_t)parts[s].hashes.size() * 0x9E3779B97F4A7C15ull);
+        d.parts[s] = (uint32_t)(v ^ (v >> 32));
+    }
+    return d;
+}
+
+const char* StateHash::getName(Subsystem subsystem) {
+    return PARTS[subsystem].name;
+}
+
+// Write the elements whose fields differ between a and b in one subsystem
+int StateHash::writeDiff(std::ostream& out, const StateHash& a, const StateHash& b, Subsystem subsystem, int maxLines) {
+    const PartInfo& info = PARTS[subsystem];
+    const Part& pa = a.parts[subsystem];
+    const Part& pb = b.parts[subsystem];
+    int countA = (int)pa.hashes.size(), countB = (int)pb.hashes.size();
+    out << info.name << ": " << countA << " | " << countB << " elements\n";
+
+    int differing = 0, lines = 0;
+    for (int i = 0; i < std::max(countA, countB); ++i) {
+        if (i >= countA || i >= countB) {
+            if (lines++ < maxLines) out << "  [" << i << "] only in " << (i < countA ? "the first" : "the second") << "\n";
+            differing++;
+            continue;
+        }
+        const uint32_t* fa = &pa.fields[(size_t)i * info.fieldCount];
+        const uint32_t* fb = &pb.fields[(size_t)i * info.fieldCount];
+        if (std::memcmp(fa, fb, info.fieldCount * sizeof(uint32_t)) == 0) continue;
+        differing++;
+        for (int f = 0; f < info.fieldCount; ++f) {
+            if (fa[f] == fb[f] || lines++ >= maxLines) continue;
+            out << "  [" << i << "] " << info.fields[f].name << ": ";
+            if (info.fields[f].isFloat) out << std::setprecision(9) << toFloat(fa[f]) << " | " << toFloat(fb[f]) << "\n";
+            else out << (int32_t)fa[f] << " | " << (int32_t)fb[f] << "\n";
+        }
+    }
+    if (lines > maxLines) out << "  ... " << lines - maxLines << " more differences\n";
+    out << "  " << differing << " of " << std::max(countA, countB) << " elements differ\n";
+    return differing;
+}
+
+// State at the start of a tick against the digest recorded for it
+void DesyncCheck::check(int tick, const StateDigest& recorded, const StateHash& live) {
+    ticks++;
+    StateDigest d = live.getDigest();
+    if (d == recorded) return;
+
+    if (!pending) {
+        pending = true;
+        firstTick = tick;
+        subsystems = 0;
+        ordered = 0;
+        count++;
+    }
+    // Divergence spreads (a camera off by a little soon moves the enemies): keep the order
+    bool added = false;
+    for (int s = 0; s < StateHash::COUNT; ++s) {
+        if (d.parts[s] == recorded.parts[s] || (subsystems & (1u << s))) continue;
+        subsystems |= 1u << s;
+        order[ordered++] = (StateHash::Subsystem)s;
+        added = true;
+    }
+    if (!added) return;
+    std::cerr << "ERROR::DEMO::DESYNC at tick " << tick;
+    if (tick != firstTick) std::cerr << " (first seen at " << firstTick << ")";
+    std::cerr << ":";
+    for (int i = 0; i < ordered; ++i) std::cerr << " " << StateHash::getName(order[i]);
+    std::cerr << "\n";
+}
+
+// A keyframe is about to be restored: write the diff of the pending desync
+void DesyncCheck::atKeyframe(int tick, const std::vector<unsigned char>& keyframe, const StateHash& live) {
+    if (!pending) return;
+    pending = false;
+    StateHash recorded;
+    if (!recorded.updateFromSnapshot(keyframe)) return;
+
+    std::ostringstream diff;
+    diff << "Desync first seen at tick " << firstTick << "; state at keyframe tick " << tick << " (replayed | recorded)\n";
+    int differing = 0;
+    for (int i = 0; i < ordered; ++i) differing += StateHash::writeDiff(diff, live, recorded, order[i]);
+    if (differing == 0) {
+        // Both runs were put back to the same state in between (a restart)
+        std::cout << "Desync from tick " << firstTick << " is gone by keyframe tick " << tick << ", nothing to diff\n";
+        return;
+    }
+
+    std::string path = "desync_" + std::to_string(firstTick) + ".txt";
+    std::ofstream file(path, std::ios::trunc);
+    if (!(file << diff.str())) {
+        std::cerr << "ERROR::DEMO::CANNOT_WRITE " << path << "\n";
+        return;
+    }
+    std::cout << "Desync diff: " << differing << " elements differ at tick " << tick << ", written to " << path << "\n";
+}
+
+// Summary at the end of playback
+void DesyncCheck::report(const StateHash& live) const {
+    const StateHash::Stats& s = live.getStats();
+    std::cout << "[DEBUG] State hash: " << ticks << " ticks checked, " << count << " desyncs";
+    if (pending) std::cout << " (the last one has no keyframe after it to diff against)";
+    std::cout << " | " << (s.updates ? s.ms * 1000.0 / s.updates : 0.0) << " us per tick, "
+              << (s.elements ? 100.0 * s.visited / s.elements : 0.0) << "% of elements visited, "
+              << (s.elements ? 100.0 * s.rehashed / s.elements : 0.0) << "% rehashed\n";
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class Camera;
+class EnemyManager;
+class World;
+
+// Per-tick digest of the game state: one folded hash per StateHash subsystem
+struct StateDigest {
+    uint32_t parts[4] = { 0, 0, 0, 0 };
+
+    bool operator==(const StateDigest& o) const {
+        return parts[0] == o.parts[0] && parts[1] == o.parts[1] && parts[2] == o.parts[2] && parts[3] == o.parts[3];
+    }
+    bool operator!=(const StateDigest& o) const { return !(*this == o); }
+};
+
+// StateHash keeps a running hash of the simulation state for desync detection
+// The state is split into subsystems (enemies, camera, weapons, items), each a list of elements
+// with a fixed set of fields (floats by bit pattern, so any divergence shows). Every element's
+// fields are kept with their hash; a subsystem's hash is the sum of its element hashes (each
+// mixed with its index). Enemies are only visited when EnemyManager marked them changed; the
+// few camera, weapon and item elements are compared every update. An element whose fields
+// differ from the stored ones is rehashed: the old hash is subtracted, the new one added.
+class StateHash {
+public:
+    enum Subsystem { ENEMIES, CAMERA, WEAPONS, ITEMS, COUNT };
+
+    // Bring the hash up to date with the live game (camera, enemies, items and the
+    // player / weapon globals of main.cpp); consumes the enemies' change marks
+    void update(const Camera& camera, EnemyManager& enemies, const World& world);
+
+    // Set from a GameSnapshot image instead; false if it is not a valid snapshot
+    bool updateFromSnapshot(const std::vector<unsigned char>& image);
+
+    StateDigest getDigest() const;
+
+    // Write the elements whose fields differ between a and b in one subsystem; returns how many
+    static int writeDiff(std::ostream& out, const StateHash& a, const StateHash& b, Subsystem subsystem, int maxLines = 64);
+
+    static const char* getName(Subsystem subsystem);
+
+    // Work done by update() so far
+    struct Stats {
+        long long updates = 0;
+        long long elements = 0;         // Elements in the state, summed over updates
+        long long visited = 0, rehashed = 0;
+        double ms = 0.0;
+    };
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Part {
+        std::vector<uint32_t> fields;   // Element i at [i * fieldCount, (i + 1) * fieldCount)
+        std::vector<uint64_t> hashes;   // By element
+        uint64_t sum = 0;
+    };
+
+    Part parts[COUNT];
+    Stats stats;
+
+    // Set element i of a subsystem (growing it); rehashes only if its fields changed
+    void set(Subsystem subsystem, int index, const uint32_t* fields);
+
+    // Drop the elements from count on
+    void truncate(Subsystem subsystem, int count);
+};
+
+// DesyncCheck compares a demo's recorded digests with the replayed state, tick by tick
+// The first mismatch since the last keyframe is reported with the diverging subsystems; the
+// next keyframe (the recorded state) is then diffed against the replayed state, field by
+// field, into desync_<tick>.txt before it is restored.
+class DesyncCheck {
+public:
+    // State at the start of a tick against the digest recorded for it
+    void check(int tick, const StateDigest& recorded, const StateHash& live);
+
+    bool isPending() const { return pending; }
+
+    // A keyframe is about to be restored: write the diff of the pending desync (live is up to date)
+    void atKeyframe(int tick, const std::vector<unsigned char>& keyframe, const StateHash& live);
+
+    // Summary at the end of playback
+    void report(const StateHash& live) const;
+
+    int getCount() const { return count; }
+
+private:
+    bool pending = false;
+    int firstTick = 0;
+    unsigned int subsystems = 0;     // Bit per StateHash::Subsystem, in the order they diverged
+    StateHash::Subsystem order[StateHash::COUNT];
+    int ordered = 0;
+    int count = 0;                   // Desyncs found
+    int ticks = 0;
+};
@@ -0,0 +1,155 @@
+#include "StreamBuffer.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cstring>
+
+// glBufferStorage from GL 4.4 or ARB_buffer_storage (the loader only fills the core entry point)
+typedef void (*PFN_BufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+static PFN_BufferStorage bufferStorage = nullptr;
+static bool bufferStorageChecked = false;
+
+static PFN_BufferStorage findBufferStorage() {
+    if (!bufferStorageChecked) {
+        bufferStorageChecked = true;
+        if (glBufferStorage) bufferStorage = (PFN_BufferStorage)glBufferStorage;
+        else if (glfwExtensionSupported("GL_ARB_buffer_storage"))
+            bufferStorage = (PFN_BufferStorage)glfwGetProcAddress("glBufferStorage");
+    }
+    return bufferStorage;
+}
+
+// Constructor
+StreamBuffer::StreamBuffer()
+    : target(GL_ARRAY_BUFFER), buffer(0), regionBytes(0), region(0), head(0), flushed(0),
+      persistent(false), mapped(nullptr) {
+    for (int i = 0; i < FRAMES; ++i) fences[i] = nullptr;
+}
+
+// Destructor: release the buffer and fences
+StreamBuffer::~StreamBuffer() {
+    if (buffer) release();
+}
+
+// Create the buffer on the GL thread
+void StreamBuffer::create(unsigned int bindTarget, int bytes) {
+    target = bindTarget;
+    regionBytes = bytes;
+    persistent = findBufferStorage() != nullptr;
+    allocateStorage();
+}
+
+// (Re)create the GL buffer with the current region size
+void StreamBuffer::allocateStorage() {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+    GLsizeiptr size = (GLsizeiptr)regionBytes * FRAMES;
+
+    if (persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(target, size, nullptr, flags);
+        mapped = (unsigned char*)glMapBufferRange(target, 0, size, flags);
+        if (!mapped) {
+            // Fall back to the staging path with a fresh buffer
+            glDeleteBuffers(1, &buffer);
+            persistent = false;
+            glGenBuffers(1, &buffer);
+            glBindBuffer(target, buffer);
+        }
+    }
+    if (!persistent) {
+        glBufferData(target, size, nullptr, GL_STREAM_DRAW);
+        staging.resize(regionBytes);
+    }
+    glBindBuffer(target, 0);
+}
+
+// Delete the buffer, waiting for the GPU first
+void StreamBuffer::release() {
+    for (int i = 0; i < FRAMES; ++i) {
+        if (!fences[i]) continue;
+        glClientWaitSync((GLsync)fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        glDeleteSync((GLsync)fences[i]);
+        fences[i] = nullptr;
+    }
+    if (mapped) {
+        glBindBuffer(target, buffer);
+        glUnmapBuffer(target);
+        glBindBuffer(target, 0);
+        mapped = nullptr;
+    }
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+}
+
+// Start writing the next region
+void StreamBuffer::beginFrame(int bytesNeeded) {
+    stats = Stats();
+
+    if (bytesNeeded > regionBytes) {
+        // Waits for every region, so only happens when a frame outgrows the ring
+        release();
+        while (bytesNeeded > regionBytes) regionBytes *= 2;
+        allocateStorage();
+        stats.stalls++;
+    }
+
+    region = (region + 1) % FRAMES;
+    head = 0;
+    flushed = 0;
+
+    GLsync fence = (GLsync)fences[region];
+    if (!fence) return;
+    fences[region] = nullptr;
+
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        if (!persistent) {
+            // Give the driver fresh storage instead of waiting; older regions stay valid for the GPU
+            glBindBuffer(target, buffer);
+            glBufferData(target, (GLsizeiptr)regionBytes * FRAMES, nullptr, GL_STREAM_DRAW);
+            glBindBuffer(target, 0);
+            for (int i = 0; i < FRAMES; ++i) {
+                if (fences[i]) glDeleteSync((GLsync)fences[i]);
+                fences[i] = nullptr;
+            }
+            stats.orphans++;
+        } else {
+            // The mapping cannot be orphaned: wait for the GPU to release the region
+            stats.stalls++;
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull) == GL_TIMEOUT_EXPIRED) {}
+        }
+    }
+    glDeleteSync(fence);
+}
+
+// Reserve bytes in the current region
+void* StreamBuffer::allocate(int bytes, int alignment, int& offset) {
+    int start = (head + alignment - 1) / alignment * alignment;
+    head = start + bytes;
+    stats.bytes += bytes;
+    offset = region * regionBytes + start;
+    return persistent ? mapped + offset : staging.data() + start;
+}
+
+// Make this frame's writes visible to GL
+void StreamBuffer::flush() {
+    if (persistent || head <= flushed) return;
+
+    // The region is fenced, so the copy never has to wait for the GPU
+    glBindBuffer(target, buffer);
+    GLintptr start = (GLintptr)region * regionBytes + flushed;
+    void* dst = glMapBufferRange(target, start, head - flushed,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (dst) {
+        std::memcpy(dst, staging.data() + flushed, head - flushed);
+        glUnmapBuffer(target);
+    }
+    glBindBuffer(target, 0);
+    flushed = head;
+}
+
+// Fence the region used this frame
+void StreamBuffer::endFrame() {
+    if (fences[region]) glDeleteSync((GLsync)fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+
+// StreamBuffer is a frame ring for data written by the CPU every frame
+// (dynamic vertices, per-frame and per-object uniforms)
+// The buffer is split into FRAMES regions; each frame writes one region and fences it,
+// so a region is only rewritten once the GPU has finished reading it.
+// With ARB_buffer_storage the buffer stays persistently mapped; otherwise writes are staged
+// and copied in with an unsynchronized map, and a region still in use orphans the buffer
+class StreamBuffer {
+public:
+    static const int FRAMES = 3;     // Regions in the ring
+
+    // Counters for the current / last frame
+    struct Stats {
+        int bytes = 0;               // Bytes written this frame
+        int stalls = 0;              // Times the CPU had to wait for a fence
+        int orphans = 0;             // Times the buffer was orphaned instead of waiting
+    };
+
+    StreamBuffer();
+    ~StreamBuffer();
+
+    // Create the buffer on the GL thread: FRAMES regions of regionBytes each
+    void create(unsigned int target, int regionBytes);
+
+    // Start writing the next region; grows the ring first if bytesNeeded does not fit
+    void beginFrame(int bytesNeeded);
+
+    // Reserve bytes in the current region; returns where to write and sets the buffer offset
+    void* allocate(int bytes, int alignment, int& offset);
+
+    // Make this frame's writes visible to GL (before drawing from them)
+    void flush();
+
+    // Fence the region used this frame
+    void endFrame();
+
+    unsigned int getBuffer() const { return buffer; }
+    bool isPersistent() const { return persistent; }
+    const Stats& getStats() const { return stats; }
+
+private:
+    unsigned int target;             // Bind target used for (re)creation and mapping
+    unsigned int buffer;             // GL buffer object
+    int regionBytes;                 // Size of one region
+    int region;                      // Region written this frame
+    int head;                        // Next free byte in the region
+    int flushed;                     // Bytes of the region already copied to GL (staging path)
+    bool persistent;                 // Persistently mapped (ARB_buffer_storage)
+    unsigned char* mapped;           // Persistent mapping of the whole buffer
+    std::vector<unsigned char> staging;  // CPU copy of the region (non-persistent path)
+    void* fences[FRAMES];            // GLsync of each region's last use
+    Stats stats;
+
+    // (Re)create the GL buffer with the current region size
+    void allocateStorage();
+
+    // Delete the buffer, waiting for the GPU first
+    void release();
+};
@@ -1,14 +1,17 @@
 #include "TextRenderer.h"
+#include "AllocTracker.h"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include "WeaponSystem.h"
+#include "ProgramCache.h"
 
 // Declare the external variables
 extern int currentAmmo;
 extern int reserveMags;
 extern int partialMagAmmo;
 extern WeaponSystem ws;
+extern ProgramCache programCache;
 
 TextRenderer::TextRenderer(unsigned int width, unsigned int height) {
     // Simple 2D colored bar shader
@@ -26,49 +29,23 @@ TextRenderer::TextRenderer(unsigned int width, unsigned int height) {
         void main() { fragColor = vec4(color, 1.0); }
     )";
 
-    unsigned int v = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(v, 1, &vs, nullptr);
-    glCompileShader(v);
+    shaderID = programCache.create("hud", vs, fs);
 
-    unsigned int f = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(f, 1, &fs, nullptr);
-    glCompileShader(f);
-
-    shaderID = glCreateProgram();
-    glAttachShader(shaderID, v);
-    glAttachShader(shaderID, f);
-    glLinkProgram(shaderID);
-    glDeleteShader(v);
-    glDeleteShader(f);
-
-    // VAO / VBO
+    // VAO only: quad vertices are streamed by the render queue, which points attribute 0 at them
     glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
     glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 8, nullptr, GL_DYNAMIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
-    glEnableVertexAttribArray(0);  
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 }
 
 TextRenderer::~TextRenderer() {
     glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
     glDeleteProgram(shaderID);
 }
-void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused*/, unsigned int w, unsigned int h) {
-    glDisable(GL_DEPTH_TEST);
-    glUseProgram(shaderID);
-
+void TextRenderer::RenderHUD(RenderQueue& queue, FrameArena& arena, int health, int score, int /*unused*/, int /*unused*/, unsigned int w, unsigned int h) {
+    AllocScope allocTag(AllocTag::HUD);
+    // HUD quads are recorded into the HUD pass (depth test off) and drawn by the render queue
     glm::mat4 proj = glm::ortho(0.0f, (float)w, (float)h, 0.0f);
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "proj"), 1, GL_FALSE, &proj[0][0]);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
     float margin = 20.0f;
     float barY = h - 60.0f;
@@ -81,9 +58,7 @@ void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused
         margin - 3,     barY - barH - 3,
         margin + 203,   barY - barH - 3
     };
-    glUniform3f(glGetUniformLocation(shaderID, "color"), 0.0f, 0.0f, 0.0f);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(healthBgVerts), healthBgVerts);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    queue.drawDynamic(PASS_HUD, shaderID, VAO, GL_TRIANGLE_STRIP, healthBgVerts, 8, 4, proj, glm::vec3(0.0f, 0.0f, 0.0f));
 
     float healthPct = health / 100.0f;
     glm::vec3 healthColor = glm::mix(glm::vec3(1,0,0), glm::vec3(0,1,0), healthPct);
@@ -94,9 +69,7 @@ void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused
         margin,     barY - barH,
         margin + healthW, barY - barH
     };
-    glUniform3fv(glGetUniformLocation(shaderID, "color"), 1, &healthColor[0]);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(healthVerts), healthVerts);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    queue.drawDynamic(PASS_HUD, shaderID, VAO, GL_TRIANGLE_STRIP, healthVerts, 8, 4, proj, healthColor);
 
     // === 2. WEAPON AMMO BARS (3 types) ===
     float ammoStartX = margin + 230;
@@ -115,9 +88,7 @@ void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused
             ammoStartX - 2, currentY - barH2 - 2,
             ammoStartX + barW + 2, currentY - barH2 - 2
         };
-        glUniform3f(glGetUniformLocation(shaderID, "color"), 0.0f, 0.0f, 0.0f);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(bgVerts), bgVerts);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        queue.drawDynamic(PASS_HUD, shaderID, VAO, GL_TRIANGLE_STRIP, bgVerts, 8, 4, proj, glm::vec3(0.0f, 0.0f, 0.0f));
 
         // Current ammo fill
         float pct = (float)reserve.currentAmmo / reserve.type->getMagSize();
@@ -128,9 +99,7 @@ void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused
             ammoStartX, currentY - barH2,
             ammoStartX + barW * pct, currentY - barH2
         };
-        glUniform3fv(glGetUniformLocation(shaderID, "color"), 1, &col[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(fillVerts), fillVerts);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        queue.drawDynamic(PASS_HUD, shaderID, VAO, GL_TRIANGLE_STRIP, fillVerts, 8, 4, proj, col);
 
         // === SELECTION INDICATOR (black bar on top of current weapon) ===
         if (i == ws.currentWeapon) {
@@ -140,15 +109,12 @@ void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused
                 ammoStartX, currentY + barH2 + 7,
                 ammoStartX + barW, currentY + barH2 + 7
             };
-            glUniform3f(glGetUniformLocation(shaderID, "color"), 0.0f, 0.0f, 0.0f);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(selVerts), selVerts);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            queue.drawDynamic(PASS_HUD, shaderID, VAO, GL_TRIANGLE_STRIP, selVerts, 8, 4, proj, glm::vec3(0.0f, 0.0f, 0.0f));
         }
 
         // === RESERVE MAGS (white blocks) ===
         float blockX = ammoStartX + barW + 10;
         float blockW = 12.0f;
-        glUniform3f(glGetUniformLocation(shaderID, "color"), 1.0f, 1.0f, 1.0f);
         for (int m = 0; m < reserve.reservedMags && m < 8; ++m) {
             float x = blockX + m * (blockW + 4);
             float blockVerts[] = {
@@ -157,18 +123,17 @@ void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused
                 x, currentY - barH2,
                 x + blockW, currentY - barH2
             };
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(blockVerts), blockVerts);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            queue.drawDynamic(PASS_HUD, shaderID, VAO, GL_TRIANGLE_STRIP, blockVerts, 8, 4, proj, glm::vec3(1.0f, 1.0f, 1.0f));
         }
     }
 
     // === 3. SCORE TEXT ===
-    std::string scoreStr = "SCORE: " + std::to_string(score);
+    const char* scoreStr = arena.format("SCORE: %d", score);
     float textX = ammoStartX + barW + 150, textY = barY - barH + 8;
     float charW = 12.0f, charH = 16.0f;
-    glUniform3f(glGetUniformLocation(shaderID, "color"), 1.0f, 1.0f, 1.0f);
 
-    for (char c : scoreStr) {
+    for (const char* p = scoreStr; *p; ++p) {
+        char c = *p;
         if (c == ' ') { textX += charW; continue; }
         float verts[] = {
             textX, textY,
@@ -176,10 +141,7 @@ void TextRenderer::RenderHUD(int health, int score, int /*unused*/, int /*unused
             textX, textY + charH,
             textX + charW, textY + charH
         };
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        queue.drawDynamic(PASS_HUD, shaderID, VAO, GL_TRIANGLE_STRIP, verts, 8, 4, proj, glm::vec3(1.0f, 1.0f, 1.0f));
         textX += charW + 2;
     }
-
-    glEnable(GL_DEPTH_TEST);
 }
@@ -2,12 +2,14 @@
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
+#include "RenderQueue.h"
+#include "FrameArena.h"
 
 // TextRenderer class handles all text rendering in the game
 // Renders HUD, menu text, pause text, start text, and end game text
 class TextRenderer {
 private:
-    unsigned int VAO, VBO;          // Vertex array and buffer for rectangles
+    unsigned int VAO;               // Vertex array for rectangles (vertices streamed by the render queue)
     unsigned int shaderID;          // Shader program for text rendering
     unsigned int charVAO, charVBO;  // Character-specific vertex arrays
     
@@ -18,8 +20,11 @@ public:
     // Destructor cleans up OpenGL resources
     ~TextRenderer();
     
-    // Render in-game HUD with health, score, and ammunition information
-    void RenderHUD(int health, int score, int ammo, int reserved_mags, unsigned int screenW, unsigned int screenH);
+    // Record in-game HUD with health, score, and ammunition information (text is formatted in the frame arena)
+    void RenderHUD(RenderQueue& queue, FrameArena& arena, int health, int score, int ammo, int reserved_mags, unsigned int screenW, unsigned int screenH);
+    
+    // Shader program used for HUD quads (uniforms: proj, color)
+    unsigned int getShader() const { return shaderID; }
     
     // Render arbitrary text string on screen
     void RenderText(const std::string& text, float x, float y, float scale, glm::vec3 color, unsigned int screenW, unsigned int screenH);
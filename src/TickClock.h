@@ -0,0 +1,40 @@
+#pragma once
+#include <chrono>
+#include <thread>
+
+// Fixed-rate deadlines and waiting for them: the server tick loop, the MatchHost shard
+// threads and the client's frame pacer
+namespace TickClock {
+    using Clock = std::chrono::steady_clock;
+
+    // A period in seconds as a clock duration
+    inline Clock::duration fromSeconds(double seconds) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    // Move a deadline on by one step
+    // Keep the cadence, but do not try to catch up after a long stall
+    inline void advance(Clock::time_point& next, Clock::duration step) {
+        next += step;
+        auto now = Clock::now();
+        if (now - next > step) next = now;
+    }
+
+    // True when a step due at `next` starts more than a whole step late
+    inline bool isLate(Clock::time_point next, Clock::time_point now, Clock::duration step) {
+        return now - next > step;
+    }
+
+    // Sleep until t; the last `spin` is yield-spun instead, because OS sleeps overshoot by up
+    // to a scheduler tick. spin = 0 only sleeps: for wake-ups where being late costs nothing.
+    inline void waitUntil(Clock::time_point t, Clock::duration spin = std::chrono::milliseconds(1)) {
+        if (spin <= Clock::duration::zero()) {
+            std::this_thread::sleep_until(t);
+            return;
+        }
+        while (t - Clock::now() > spin)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        while (Clock::now() < t)
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,136 @@
+#include "Timedemo.h"
+#include "Camera.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+// Compute averages, percentiles, 1% lows and the worst spikes
+FrameTimes::Report FrameTimes::report() const {
+    Report r;
+    r.frames = (int)ms.size();
+    if (ms.empty()) return r;
+
+    for (float f : ms) r.totalMs += f;
+    r.avgMs = r.totalMs / r.frames;
+    r.avgFps = 1000.0f * r.frames / r.totalMs;
+
+    std::vector<float> sorted = ms;
+    std::sort(sorted.begin(), sorted.end());
+    // Nearest-rank percentile
+    auto percentile = [&](float p) {
+        int rank = (int)(p * r.frames + 0.999f);
+        return sorted[std::max(0, std::min(rank, r.frames) - 1)];
+    };
+    r.p50Ms = percentile(0.50f);
+    r.p95Ms = percentile(0.95f);
+    r.p99Ms = percentile(0.99f);
+
+    int lowCount = std::max(1, r.frames / 100);
+    float lowMs = 0.0f;
+    for (int i = r.frames - lowCount; i < r.frames; ++i) lowMs += sorted[i];
+    r.low1Fps = 1000.0f * lowCount / lowMs;
+
+    std::vector<std::pair<int, float>> indexed;
+    indexed.reserve(r.frames);
+    for (int i = 0; i < r.frames; ++i) indexed.push_back({ i, ms[i] });
+    int worstCount = std::min(WORST_FRAMES, r.frames);
+    std::partial_sort(indexed.begin(), indexed.begin() + worstCount, indexed.end(),
+                      [](const std::pair<int, float>& a, const std::pair<int, float>& b) { return a.second > b.second; });
+    r.worst.assign(indexed.begin(), indexed.begin() + worstCount);
+    return r;
+}
+
+// Print the report to stdout
+void FrameTimes::print(const Report& r, const std::string& title) {
+    std::cout << "=== " << title << " ===\n";
+    std::cout << "Frames: " << r.frames << " in " << r.totalMs / 1000.0f << " s, avg " << r.avgFps
+              << " fps (" << r.avgMs << " ms)\n";
+    std::cout << "Frame time p50 " << r.p50Ms << " ms, p95 " << r.p95Ms << " ms, p99 " << r.p99Ms
+              << " ms, 1% low " << r.low1Fps << " fps\n";
+    std::cout << "Worst frames:";
+    for (const auto& w : r.worst) std::cout << " #" << w.first << " " << w.second << " ms";
+    std::cout << "\n";
+}
+
+// Write the report as JSON
+bool FrameTimes::writeJson(const Report& r, const std::string& path, const std::string& mode, const std::string& renderer) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "ERROR::TIMEDEMO::CANNOT_WRITE " << path << "\n";
+        return false;
+    }
+
+    // Renderer strings are plain ASCII, but quotes and backslashes still need escaping
+    std::string escaped;
+    for (char c : renderer) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+
+    out << "{\n"
+        << "  \"mode\": \"" << mode << "\",\n"
+        << "  \"renderer\": \"" << escaped << "\",\n"
+        << "  \"frames\": " << r.frames << ",\n"
+        << "  \"total_ms\": " << r.totalMs << ",\n"
+        << "  \"avg_fps\": " << r.avgFps << ",\n"
+        << "  \"avg_ms\": " << r.avgMs << ",\n"
+        << "  \"p50_ms\": " << r.p50Ms << ",\n"
+        << "  \"p95_ms\": " << r.p95Ms << ",\n"
+        << "  \"p99_ms\": " << r.p99Ms << ",\n"
+        << "  \"low1_fps\": " << r.low1Fps << ",\n"
+        << "  \"worst\": [";
+    for (size_t i = 0; i < r.worst.size(); ++i)
+        out << (i ? ", " : "") << "{\"frame\": " << r.worst[i].first << ", \"ms\": " << r.worst[i].second << "}";
+    out << "]\n}\n";
+    return true;
+}
+
+// Constructor: the path circles the default enemy layout inside the 40x40 arena
+Timedemo::Timedemo(int frameCount) : frames(std::max(frameCount, 1)) {
+    const glm::vec3 enemies(3.0f, 1.5f, -7.0f);   // Middle of the spawn line
+    keys = {
+        { glm::vec3(  0.0f, 2.0f,   8.0f), enemies,                      false },
+        { glm::vec3( 12.0f, 2.0f,   4.0f), enemies,                      true  },
+        { glm::vec3( 15.0f, 2.0f,  -9.0f), glm::vec3(-3.0f, 1.5f, -1.0f), true  },
+        { glm::vec3(  4.0f, 2.0f, -17.0f), glm::vec3( 0.0f, 2.0f,  10.0f), false },
+        { glm::vec3(-12.0f, 2.0f, -12.0f), enemies,                      true  },
+        { glm::vec3(-14.0f, 2.0f,   2.0f), glm::vec3(15.0f, 2.0f, -5.0f), false },
+    };
+}
+
+// Path parameter of a frame
+void Timedemo::segmentAt(int frame, int& segment, float& t) const {
+    float u = (float)(frame % frames) / frames * keys.size();
+    segment = (int)u;
+    t = u - segment;
+}
+
+// Uniform Catmull-Rom segment between p1 and p2
+glm::vec3 Timedemo::catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t) {
+    float t2 = t * t, t3 = t2 * t;
+    return 0.5f * ((2.0f * p1) + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+// Move and turn the camera to where the script has it at this frame
+void Timedemo::placeCamera(Camera& camera, int frame) const {
+    int s;
+    float t;
+    segmentAt(frame, s, t);
+    int n = (int)keys.size();
+    const Key& k0 = keys[(s + n - 1) % n];
+    const Key& k1 = keys[s];
+    const Key& k2 = keys[(s + 1) % n];
+    const Key& k3 = keys[(s + 2) % n];
+
+    camera.position = catmullRom(k0.position, k1.position, k2.position, k3.position, t);
+    camera.lookAt(catmullRom(k0.target, k1.target, k2.target, k3.target, t));
+}
+
+// Whether the script fires on this frame
+bool Timedemo::firesOn(int frame) const {
+    int s;
+    float t;
+    segmentAt(frame, s, t);
+    return keys[s].fire && frame % FIRE_PERIOD == 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+class Camera;
+
+// FrameTimes collects per-frame times of a benchmark run and summarizes them
+class FrameTimes {
+public:
+    // Summary of a run
+    struct Report {
+        int frames = 0;
+        float totalMs = 0.0f;
+        float avgMs = 0.0f;
+        float avgFps = 0.0f;
+        float p50Ms = 0.0f, p95Ms = 0.0f, p99Ms = 0.0f;
+        float low1Fps = 0.0f;        // Average fps over the slowest 1% of frames
+        std::vector<std::pair<int, float>> worst;  // Slowest frames (index, ms), slowest first
+    };
+
+    static const int WORST_FRAMES = 5;
+
+    void reserve(int frames) { ms.reserve(frames); }
+    void add(float frameMs) { ms.push_back(frameMs); }
+    int count() const { return (int)ms.size(); }
+
+    // Compute averages, percentiles, 1% lows and the worst spikes
+    Report report() const;
+
+    // Print the report to stdout
+    static void print(const Report& r, const std::string& title);
+
+    // Write the report as JSON for regression comparison; returns false if the file can't be written
+    static bool writeJson(const Report& r, const std::string& path, const std::string& mode, const std::string& renderer);
+
+private:
+    std::vector<float> ms;
+};
+
+// Timedemo drives the camera along a scripted closed spline and fires on a fixed schedule,
+// so every run simulates and renders exactly the same frames.
+// Each step advances a fixed STEP seconds regardless of how long the frame took
+class Timedemo {
+public:
+    static constexpr float STEP = 1.0f / 60.0f;   // Simulated seconds per frame
+    static const int FIRE_PERIOD = 12;            // Frames between shots on firing segments
+    static const unsigned int SEED = 1234;        // rand() seed for enemy patrols
+
+    // One control point of the path
+    struct Key {
+        glm::vec3 position;          // Camera position
+        glm::vec3 target;            // Point the camera looks at
+        bool fire;                   // Fire while travelling from this key to the next
+    };
+
+    // frames = length of the run; the path is traversed once over it
+    explicit Timedemo(int frames = 1000);
+
+    // Move and turn the camera to where the script has it at this frame
+    void placeCamera(Camera& camera, int frame) const;
+
+    // Whether the script fires on this frame
+    bool firesOn(int frame) const;
+
+    int getFrames() const { return frames; }
+
+private:
+    int frames;
+    std::vector<Key> keys;
+
+    // Path parameter of a frame: segment index and position within it
+    void segmentAt(int frame, int& segment, float& t) const;
+
+    // Uniform Catmull-Rom segment between p1 and p2
+    static glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t);
+};
@@ -1,51 +1,53 @@
 #include "World.h"
-#include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
+#include "AllocTracker.h"
 #include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <thread>
 
-// Static timer for debug output to avoid spam
-static auto lastDebugTime = std::chrono::steady_clock::now();
+// Destructor: stop chunk workers before the chunk map is destroyed
+World::~World() {
+    streamer.stop();
+}
 
 // Generate the initial game world with all geometry
 void World::generate() {
-    // Define world boundaries
-    float W = 40.0f;   // World width and depth
-    float H = 40.0f;   // World height
-
-    // Create floor at ground level
-    // Large flat surface for player to walk on
-    cubes.push_back({glm::vec3(0, 0, 0), glm::vec3(W, 1, H), glm::vec3(0.7f, 0.7f, 0.9f), false, 0});
-    
-    // Create ceiling at top of world
-    // Prevents player from flying away
-    cubes.push_back({glm::vec3(0, 10, 0), glm::vec3(W, 1, H), glm::vec3(0.6f, 0.9f, 1.0f), false, 0});
-
-    // Create boundary walls around the world
-    // Left wall (negative X)
-    cubes.push_back({glm::vec3(-W/2, 5, 0), glm::vec3(1, 10, H), glm::vec3(0.8f), false, 0});
-    
-    // Right wall (positive X)
-    cubes.push_back({glm::vec3(W/2, 5, 0), glm::vec3(1, 10, H), glm::vec3(0.8f), false, 0});
-    
-    // Back wall (negative Z)
-    cubes.push_back({glm::vec3(0, 5, -H/2), glm::vec3(W, 10, 1), glm::vec3(0.6f, 0.6f, 1.0f), false, 0});
-    
-    // Front wall (positive Z)
-    cubes.push_back({glm::vec3(0, 5, H/2), glm::vec3(W, 10, 1), glm::vec3(0.6f, 0.6f, 1.0f), false, 0});
-
-    // Create collectible items spread across the world
-    // Each item has unique ID and color for identification
-    // Red item - top left
+    // Spawn collectible items
+    spawnItems();
+
+    // Restart chunk streaming for the current layout
+    // Without streaming every chunk is built here and no worker stays around
+    if (streaming) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        int workers = hw > 2 ? std::min<int>(hw - 1, 4) : 1;
+        streamer.start(layout, workers);
+    } else {
+        streamer.stop();
+    }
+    chunks.clear();
+    requested.clear();
+
+    // Load everything around the spawn point before the first frame
+    requestAround(glm::vec3(0.0f));
+    while (!requested.empty()) {
+        collectChunks();
+        if (!requested.empty()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Create collectible items spread across the world
+// Each item has unique ID and color for identification
+void World::spawnItems() {
+    // Red item - top left corner
     cubes.push_back({glm::vec3(-10, 1.5, -10), glm::vec3(0.8f), glm::vec3(1, 0.3, 0.3), true, 1});
-    
-    // Green item - top right
+
+    // Green item - top right corner
     cubes.push_back({glm::vec3(10, 1.5, -10), glm::vec3(0.8f), glm::vec3(0.3, 1, 0.3), true, 2});
-    
-    // Blue item - bottom right
+
+    // Blue item - bottom right corner
     cubes.push_back({glm::vec3(10, 1.5, 10), glm::vec3(0.8f), glm::vec3(0.3, 0.3, 1), true, 3});
-    
-    // Yellow item - bottom left
+
+    // Yellow item - bottom left corner
     cubes.push_back({glm::vec3(-10, 1.5, 10), glm::vec3(0.8f), glm::vec3(1, 1, 0.3), true, 4});
 }
 
@@ -61,51 +63,104 @@ void World::regenerateItems() {
             ++it;
         }
     }
-    
+
     // Respawn all items at their fixed starting locations
-    // Red item - top left corner
-    cubes.push_back({glm::vec3(-10, 1.5, -10), glm::vec3(0.8f), glm::vec3(1, 0.3, 0.3), true, 1});
-    
-    // Green item - top right corner
-    cubes.push_back({glm::vec3(10, 1.5, -10), glm::vec3(0.8f), glm::vec3(0.3, 1, 0.3), true, 2});
-    
-    // Blue item - bottom right corner
-    cubes.push_back({glm::vec3(10, 1.5, 10), glm::vec3(0.8f), glm::vec3(0.3, 0.3, 1), true, 3});
-    
-    // Yellow item - bottom left corner
-    cubes.push_back({glm::vec3(-10, 1.5, 10), glm::vec3(0.8f), glm::vec3(1, 1, 0.3), true, 4});
-    
+    spawnItems();
+
     std::cout << "Items regenerated\n";
 }
 
-// Render all cubes in the world using the provided vertex array
-void World::render(unsigned int VAO, const glm::mat4& VP, unsigned int shaderID) const {
-    // Bind the cube vertex array for rendering
-    glBindVertexArray(VAO);
-    
-    // Print debug info every 2 seconds to avoid console spam
-    auto now = std::chrono::steady_clock::now();
-    if (std::chrono::duration<float>(now - lastDebugTime).count() > 2.0f) {
-        std::cout << "[DEBUG] Rendering " << cubes.size() << " world objects\n";
-        lastDebugTime = now;
+// Page chunks in and out around the camera
+void World::update(const glm::vec3& cameraPos) {
+    AllocScope allocTag(AllocTag::WORLD);
+    collectChunks();
+    requestAround(cameraPos);
+
+    // Evict chunks beyond view distance (one chunk of slack avoids thrashing at borders)
+    int pcx = chunkCoord(cameraPos.x);
+    int pcz = chunkCoord(cameraPos.z);
+    for (auto it = chunks.begin(); it != chunks.end();) {
+        const Chunk& c = *it->second;
+        int dist = std::max(std::abs(c.cx - pcx), std::abs(c.cz - pcz));
+        if (dist > viewDistance + 1) {
+            it = chunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Move finished chunks into the chunk map
+void World::collectChunks() {
+    streamer.collect(collected);
+    for (auto& c : collected) {
+        long long key = chunkKey(c->cx, c->cz);
+        requested.erase(key);
+        chunks[key] = std::move(c);
+    }
+    collected.clear();
+}
+
+// Queue missing chunks within view distance, nearest first
+void World::requestAround(const glm::vec3& pos) {
+    int pcx = chunkCoord(pos.x);
+    int pcz = chunkCoord(pos.z);
+
+    // Chunk range that contains any part of the world (walls stick out by half a unit)
+    int minChunk = chunkCoord(-layout.halfSize - 0.5f);
+    int maxChunk = chunkCoord(layout.halfSize + 0.5f);
+
+    for (int ring = 0; ring <= viewDistance; ++ring) {
+        for (int dz = -ring; dz <= ring; ++dz) {
+            for (int dx = -ring; dx <= ring; ++dx) {
+                if (std::max(std::abs(dx), std::abs(dz)) != ring) continue;
+
+                int cx = pcx + dx, cz = pcz + dz;
+                if (cx < minChunk || cx > maxChunk || cz < minChunk || cz > maxChunk) continue;
+
+                long long key = chunkKey(cx, cz);
+                if (chunks.count(key) || requested.count(key)) continue;
+
+                if (!streaming) {
+                    std::unique_ptr<Chunk> chunk(new Chunk());
+                    generateChunk(layout, cx, cz, *chunk);
+                    chunks[key] = std::move(chunk);
+                    continue;
+                }
+                requested.insert(key);
+                streamer.request(cx, cz);
+            }
+        }
     }
-    
-    // Render each cube in the world
-    for (const auto& c : cubes) {
-        // Create model matrix for this cube
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, c.pos);      // Move to position
-        model = glm::scale(model, c.size);         // Scale to size
-        
-        // Calculate final MVP matrix
-        glm::mat4 mvp = VP * model;
-
-        // Pass matrix and color to shader
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "uMVP"), 1, GL_FALSE, &mvp[0][0]);
-        glUniform3fv(glGetUniformLocation(shaderID, "uColor"), 1, &c.color[0]);
-
-        // Draw the cube as 36 triangle vertices
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+}
+
+// Push the player out of any static cube it overlaps on the XZ plane
+// Cubes entirely below the feet (floor) or above the head (ceiling) are ignored
+void World::resolveCollision(glm::vec3& pos, float radius, float height) const {
+    float feet = pos.y - height;
+    float head = pos.y;
+    int pcx = chunkCoord(pos.x);
+    int pcz = chunkCoord(pos.z);
+
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            auto it = chunks.find(chunkKey(pcx + dx, pcz + dz));
+            if (it == chunks.end()) continue;
+
+            for (const AABB& box : it->second->colliders) {
+                if (box.max.y <= feet + 0.01f || box.min.y >= head) continue;
+
+                float overlapX = std::min(pos.x + radius - box.min.x, box.max.x - (pos.x - radius));
+                float overlapZ = std::min(pos.z + radius - box.min.z, box.max.z - (pos.z - radius));
+                if (overlapX <= 0.0f || overlapZ <= 0.0f) continue;
+
+                // Resolve along the axis of least penetration
+                if (overlapX < overlapZ) {
+                    pos.x += (pos.x < (box.min.x + box.max.x) * 0.5f) ? -overlapX : overlapX;
+                } else {
+                    pos.z += (pos.z < (box.min.z + box.max.z) * 0.5f) ? -overlapZ : overlapZ;
+                }
+            }
+        }
     }
-    glBindVertexArray(0);
-}
\ No newline at end of file
+}
@@ -1,38 +1,63 @@
 #pragma once
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
-
-// Cube structure represents a single 3D cube in the world
-// Used for both static geometry (walls, floor) and collectible items
-struct Cube {
-    glm::vec3 pos;        // Position in world space
-    glm::vec3 size;       // Width, height, depth dimensions
-    glm::vec3 color;      // RGB color for rendering
-    bool isItem;          // True if collectible item, false if wall/static
-    int id;               // Unique identifier for items
-};
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include "Chunk.h"
+#include "Occlusion.h"
+#include "RenderQueue.h"
 
 // World class manages all static geometry in the game
-// Handles generation and rendering of environment
+// Static geometry is split into chunks streamed in around the camera;
+// collectible items live in the cubes list
 class World {
 public:
-    std::vector<Cube> cubes;  // All cubes in the world
-    
-    // Generate initial world layout with walls, floor, ceiling, and items
+    std::vector<Cube> cubes;  // Collectible items in the world
+    WorldLayout layout;       // Size and generation parameters of the world
+    int viewDistance = 3;     // Chunks kept loaded around the camera (in chunks)
+    bool streaming = true;    // False: build chunks inline, no worker threads (dedicated server)
+    std::unordered_map<long long, std::unique_ptr<Chunk>> chunks;  // Loaded chunks
+
+    ~World();
+
+    // Generate initial world layout: spawn items and load chunks around the origin
     void generate();
-    
+
     // Clear items and respawn them at starting positions
     void regenerateItems();
-    
-    // Render all cubes using the provided VAO and shader
-    void render(unsigned int VAO, const glm::mat4& VP, unsigned int shaderID) const;
-    
+
+    // Request chunks around the camera, collect finished ones and evict far ones
+    void update(const glm::vec3& cameraPos);
+
+    // Push a player box (radius, height below eye) out of static geometry
+    void resolveCollision(glm::vec3& pos, float radius, float height) const;
+
+    // How far from the origin the player may move on X and Z
+    float boundsLimit() const { return layout.boundsLimit(); }
+
+    // Record draw packets (model matrix + color) for all cubes using the provided VAO and shader
+    // Items hidden behind occluders are skipped when a culler is given
+    void render(RenderQueue& queue, unsigned int VAO, unsigned int shaderID, OcclusionCuller* culler = nullptr) const;
+
     // Clear and regenerate the world
     void reset() {
         cubes.clear();
         generate();
     }
-};
\ No newline at end of file
+
+private:
+    ChunkStreamer streamer;                 // Background chunk generation
+    std::unordered_set<long long> requested;  // Chunks queued but not yet loaded
+    std::vector<std::unique_ptr<Chunk>> collected;  // Reused hand-off list for collectChunks
+
+    // Add the four collectible items at their fixed positions
+    void spawnItems();
+
+    // Move finished chunks from the streamer into the chunk map
+    void collectChunks();
+
+    // Queue every missing chunk within view distance of pos
+    void requestAround(const glm::vec3& pos);
+};
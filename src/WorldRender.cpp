@@ -0,0 +1,45 @@
+#include "World.h"
+#include "AllocTracker.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <chrono>
+
+// Drawing only: the simulation in World.cpp is shared with the dedicated server, which has no GL
+
+// Static timer for debug output to avoid spam
+static auto lastDebugTime = std::chrono::steady_clock::now();
+
+// Record all loaded chunks and items using the provided vertex array
+void World::render(RenderQueue& queue, unsigned int VAO, unsigned int shaderID, OcclusionCuller* culler) const {
+    AllocScope allocTag(AllocTag::WORLD);
+    // Print debug info every 2 seconds to avoid console spam
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - lastDebugTime).count() > 2.0f) {
+        std::cout << "[DEBUG] Rendering " << chunks.size() << " chunks, " << cubes.size() << " items\n";
+        lastDebugTime = now;
+    }
+
+    // Render static geometry with the model matrices built by the chunk workers
+    // (the view-projection is applied in the shader from the per-frame uniform block)
+    for (const auto& entry : chunks) {
+        const Chunk& chunk = *entry.second;
+        for (size_t i = 0; i < chunk.cubes.size(); ++i) {
+            queue.drawMesh(PASS_OPAQUE, shaderID, VAO, GL_TRIANGLES, 36, true, chunk.models[i], chunk.cubes[i].color, chunk.cubes[i].pos);
+        }
+    }
+
+    // Render each item in the world
+    for (const auto& c : cubes) {
+        // Skip items hidden behind walls
+        if (culler && !culler->isVisible({c.pos - c.size * 0.5f, c.pos + c.size * 0.5f})) continue;
+
+        // Create model matrix for this cube
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, c.pos);      // Move to position
+        model = glm::scale(model, c.size);         // Scale to size
+
+        // Draw the cube as 36 triangle vertices
+        queue.drawMesh(PASS_OPAQUE, shaderID, VAO, GL_TRIANGLES, 36, true, model, c.color, c.pos);
+    }
+}
@@ -3,6 +3,12 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 #include "Camera.h"
 #include "World.h"
@@ -14,6 +20,24 @@
 #include "tracer.h"
 #include "Bullet.h"
 #include "WeaponSystem.h"
+#include "Occlusion.h"
+#include "RenderQueue.h"
+#include "FramePipeline.h"
+#include "ProgramCache.h"
+#include "FramePacer.h"
+#include "InputQueue.h"
+#include "DynamicResolution.h"
+#include "HeadlessContext.h"
+#include "Timedemo.h"
+#include "FrameInput.h"
+#include "Demo.h"
+#include "GameSnapshot.h"
+#include "StateHash.h"
+#include "FrameArena.h"
+#include "AllocTracker.h"
+#include "Net/NetClient.h"
+#include "Net/ClientPrediction.h"
+#include "Net/SpectatorClient.h"
 
 int playerHealth = 100;
 int score = 0;
@@ -22,6 +46,7 @@ int reserveMags = 0;
 int partialMagAmmo = 0;
 TracerManager tracerManager;
 WeaponSystem ws;
+ProgramCache programCache;
 
 void reload(int mag_size,int &reserved_mags,int &partial_ammos,int &current_ammos){
     int needed = mag_size - current_ammos;
@@ -42,9 +67,21 @@ void reload(int mag_size,int &reserved_mags,int &partial_ammos,int &current_ammo
     }
 }
 
+// Screen changes requested by a simulation step, applied on the main thread
+struct FrameResult {
+    bool paused = false;
+    bool gameOver = false;
+    bool demoEnded = false;
+    bool quicksaved = false;         // quickState was written and should go to disk
+};
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
-void processInput(GLFWwindow* window);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+FrameInput gatherInput(GLFWwindow* window, float deltaTime);
+void applyInput(Camera& camera, const FrameInput& in);
+PlayerCommand makeCommand(const Camera& camera, const FrameInput& in);
+void applyServerState(const NetPlayerState& s);
 unsigned int createCubeVAO();
 
 int SCR_WIDTH = 1200;
@@ -52,51 +89,137 @@ int SCR_HEIGHT = 800;
 
 GameScreen currentGameScreen = GameScreen::START_MENU;
 bool pauseKeyPressed = false;
+bool enterpressed = false;
 
-// Helper function to reset game state
-void resetGameState(EnemyManager& enemies, World& world) {
-    playerHealth = 100;
-    score = 0;
-    currentAmmo = 30;
-    reserveMags = 0;
-    partialMagAmmo = 0;
-    tracerManager = TracerManager();
-    ws = WeaponSystem();
-    
-    // Clear and respawn enemies
-    enemies.clear();
-    for(int i=0;i<7;i++)
-        enemies.spawn(glm::vec3(-3+i*2,1.5,-1-i*2), glm::vec3(1-i/10,0.1 + i/10,i/10));
-    
-    world.regenerateItems();
-    
-    // Reset and regenerate world boxes
-    world.reset();
+// Timestamped gameplay mouse events from the GLFW callbacks, drained once per frame
+InputQueue inputEvents;
+
+// Demo recording (--record) and playback (--play); ticks are recorded / replayed on the sim thread
+DemoRecorder demoRecorder;
+DemoPlayer demoPlayer;
+
+// Game state right after setup; restarts restore it instead of rebuilding everything
+std::vector<unsigned char> pristineState;
+
+// Helper function to reset game state: an in-place restore of the pristine snapshot
+void resetGameState(Camera& camera, EnemyManager& enemies, World& world) {
+    auto start = std::chrono::steady_clock::now();
+    GameSnapshot::restore(pristineState, camera, enemies, world);
+
+    // A restart is not explained by recorded input: the next tick gets a keyframe
+    demoRecorder.requestKeyframe();
     
     std::cout << "=== GAME STATE RESET ===\n";
-    std::cout << "Enemies spawned: " << enemies.getEnemyCount() << "\n";
-    std::cout << "World cubes: " << world.cubes.size() << "\n";
+    std::cout << "Enemies spawned: " << enemies.getEnemyCount() << ", world items: " << world.cubes.size()
+              << " (restored in " << std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count()
+              << " us)\n";
 }
 
-int main() {
+int main(int argc, char** argv) {
+    auto startupStart = std::chrono::steady_clock::now();
+
+    // Optional world size in units (default arena is 40x40), frame pacing mode and GPU frame budget
+    float worldSize = 40.0f;
+    FramePacer pacer;
+    float frameBudgetMs = 15.0f;
+    // Headless: render gameplay offscreen for a fixed number of frames, then print timings
+    // Timedemo: the same, but along a scripted camera path, with a JSON report
+    bool headless = false;
+    bool timedemoMode = false;
+    std::string timedemoJson = "timedemo.json";
+    int benchmarkFrames = 1000;
+    // Demo recording / playback; playback can start at a given tick
+    std::string recordPath, playPath;
+    int seekTick = 0;
+    // Allocation tracking builds: abort on any allocation in a zero-alloc region
+    bool allocAssert = false;
+    // Multiplayer: address of a dedicated server to join
+    std::string connectAddress;
+    std::string spectateAddress;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--world-size" && i + 1 < argc) worldSize = std::stof(argv[++i]);
+        else if (arg == "--pacing" && i + 1 < argc) {
+            if (!pacer.parse(argv[++i]))
+                std::cerr << "Unknown pacing mode " << argv[i] << " (vsync, uncapped, limit:<fps>, lowlatency[:<fps>])\n";
+        }
+        else if (arg == "--frame-budget" && i + 1 < argc) frameBudgetMs = std::stof(argv[++i]);
+        else if (arg == "--headless") headless = true;
+        else if (arg == "--frames" && i + 1 < argc) benchmarkFrames = std::stoi(argv[++i]);
+        else if (arg == "--timedemo") timedemoMode = true;
+        else if (arg == "--timedemo-json" && i + 1 < argc) timedemoJson = argv[++i];
+        else if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--play" && i + 1 < argc) playPath = argv[++i];
+        else if (arg == "--seek" && i + 1 < argc) seekTick = std::stoi(argv[++i]);
+        else if (arg == "--alloc-assert") allocAssert = true;
+        else if (arg == "--connect" && i + 1 < argc) connectAddress = argv[++i];
+        else if (arg == "--spectate" && i + 1 < argc) spectateAddress = argv[++i];
+    }
+    if (allocAssert && !AllocTracker::ENABLED)
+        std::cerr << "--alloc-assert needs a build with -DSHOOTER_TRACK_ALLOCS; ignored\n";
+    AllocTracker::setAssertZeroAlloc(allocAssert);
+
+    // Join the server before anything is built: the world comes from its layout
+    NetClient netClient;
+    WorldLayout serverLayout;
+    bool online = false;
+    if (!connectAddress.empty()) {
+        NetAddress address;
+        if (!address.parse(connectAddress, Protocol::DEFAULT_PORT))
+            std::cerr << "Bad server address " << connectAddress << " (expected a.b.c.d[:port])\n";
+        else if (Net::startup())
+            online = netClient.connect(address, 5.0f, serverLayout);
+        if (!online) std::cerr << "Playing offline\n";
+    }
+
+    // Or watch a match through a spectator relay: a free camera, everything else from the broadcast
+    SpectatorClient spectator;
+    bool spectating = false;
+    if (!online && !spectateAddress.empty()) {
+        NetAddress address;
+        if (!address.parse(spectateAddress, Protocol::DEFAULT_RELAY_PORT))
+            std::cerr << "Bad relay address " << spectateAddress << " (expected a.b.c.d[:port])\n";
+        else if (Net::startup())
+            spectating = spectator.connect(address, 5.0f, serverLayout);
+        if (!spectating) std::cerr << "Playing offline\n";
+    }
+
+    // Headless runs use GLFW's null platform (timer, input state) with a window that has no
+    // context; rendering goes through an EGL context and an offscreen framebuffer instead
+    if (headless) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (headless) glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OOP Project", nullptr, nullptr);
     if (!window) { std::cerr << "Failed GLFW\n"; glfwTerminate(); return -1; }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Failed GLAD\n"; return -1;
+    HeadlessContext headlessContext;
+    if (headless) {
+        if (!headlessContext.create(SCR_WIDTH, SCR_HEIGHT)) { glfwTerminate(); return -1; }
+    } else {
+        glfwMakeContextCurrent(window);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+            std::cerr << "Failed GLAD\n"; return -1;
+        }
     }
 
+    // All programs below are created through the cache (binaries stored in shader_cache/)
+    programCache.init("shader_cache");
+
     glEnable(GL_DEPTH_TEST);
-    glfwSwapInterval(1);
+    if (timedemoMode) pacer.parse("uncapped");   // Timedemos render as fast as possible
+    if (!headless) pacer.apply();   // No swap chain to pace when headless
     glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetMouseButtonCallback(window, guiClickCallback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+
+    // Unaccelerated mouse motion while the cursor is captured in gameplay
+    if (glfwRawMouseMotionSupported())
+        glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
 
     Camera camera(glm::vec3(0.0f, 2.0f, 5.0f));
     glfwSetWindowUserPointer(window, &camera);
@@ -122,23 +245,319 @@ int main() {
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 
+    initLineRenderer();
+
+    // HUD renderer is created once; its shader and VAO are reused every frame
+    TextRenderer hudRenderer(SCR_WIDTH, SCR_HEIGHT);
+
+    initializeGUI(SCR_WIDTH, SCR_HEIGHT);
+
+    // Every program has been issued; wait for the compiles and store new binaries
+    programCache.finish();
+
     World world;
+    if (online || spectating) {
+        world.layout = serverLayout;
+    } else {
+        world.layout.halfSize = worldSize / 2;
+        if (worldSize > 40.0f) world.layout.pillarDensity = 1.0f;  // Large worlds get obstacles
+    }
     world.generate();
+    camera.boundsLimit = world.boundsLimit();
 
     EnemyManager enemies;
-    for(int i=0;i<7;i++)
+    enemies.worldLimit = world.layout.halfSize;
+    for(int i=0;i<7 && !online && !spectating;i++)   // Online, enemies come from the server
         enemies.spawn(glm::vec3(-3+i*2,1.5,-1-i*2), glm::vec3(1-i/10,0.1 + i/10,i/10));
 
+    // Everything a restart returns to
+    GameSnapshot::capture(pristineState, camera, enemies, world);
+
     glm::mat4 projection = glm::perspective(glm::radians(60.0f), 
                                             (float)SCR_WIDTH/SCR_HEIGHT, 0.1f, 100.0f);
 
-    bool canShoot = true;
-    bool enterpressed = false;
-    bool lclick = false;
+    OcclusionCuller occlusion;
 
-    initializeGUI(SCR_WIDTH, SCR_HEIGHT);
+    // Scratch memory for one simulation step (sim thread only), reset at the top of each step
+    FrameArena frameArena;
+
+    // Scripted camera path and fire schedule (--timedemo), one pass over the run
+    Timedemo timedemo(benchmarkFrames);
+
+    // Offscreen 3D target scaled to hold the GPU frame budget
+    DynamicResolution dynres;
+    dynres.setBudget(frameBudgetMs);
+    if (headless) dynres.setOutput(headlessContext.getFramebuffer());
+    if (timedemoMode) dynres.setAdaptive(false);   // Timedemos compare frame times at a fixed resolution
+
+    // Frame pipeline: two render queues, each with the programs and their uniform names registered
+    FramePipeline pipeline;
+    for (int i = 0; i < 2; ++i) {
+        RenderQueue& queue = pipeline.getQueue(i);
+        queue.registerProgram(shader3D.ID, nullptr, nullptr);  // FrameData / ObjectBlock uniform blocks
+        queue.registerProgram(hudRenderer.getShader(), "proj", "color");
+        queue.registerProgram(shaderCrosshair.ID, nullptr, nullptr);
+    }
+
+    // One gameplay step: update the simulation and record its draw list
+    // Runs on the pipeline worker while the main thread submits the previous list
+    FrameResult simResult;
+    bool playingDemo = false;
+
+    // Every demo tick carries a digest of the state; playback checks it against the replayed state
+    StateHash stateHash;
+    DesyncCheck desyncCheck;
+
+    // Demo keyframes are game snapshots (wrapped once here, not on every tick)
+    Demo::CaptureFn captureState = [&](Demo::State& s) { GameSnapshot::capture(s, camera, enemies, world); };
+    Demo::RestoreFn restoreState = [&](const Demo::State& s) {
+        if (desyncCheck.isPending()) {
+            stateHash.update(camera, enemies, world);
+            desyncCheck.atKeyframe(demoPlayer.getTick(), s, stateHash);
+        }
+        GameSnapshot::restore(s, camera, enemies, world);
+    };
+
+    // Quicksave slot (F5 / F9), kept across sessions in quicksave.snap
+    std::vector<unsigned char> quickState;
+    if (GameSnapshot::load(quickState, "quicksave.snap")) std::cout << "Quicksave loaded\n";
+
+    // Online play: commands go out at the server's tick rate; clicks wait for the next command
+    float netClock = 0.0f;
+    int netShots = 0;
+
+    // Online, the camera is moved by its own commands right away and corrected by snapshots
+    ClientPrediction prediction;
+    prediction.reset(camera);
+
+    auto simulateFrame = [&](RenderQueue& renderQueue, const FrameInput& live) {
+        frameArena.reset();
+
+        // Demos: playback replaces the live input, recording stores it (with keyframes) before use
+        FrameInput in = live;
+        if (playingDemo) {
+            StateDigest recorded;
+            if (!demoPlayer.next(in, recorded, restoreState)) {
+                simResult.demoEnded = true;
+                in = FrameInput();
+            } else {
+                stateHash.update(camera, enemies, world);
+                desyncCheck.check(demoPlayer.getTick() - 1, recorded, stateHash);
+            }
+            in.width = live.width;
+            in.height = live.height;
+            in.time = live.time;
+        } else if (demoRecorder.isRecording()) {
+            stateHash.update(camera, enemies, world);
+            demoRecorder.record(in, stateHash.getDigest(), captureState);
+        }
+        float deltaTime = in.deltaTime;
+
+        if (in.demoFrame >= 0) {
+            // Timedemo: the script owns the camera and the trigger
+            timedemo.placeCamera(camera, in.demoFrame);
+            if (timedemo.firesOn(in.demoFrame)) Shooter::fire(camera, world, enemies);
+        } else if (online) {
+            // Online: the view turns locally; the server moves the player and resolves every shot
+            netShots += in.clickCount + (in.enter && !enterpressed ? 1 : 0);
+            if (in.mouseDX != 0.0f || in.mouseDY != 0.0f) camera.processMouse(in.mouseDX, in.mouseDY);
+            netClock = std::min(netClock + deltaTime, 0.25f);
+            while (netClock >= Protocol::TICK_STEP) {
+                PlayerCommand cmd = makeCommand(camera, in);
+                cmd.viewTick = netClient.getViewTick();
+                if (netShots > 0) {
+                    // Local tracer right away; hits and score arrive with the next snapshot
+                    cmd.buttons |= CMD_FIRE;
+                    netShots--;
+                    ShotHit hit = Shooter::trace(camera.position, camera.front, world, enemies);
+                    float dist = std::min(std::min(hit.itemDist, hit.enemyDist), 50.0f);
+                    tracerManager.add(camera.position, camera.position + camera.front * dist);
+                }
+                cmd.seq = netClient.sendCommand(cmd);
+                prediction.predict(cmd, world);
+                netClock -= Protocol::TICK_STEP;
+            }
+
+            if (netClient.poll()) {
+                prediction.reconcile(netClient.getAckSeq(), netClient.getSelf(), world);
+                applyServerState(netClient.getSelf());
+                netClient.applyEnemies(enemies);
+                netClient.applyItems(world);
+            }
+            prediction.update(deltaTime);
+            camera.position = prediction.getRenderPosition(netClock / Protocol::TICK_STEP);
+            if (netClient.hasTimedOut() || !netClient.isConnected()) {
+                std::cout << "Connection to server lost\n";
+                netClient.disconnect();
+                online = false;
+                simResult.gameOver = true;
+            }
+        } else if (spectating) {
+            // Spectating: fly around the arena; the players, enemies and items are the relay's
+            if (in.mouseDX != 0.0f || in.mouseDY != 0.0f) camera.processMouse(in.mouseDX, in.mouseDY);
+            applyInput(camera, in);
+            camera.physics(deltaTime);
+            world.resolveCollision(camera.position, 0.4f, 1.5f);
+            if (spectator.poll()) {
+                spectator.applyEnemies(enemies);
+                spectator.applyItems(world);
+            }
+            if (spectator.hasTimedOut() || !spectator.isConnected()) {
+                std::cout << "Connection to relay lost\n";
+                spectator.disconnect();
+                spectating = false;
+                simResult.gameOver = true;
+            }
+        } else {
+            // Every buffered click fires once, along the view direction at the moment of the click
+            for (int i = 0; i < in.clickCount; ++i) {
+                glm::vec3 dir = camera.frontAfter(in.clicks[i].mouseDX, in.clicks[i].mouseDY);
+                Shooter::fire(camera.position, dir, world, enemies);
+            }
+
+            // Mouse motion is applied once per step, not per event
+            if (in.mouseDX != 0.0f || in.mouseDY != 0.0f) camera.processMouse(in.mouseDX, in.mouseDY);
+            applyInput(camera, in);
+            camera.physics(deltaTime);
+            world.resolveCollision(camera.position, 0.4f, 1.5f);
+        }
+        world.update(camera.position);
+
+        // Quicksave / quickload: in-place snapshot of the whole game
+        if (in.quicksave) {
+            auto start = std::chrono::steady_clock::now();
+            GameSnapshot::capture(quickState, camera, enemies, world);
+            simResult.quicksaved = true;
+            std::cout << "Quicksave: " << quickState.size() << " bytes in "
+                      << std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() << " us\n";
+        }
+        if (in.quickload && !quickState.empty()) {
+            auto start = std::chrono::steady_clock::now();
+            if (GameSnapshot::restore(quickState, camera, enemies, world)) {
+                demoRecorder.requestKeyframe();
+                std::cout << "Quickload: " << std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() << " us\n";
+            }
+        }
+
+        if (in.enter && !enterpressed) {
+            if (!online && !spectating) Shooter::fire(camera, world, enemies);
+            enterpressed = true;
+        }
+        if (!in.enter){
+            enterpressed = false;
+        }
+
+        // PAUSE LOGIC - P KEY
+        if (in.pause) {
+            if (!pauseKeyPressed) {
+                simResult.paused = true;
+                pauseKeyPressed = true;
+            }
+        } else {
+            pauseKeyPressed = false;
+        }
+
+        // Enemy AI and melee (offline; online and spectating the enemies come from the network)
+        if (!online && !spectating) {
+            enemies.update(deltaTime, camera.position);
+            enemies.attackPlayer(camera.position, playerHealth, deltaTime);
+        }
+
+        // 3D RENDERING (recorded into the render queue, executed on the main thread)
+        // Camera matrices go into the per-frame uniform block; packets only carry model matrices
+        // Recording the world and enemies must not touch the heap (checked with --alloc-assert);
+        // remote players and the HUD come after the scope, their packet count can grow mid-game
+        glm::mat4 view = camera.getViewMatrix();
+        glm::mat4 VP = projection * view;
+        {
+            ZeroAllocScope noAlloc;
+            renderQueue.beginFrame(camera.position, 100.0f);
+            renderQueue.setFrameConstants(view, projection, in.time);
+            tracerManager.update(deltaTime);
+            tracerManager.render(renderQueue, shader3D.ID);
+            occlusion.beginFrame(VP, camera.position);
+            occlusion.addOccluders(world, frameArena);
+            world.render(renderQueue, cubeVAO, shader3D.ID, &occlusion);
+            enemies.render(renderQueue, cubeVAO, shader3D.ID, &occlusion);
+        }
+
+        // Other players, as boxes below their eye point
+        for (const NetRemotePlayer& r : spectating ? spectator.getPlayers() : netClient.getRemotes()) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), r.position - glm::vec3(0.0f, 0.9f, 0.0f));
+            model = glm::rotate(model, glm::radians(-r.yaw), glm::vec3(0.0f, 1.0f, 0.0f));
+            model = glm::scale(model, glm::vec3(0.8f, 1.8f, 0.8f));
+            renderQueue.drawMesh(PASS_OPAQUE, shader3D.ID, cubeVAO, GL_TRIANGLES, 36, true, model,
+                                 glm::vec3(0.2f, 0.4f, 1.0f), r.position);
+        }
+
+        hudRenderer.RenderHUD(renderQueue, frameArena, playerHealth, score, currentAmmo, reserveMags, in.width, in.height);
+
+        // CROSSHAIR (2D OVERLAY)
+        renderQueue.drawMesh(PASS_OVERLAY, shaderCrosshair.ID, crosshairVAO, GL_LINES, 4, false,
+                             glm::mat4(1.0f), glm::vec3(1.0f), camera.position);
+
+        // Check game over
+        if (playerHealth <= 0) simResult.gameOver = true;
+    };
+    pipeline.setJob(simulateFrame);
+
+    std::cout << "[DEBUG] Startup: "
+              << std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startupStart).count()
+              << " ms (shaders " << programCache.getStats().ms << " ms)\n";
+
+    float submitMs = 0.0f;
+    auto lastPipelineDebug = std::chrono::steady_clock::now();
+
+    // Input time of the frame being simulated on the worker (pipelined modes)
+    auto inFlightInputTime = std::chrono::steady_clock::now();
+
+    // Benchmark runs (headless / timedemo) go straight into gameplay and time every frame;
+    // headless frames are timed up to glFinish, windowed ones up to the end of the swap
+    bool benchmark = headless || timedemoMode;
+    FrameTimes benchmarkTimes;
+    int demoFrame = 0;
+    auto lastFrameEnd = std::chrono::steady_clock::now();
+    if (benchmark) {
+        currentGameScreen = GameScreen::GAMEPLAY;
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        if (timedemoMode) srand(Timedemo::SEED);   // Same enemy patrols every run
+        resetGameState(camera, enemies, world);
+        benchmarkTimes.reserve(benchmarkFrames);
+    }
+
+    if (!recordPath.empty() && !playPath.empty())
+        std::cerr << "--record and --play cannot be combined; recording is off\n";
+    else if (!recordPath.empty())
+        demoRecorder.start(recordPath);
+    if (!playPath.empty() && demoPlayer.open(playPath)) {
+        // Playback also goes straight into gameplay; pauses in the demo are skipped
+        playingDemo = true;
+        currentGameScreen = GameScreen::GAMEPLAY;
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        resetGameState(camera, enemies, world);
+
+        // Seek: restore the nearest keyframe, then re-simulate (without drawing) up to the tick
+        if (seekTick > 0) {
+            auto seekStart = std::chrono::steady_clock::now();
+            int from = demoPlayer.seek(seekTick);
+            for (int t = from; t < seekTick && !simResult.demoEnded; ++t) {
+                pipeline.kick(FrameInput());
+                pipeline.wait();
+            }
+            simResult = FrameResult();
+            std::cout << "Seeked to tick " << demoPlayer.getTick() << " from keyframe " << from << " in "
+                      << std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - seekStart).count()
+                      << " ms\n";
+        }
+    }
 
     while (!glfwWindowShouldClose(window)) {
+        // Wait for the pacer, then sample input as late as possible before simulating
+        pacer.waitForFrameStart();
+        glfwPollEvents();
+        auto inputTime = std::chrono::steady_clock::now();
+        auto presentedInputTime = inputTime;
+
         static float lastFrame = 0.0;
         float currentFrame = static_cast<float>(glfwGetTime());
         float deltaTime    = currentFrame - lastFrame;
@@ -153,7 +572,7 @@ int main() {
                 // PLAY button clicked
                 currentGameScreen = GameScreen::GAMEPLAY;
                 glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-                resetGameState(enemies, world);
+                resetGameState(camera, enemies, world);
             }
             if (clicked == 1) {
                 // EXIT button clicked
@@ -161,72 +580,86 @@ int main() {
             }
         }
         else if (currentGameScreen == GameScreen::GAMEPLAY) {
-            processInput(window);
-            camera.physics(deltaTime);
-            
-            if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS && canShoot && !lclick) {
-                Shooter::fire(camera, world, enemies);
-                canShoot = false;
-                lclick = true;
+            FrameInput input = gatherInput(window, deltaTime);
+            if (input.escape) glfwSetWindowShouldClose(window, true);
+            if (timedemoMode) {
+                // Fixed steps so every run simulates the same frames however fast it renders
+                FrameInput scripted;
+                scripted.deltaTime = Timedemo::STEP;
+                scripted.width = input.width;
+                scripted.height = input.height;
+                scripted.time = input.time;
+                scripted.demoFrame = demoFrame++;
+                input = scripted;
             }
-            if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_RELEASE){
-                canShoot = true;
-                lclick = false;
+
+            RenderQueue* ready = nullptr;
+            bool lowLatency = pacer.getMode() == PacingMode::LOW_LATENCY;
+            if (lowLatency) {
+                // Simulate this frame's input right away and present it this frame (no pipelining)
+                pipeline.kick(input);
+                ready = pipeline.wait();
+            } else {
+                // Nothing in flight when gameplay (re)starts: record the current state first
+                if (!pipeline.isBusy()) {
+                    FrameInput idle;
+                    idle.width = input.width;
+                    idle.height = input.height;
+                    idle.time = input.time;
+                    pipeline.kick(idle);
+                    inFlightInputTime = inputTime;
+                }
+
+                // Draw list of frame N, simulated while frame N-1 was being submitted
+                ready = pipeline.wait();
+                presentedInputTime = inFlightInputTime;
             }
 
-            if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS && canShoot && !enterpressed) {
-                Shooter::fire(camera, world, enemies);
-                canShoot = false;
-                enterpressed = true;
+            if (simResult.quicksaved && !playingDemo) GameSnapshot::save(quickState, "quicksave.snap");
+            if (simResult.demoEnded) {
+                std::cout << "Demo finished\n";
+                glfwSetWindowShouldClose(window, true);
+            }
+            if (simResult.paused && !playingDemo) {
+                currentGameScreen = GameScreen::PAUSE_MENU;
+                glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+                std::cout << "Game Paused\n";
             }
-            if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_RELEASE){
-                canShoot = true;
-                enterpressed = false;
+            if (simResult.gameOver && (benchmark || playingDemo)) {
+                // Nobody to click through the end screen: keep the run going
+                resetGameState(camera, enemies, world);
+            } else if (simResult.gameOver) {
+                currentGameScreen = GameScreen::END_SCREEN;
+                glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+                setEndScreenResult(false, score);
             }
+            simResult = FrameResult();
 
-            // PAUSE LOGIC - P KEY
-            if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
-                if (!pauseKeyPressed) {
-                    currentGameScreen = GameScreen::PAUSE_MENU;
-                    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-                    pauseKeyPressed = true;
-                    std::cout << "Game Paused\n";
-                }
-            } else {
-                pauseKeyPressed = false;
+            // Simulate and record frame N+1 on the worker while frame N is submitted below
+            if (!lowLatency && currentGameScreen == GameScreen::GAMEPLAY) {
+                pipeline.kick(input);
+                inFlightInputTime = inputTime;
             }
 
+            auto submitStart = std::chrono::steady_clock::now();
+            // 3D passes at the dynamic scale, then HUD and crosshair at native resolution
+            dynres.begin3D(SCR_WIDTH, SCR_HEIGHT);
             glClearColor(0.5f, 0.8f, 1.0f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-            // 3D RENDERING
-            shader3D.use();
-            glm::mat4 view = camera.getViewMatrix();
-            glm::mat4 proj = projection;
-            glm::mat4 VP = projection * view;
-            tracerManager.update(deltaTime);
-            tracerManager.render(shader3D.ID, proj, view);
-            world.render(cubeVAO, VP, shader3D.ID);
-            enemies.render(cubeVAO, VP, shader3D.ID);
-            enemies.update(deltaTime, camera.position);
-            enemies.attackPlayer(camera.position, playerHealth, deltaTime);
-            
-            TextRenderer hudRenderer(SCR_WIDTH, SCR_HEIGHT);
-            hudRenderer.RenderHUD(playerHealth, score, currentAmmo, reserveMags, SCR_WIDTH, SCR_HEIGHT);
-            
-            // CROSSHAIR (2D OVERLAY)
-            glDisable(GL_DEPTH_TEST);
-            shaderCrosshair.use();
-            glBindVertexArray(crosshairVAO);
-            glDrawArrays(GL_LINES, 0, 4);
-            glBindVertexArray(0);
-            glEnable(GL_DEPTH_TEST);
-
-            // Check game over
-            if (playerHealth <= 0) {
-                currentGameScreen = GameScreen::END_SCREEN;
-                glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-                setEndScreenResult(false, score);
+            ready->prepare();
+            ready->executePasses(PASS_OPAQUE, PASS_LINES);
+            dynres.end3D();
+            ready->executePasses(PASS_HUD, PASS_OVERLAY);
+            ready->finish();
+            dynres.endFrame();
+            submitMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - submitStart).count();
+
+            // Debug output every 2 seconds
+            auto now = std::chrono::steady_clock::now();
+            if (std::chrono::duration<float>(now - lastPipelineDebug).count() > 2.0f) {
+                std::cout << "[DEBUG] Frame: sim " << pipeline.getLastJobMs() << " ms, submit " << submitMs
+                          << " ms, frame " << deltaTime * 1000.0f << " ms\n";
+                lastPipelineDebug = now;
             }
         }
         else if (currentGameScreen == GameScreen::PAUSE_MENU) {
@@ -244,7 +677,7 @@ int main() {
                 // RESTART button clicked
                 currentGameScreen = GameScreen::GAMEPLAY;
                 glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-                resetGameState(enemies, world);
+                resetGameState(camera, enemies, world);
                 std::cout << "Game Restarted from Pause Menu\n";
             }
             else if (clicked == 2) {
@@ -274,7 +707,7 @@ int main() {
                 // RESTART button clicked
                 currentGameScreen = GameScreen::GAMEPLAY;
                 glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-                resetGameState(enemies, world);
+                resetGameState(camera, enemies, world);
                 std::cout << "Game Restarted from End Screen\n";
             }
             else if (clicked == 2) {
@@ -283,11 +716,41 @@ int main() {
             }
         }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        if (headless) {
+            glFinish();
+        } else {
+            pacer.beginPresent();
+            glfwSwapBuffers(window);
+            pacer.framePresented(presentedInputTime);
+        }
+
+        if (benchmark) {
+            auto frameEnd = std::chrono::steady_clock::now();
+            benchmarkTimes.add(std::chrono::duration<float, std::milli>(frameEnd - lastFrameEnd).count());
+            lastFrameEnd = frameEnd;
+            if (benchmarkTimes.count() >= benchmarkFrames) glfwSetWindowShouldClose(window, true);
+        }
+        AllocTracker::endFrame();
+    }
+    AllocTracker::report();
+
+    if (benchmark && benchmarkTimes.count() > 0) {
+        FrameTimes::Report report = benchmarkTimes.report();
+        FrameTimes::print(report, timedemoMode ? "TIMEDEMO" : "HEADLESS BENCHMARK");
+        if (timedemoMode && FrameTimes::writeJson(report, timedemoJson, headless ? "headless" : "window",
+                                                  (const char*)glGetString(GL_RENDERER)))
+            std::cout << "Timedemo report written to " << timedemoJson << "\n";
     }
 
     // Cleanup
+    pipeline.wait();
+    demoRecorder.stop();
+    if (playingDemo) desyncCheck.report(stateHash);
+    if (!connectAddress.empty() || !spectateAddress.empty()) {
+        netClient.disconnect();
+        spectator.disconnect();
+        Net::cleanup();
+    }
     cleanupGUI();
     glDeleteVertexArrays(1, &cubeVAO);
     glDeleteVertexArrays(1, &crosshairVAO);
@@ -319,35 +782,103 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     lastY = ypos;
 
     if (currentGameScreen == GameScreen::GAMEPLAY) {
-        Camera* camera = static_cast<Camera*>(glfwGetWindowUserPointer(window));
-        camera->processMouse(xoffset, yoffset);
+        // Buffered; the next simulation step applies the summed motion once
+        inputEvents.push({ InputEventType::MOUSE_MOVE, 0, xoffset, yoffset, glfwGetTime() });
     } else {
         guiMouseCallback(window, xpos, ypos);
     }
 }
 
-void processInput(GLFWwindow* window) {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    if (currentGameScreen == GameScreen::GAMEPLAY) {
+        // Buffered so a press and release within one frame still fires
+        InputEventType type = action == GLFW_PRESS ? InputEventType::BUTTON_PRESS : InputEventType::BUTTON_RELEASE;
+        inputEvents.push({ type, button, 0.0f, 0.0f, glfwGetTime() });
+    }
+    guiClickCallback(window, button, action, mods);
+}
 
-    Camera* camera = static_cast<Camera*>(glfwGetWindowUserPointer(window));
-    static float lastFrame = 0.0f;
-    float currentFrame = (float)glfwGetTime();
-    float deltaTime = currentFrame - lastFrame;
-    lastFrame = currentFrame;
+// Sample keyboard, mouse buttons and accumulated mouse motion for one simulation step
+FrameInput gatherInput(GLFWwindow* window, float deltaTime) {
+    FrameInput in;
+    in.deltaTime = deltaTime;
+    in.time = (float)glfwGetTime();
+
+    // Coalesce motion; each click remembers how much motion preceded it
+    InputEvent e;
+    while (inputEvents.pop(e)) {
+        if (e.type == InputEventType::MOUSE_MOVE) {
+            in.mouseDX += e.dx;
+            in.mouseDY += e.dy;
+        } else if (e.type == InputEventType::BUTTON_PRESS && e.button == GLFW_MOUSE_BUTTON_LEFT &&
+                   in.clickCount < FrameInput::MAX_CLICKS) {
+            in.clicks[in.clickCount++] = { in.mouseDX, in.mouseDY };
+        }
+    }
 
-    if(glfwGetKey(window,GLFW_KEY_SPACE)==GLFW_PRESS) camera->jump();
-    
-    if(glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) ws.switchWeapon(2);
-    if(glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) ws.switchWeapon(1);
-    if(glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) ws.switchWeapon(0);
-    if(glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) 
-        ws.reloadCurrent();
-    
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_UP) == GLFW_PRESS) camera->processKeyboard(0, deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_DOWN) == GLFW_PRESS) camera->processKeyboard(1, deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_LEFT) == GLFW_PRESS) camera->processKeyboard(2, deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_RIGHT) == GLFW_PRESS) camera->processKeyboard(3, deltaTime);
+    in.escape = glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS;
+    in.jump = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    in.reload = glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
+    in.pause = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+    in.enter = glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS;
+
+    // Quicksave / quickload fire once per key press
+    static bool f5Down = false, f9Down = false;
+    bool f5 = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
+    bool f9 = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+    in.quicksave = f5 && !f5Down;
+    in.quickload = f9 && !f9Down;
+    f5Down = f5;
+    f9Down = f9;
+
+    if(glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) in.weaponSlot = 2;
+    if(glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) in.weaponSlot = 1;
+    if(glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) in.weaponSlot = 0;
+
+    in.forward = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_UP) == GLFW_PRESS;
+    in.back = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_DOWN) == GLFW_PRESS;
+    in.left = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_LEFT) == GLFW_PRESS;
+    in.right = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window,GLFW_KEY_RIGHT) == GLFW_PRESS;
+
+    in.width = SCR_WIDTH;
+    in.height = SCR_HEIGHT;
+    return in;
+}
+
+// Apply sampled keys to the camera and weapon system
+void applyInput(Camera& camera, const FrameInput& in) {
+    if (in.jump) camera.jump();
+
+    if (in.weaponSlot >= 0) ws.switchWeapon(in.weaponSlot);
+    if (in.reload) ws.reloadCurrent();
+
+    if (in.forward) camera.processKeyboard(0, in.deltaTime);
+    if (in.back) camera.processKeyboard(1, in.deltaTime);
+    if (in.left) camera.processKeyboard(2, in.deltaTime);
+    if (in.right) camera.processKeyboard(3, in.deltaTime);
+}
+
+// One server command from the sampled keys and the current view
+PlayerCommand makeCommand(const Camera& camera, const FrameInput& in) {
+    PlayerCommand cmd;
+    cmd.buttons = (in.forward ? CMD_FORWARD : 0) | (in.back ? CMD_BACK : 0) | (in.left ? CMD_LEFT : 0) |
+                  (in.right ? CMD_RIGHT : 0) | (in.jump ? CMD_JUMP : 0) | (in.reload ? CMD_RELOAD : 0);
+    cmd.weaponSlot = (int8_t)in.weaponSlot;
+    cmd.yaw = camera.yaw;
+    cmd.pitch = camera.pitch;
+    return cmd;
+}
+
+// The server owns health, score and ammo while online (position goes through ClientPrediction)
+void applyServerState(const NetPlayerState& s) {
+    playerHealth = s.health;
+    score = s.score;
+    ws.switchWeapon(s.currentWeapon);
+    for (int w = 0; w < 3; ++w) {
+        ws.weapons[w].currentAmmo = s.ammo[w];
+        ws.weapons[w].reservedMags = s.mags[w];
+        ws.weapons[w].partialAmmo = s.partial[w];
+    }
 }
 
 unsigned int createCubeVAO() {
@@ -2,6 +2,7 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <vector>
+#include "RenderQueue.h"
 
 struct Tracer {
     glm::vec3 start;
@@ -19,6 +20,9 @@ public:
     // Update all tracers (reduce lifetime)
     void update(float deltaTime);
     
-    // Render all active tracers with projection and view matrices
-    void render(unsigned int shaderID, const glm::mat4& projection, const glm::mat4& view) const;
-};
\ No newline at end of file
+    // Record all active tracers (world-space lines; camera data comes from the frame uniform block)
+    void render(RenderQueue& queue, unsigned int shaderID) const;
+};
+
+// Create the shared line VAO/VBO used by tracers (call once after GL init)
+void initLineRenderer();
\ No newline at end of file